@@ -4,22 +4,19 @@ import os
 
 ASSETS_FOLDER = "assets"
 HEADER_FILE = "assets.h"
+SOURCE_FILE = "assets.cpp"
+BYTES_PER_LINE = 16
 
 
-def escape(s: str) -> str:
-    ret = ""
-    for i in range(len(s) // 2):
-        ret += "\\x"
-        base = i * 2
-        ret += s[base]
-        ret += s[base + 1]
-        if i % 100 == 0:
-            ret += '"\n"'
-    return ret
+def to_bytes(data: bytes) -> str:
+    lines = []
+    for i in range(0, len(data), BYTES_PER_LINE):
+        lines.append("    " + ",".join(str(b) for b in data[i : i + BYTES_PER_LINE]))
+    return ",\n".join(lines)
 
 
 assets_proc = []
-assets = os.listdir(ASSETS_FOLDER)
+assets = sorted(os.listdir(ASSETS_FOLDER))
 for asset in assets:
     name = "_".join(asset.split(".")).strip().replace("-", "_").upper()
     f = open(f"{ASSETS_FOLDER}/{asset}", "rb")
@@ -28,18 +25,26 @@ for asset in assets:
 
     assets_proc.append((name, data))
 
-output = ""
+# The data is only defined in SOURCE_FILE so it is compiled once, the header
+# keeps the sizes so that sizeof() still works.
+header = "#pragma once" + os.linesep
+source = f'#include "./{HEADER_FILE}"' + os.linesep
 for asset_proc in assets_proc:
     (
         name,
-        str,
+        data,
     ) = asset_proc
-    str = str.hex()
 
     print(f"Found {name}")
-    output += f'const unsigned char {name}[] = "{escape(str)}";'
-    output += os.linesep
+    header += f"extern const unsigned char {name}[{len(data)}];"
+    header += os.linesep
+    source += f"const unsigned char {name}[{len(data)}] = {{{os.linesep}{to_bytes(data)}{os.linesep}}};"
+    source += os.linesep
 
 f = open(HEADER_FILE, "w")
-f.write(output)
+f.write(header)
+f.close()
+
+f = open(SOURCE_FILE, "w")
+f.write(source)
 f.close()
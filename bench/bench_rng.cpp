@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "./bench_rng.h"
+#include "../src/coins.h"
+#include "../src/rng_stats.h"
+#include "../testing_h/logger.h"
+
+// Amount of coins or, dice per size, split into trials so small sizes get a
+// long enough sequence for the runs test and, huge sizes run once.
+#define WORK_BUDGET 100000000L
+#define MAX_TRIALS 100000L
+#define DICE_SIDES 6
+#define D20_SIDES 20
+
+// p values below this fail, a fair kernel fails each check with this probability
+#define ALPHA 0.0001
+
+typedef struct bench_result_t {
+    long size;
+    long trials;
+    double seconds;
+    double chi_p;
+    double runs_p;
+} bench_result_t;
+
+static void print_header()
+{
+    printf("| %-16s | %10s | %7s | %10s | %14s | %9s | %9s | %-6s |\n",
+           "Kernel", "Size", "Trials", "Time (s)", "Ops/sec", "Chi2 p", "Runs p", "Result");
+    printf("|------------------|------------|---------|------------|----------------|-----------|-----------|--------|\n");
+}
+
+static void print_p(double p)
+{
+    if (p == RNG_STATS_NOT_APPLICABLE) {
+        printf(" %9s |", "-");
+    } else {
+        printf(" %9.4f |", p);
+    }
+}
+
+static bool passed(bench_result_t r)
+{
+    bool chi_ok = r.chi_p == RNG_STATS_NOT_APPLICABLE || r.chi_p >= ALPHA;
+    bool runs_ok = r.runs_p == RNG_STATS_NOT_APPLICABLE || r.runs_p >= ALPHA;
+    return chi_ok && runs_ok;
+}
+
+static void print_row(const char *kernel, bench_result_t r)
+{
+    double ops = ((double) r.size) * r.trials;
+    printf("| %-16s | %10ld | %7ld | %10.4f | %14.0f |", kernel, r.size, r.trials, r.seconds,
+           r.seconds > 0 ? ops / r.seconds : 0);
+    print_p(r.chi_p);
+    print_p(r.runs_p);
+    printf(" %-6s |\n", passed(r) ? "PASS" : "FAIL");
+    fflush(stdout);
+}
+
+static long trials_for(long size)
+{
+    long trials = WORK_BUDGET / size;
+    if (trials < 1) {
+        trials = 1;
+    } else if (trials > MAX_TRIALS) {
+        trials = MAX_TRIALS;
+    }
+    return trials;
+}
+
+// p is the chance of a single coin being counted
+static bench_result_t bench_coin_kernel(int (*kernel)(int coins), double p, long size)
+{
+    bench_result_t ret;
+    ret.size = size;
+    ret.trials = trials_for(size);
+
+    std::vector<int> results(ret.trials);
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ret.trials; i++) {
+        results[i] = kernel((int) size);
+    }
+    auto end = std::chrono::steady_clock::now();
+    ret.seconds = std::chrono::duration<double>(end - start).count();
+
+    // Distribution of all coins flipped
+    double heads = 0;
+    for (int r : results) {
+        heads += r;
+    }
+
+    double total = ((double) size) * ret.trials;
+    double observed[2] = {heads, total - heads};
+    double expected[2] = {total * p, total * (1 - p)};
+    ret.chi_p = chi_square_p_value(chi_square_stat(observed, expected, 2), 1);
+
+    // Independence of consecutive calls, above/below the expected count
+    double mean = size * p;
+    std::vector<bool> seq;
+    for (int r : results) {
+        if (r != mean) {
+            seq.push_back(r > mean);
+        }
+    }
+
+    bool *seq_arr = new bool[seq.size() + 1];
+    for (size_t i = 0; i < seq.size(); i++) {
+        seq_arr[i] = seq[i];
+    }
+    ret.runs_p = runs_test_p_value(seq_arr, seq.size());
+    delete[] seq_arr;
+
+    return ret;
+}
+
+static bench_result_t bench_dice_kernel(int sides, long size, int *status)
+{
+    bench_result_t ret;
+    ret.size = size;
+    ret.trials = trials_for(size);
+    ret.chi_p = ret.runs_p = RNG_STATS_NOT_APPLICABLE;
+    *status = 1;
+
+    std::vector<double> totals(sides, 0);
+    std::vector<double> means(ret.trials);
+
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < ret.trials; i++) {
+        int s;
+        dice_roll_ret_t roll = roll_dice(sides, (int) size, &s);
+        if (!s) {
+            *status = 0;
+            return ret;
+        }
+
+        double sum = 0;
+        for (int j = 0; j < sides; j++) {
+            totals[j] += roll.results[j].number_rolled;
+            sum += ((double) roll.results[j].side_number) * roll.results[j].number_rolled;
+        }
+        means[i] = sum / size;
+        free_dice_roll_ret(roll);
+    }
+    auto end = std::chrono::steady_clock::now();
+    ret.seconds = std::chrono::duration<double>(end - start).count();
+
+    double total = ((double) size) * ret.trials;
+    std::vector<double> expected(sides, total / sides);
+    ret.chi_p = chi_square_p_value(chi_square_stat(totals.data(), expected.data(), sides), sides - 1);
+
+    double fair_mean = (sides + 1) / 2.0;
+    std::vector<bool> seq;
+    for (double m : means) {
+        if (m != fair_mean) {
+            seq.push_back(m > fair_mean);
+        }
+    }
+
+    bool *seq_arr = new bool[seq.size() + 1];
+    for (size_t i = 0; i < seq.size(); i++) {
+        seq_arr[i] = seq[i];
+    }
+    ret.runs_p = runs_test_p_value(seq_arr, seq.size());
+    delete[] seq_arr;
+
+    return ret;
+}
+
+int bench_rng(int max_exponent)
+{
+    int failures = 0;
+    print_header();
+
+    long size = 1;
+    for (int e = 0; e <= max_exponent; e++, size *= 10) {
+        bench_result_t r = bench_coin_kernel(&flip_coins, 0.5, size);
+        print_row("flip_coins", r);
+        failures += !passed(r);
+
+        // A krark coin is counted when either of its two flips are heads
+        r = bench_coin_kernel(&flip_krark_coins, 0.75, size);
+        print_row("flip_krark_coins", r);
+        failures += !passed(r);
+
+        int s;
+        r = bench_dice_kernel(DICE_SIDES, size, &s);
+        if (!s) {
+            lprintf(LOG_ERROR, "Cannot roll %ld dice\n", size);
+            failures++;
+        } else {
+            print_row("roll_dice d6", r);
+            failures += !passed(r);
+        }
+
+        r = bench_dice_kernel(D20_SIDES, size, &s);
+        if (!s) {
+            lprintf(LOG_ERROR, "Cannot roll %ld dice\n", size);
+            failures++;
+        } else {
+            print_row("roll_dice d20", r);
+            failures += !passed(r);
+        }
+    }
+
+    return failures;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+// Runs the throughput and, distribution checks for every kernel in coins.cpp
+// for sizes 10^0 to 10^max_exponent and prints them as a table.
+// Returns the number of kernel/size pairs that failed a distribution check.
+int bench_rng(int max_exponent);
@@ -0,0 +1,29 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "./bench_rng.h"
+#include "../testing_h/logger.h"
+
+#define DEFAULT_MAX_EXPONENT 9
+#define MAX_EXPONENT 9
+
+int main(int argc, char *argv[])
+{
+    int max_exponent = DEFAULT_MAX_EXPONENT;
+    if (argc == 2) {
+        max_exponent = atoi(argv[1]);
+        if (max_exponent < 0 || max_exponent > MAX_EXPONENT) {
+            lprintf(LOG_ERROR, "Max exponent must be between 0 and %d\n", MAX_EXPONENT);
+            return 1;
+        }
+    } else if (argc > 2) {
+        lprintf(LOG_ERROR, "Usage %s <max size exponent (default %d)>\n", argv[0], DEFAULT_MAX_EXPONENT);
+        return 1;
+    }
+
+    lprintf(LOG_INFO, "Running benchmarks for Squire Desktop %s for %s @ %s\n", VERSION, OS, REPO_URL);
+    printf("Squire Desktop %s (%s) RNG benchmark, sizes 10^0 to 10^%d\n\n", VERSION, OS, max_exponent);
+
+    int failures = bench_rng(max_exponent);
+    lprintf(failures > 0 ? LOG_ERROR : LOG_INFO, "%d kernel/size pairs failed the distribution checks.\n", failures);
+    return failures > 0;
+}
@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <string.h>
 #include <jansson.h>
 #include "./config_reader.h"
 #include "../testing_h/logger.h"
@@ -6,6 +7,7 @@
 int read_config(crash_handler_config_t *conf, FILE *f)
 {
     conf->send_crash_report = DEFAULT_CRASH_REPORT_VALUE;
+    conf->crash_report_endpoint = NULL;
 
     if (f == NULL) {
         return 0;
@@ -18,16 +20,24 @@ int read_config(crash_handler_config_t *conf, FILE *f)
         return 0;
     }
 
+    // json_object_get returns borrowed references, only root is decref'd
     json_t *val = json_object_get(root, CONFIG_REPORT_CRASH);
 
     int status = 0;
     if (val) {
-        if (json_is_integer(val)) {
+        // The app writes this as a bool
+        if (json_is_boolean(val)) {
+            conf->send_crash_report = json_is_true(val);
+            status = 1;
+        } else if (json_is_integer(val)) {
             conf->send_crash_report = json_integer_value(val);
             status = 1;
         }
+    }
 
-        json_decref(val);
+    json_t *endpoint = json_object_get(root, CONFIG_CRASH_REPORT_ENDPOINT);
+    if (endpoint && json_is_string(endpoint) && strlen(json_string_value(endpoint)) > 0) {
+        conf->crash_report_endpoint = strdup(json_string_value(endpoint));
     }
 
     json_decref(root);
@@ -36,5 +46,16 @@ int read_config(crash_handler_config_t *conf, FILE *f)
 
 void free_config(crash_handler_config_t *conf)
 {
+    if (conf->crash_report_endpoint != NULL) {
+        free(conf->crash_report_endpoint);
+        conf->crash_report_endpoint = NULL;
+    }
+}
 
+const char *config_endpoint(crash_handler_config_t *conf)
+{
+    if (conf->crash_report_endpoint != NULL) {
+        return conf->crash_report_endpoint;
+    }
+    return WEBHOOK_URL;
 }
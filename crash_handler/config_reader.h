@@ -5,11 +5,14 @@
 #define WEBHOOK_URL "https://discord.com/api/webhooks/1027978424687538287/RFrXdnRWcAB1Oa4NFyNtebvlZSn7VE2pIOab0NVDBxJqZnFdzjPGZecyLFObljVsg5ul"
 #define CONFIG_FILE "config.json"
 #define CONFIG_REPORT_CRASH "report-crashes"
+#define CONFIG_CRASH_REPORT_ENDPOINT "crash-report-endpoint" // Optional, WEBHOOK_URL if not set
 
 typedef struct crash_handler_config_t {
     int send_crash_report;
+    char *crash_report_endpoint; // NULL if not set
 } crash_handler_config_t;
 
 int read_config(crash_handler_config_t *conf, FILE *f);
 void free_config(crash_handler_config_t *conf);
+const char *config_endpoint(crash_handler_config_t *conf);
 
@@ -1,3 +1,7 @@
+#ifdef LINUX
+#define _GNU_SOURCE // splice and, tee
+#include <fcntl.h>
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #ifdef WINDOWS
@@ -5,20 +9,212 @@
 #include <process.h>
 #else
 #include <unistd.h>
+#include <sys/wait.h>
 #endif
 #include <errno.h>
 #include <string.h>
+#include <time.h>
+#include <curl/curl.h>
 #include "./config_reader.h"
 #include "./webhooks.h"
+#include "./spool.h"
+#include "../src/crash_log_format.h"
 #include "../testing_h/testing.h"
 
 #define NO_START_VAL 180
 #define DEFAULT_EXEC "SquireDesktop"
 #define LOG_FILE "squiredesktop.log"
-#define DISCORD_MESSAGE_LIMIT 2000
+#define RELAY_BLOCK_SIZE (64 * 1024)
+
+static char relay_buffer[RELAY_BLOCK_SIZE];
+
+// Returns the last len bytes of a plain file as a C string, free it after.
+static char *file_tail(FILE *f, size_t len)
+{
+    if (fseek(f, 0, SEEK_END) != 0) {
+        return NULL;
+    }
+
+    long size = ftell(f);
+    if (size < 0) {
+        return NULL;
+    }
+
+    if ((size_t) size < len) {
+        len = size;
+    }
+
+    char *ret = malloc(sizeof * ret * (len + 1));
+    if (ret == NULL) {
+        return NULL;
+    }
+
+    fseek(f, size - len, SEEK_SET);
+    ret[fread(ret, 1, len, f)] = 0;
+    return ret;
+}
+
+// The app keeps its own log in the crash log so that what it logged right up
+// to the crash is there even if it never reached the pipe, the relayed log is
+// only used if the crash log is missing.
+static char *read_crash_report(size_t len)
+{
+    FILE *f = fopen(CRASH_LOG_FILE, "rb");
+    if (f != NULL) {
+        char *ret = crash_log_read_tail(f, len);
+        fclose(f);
+        if (ret != NULL) {
+            return ret;
+        }
+    }
+
+    lprintf(LOG_WARNING, "No crash log found, using %s\n", LOG_FILE);
+    f = fopen(LOG_FILE, "rb");
+    if (f == NULL) {
+        return NULL;
+    }
+
+    char *ret = file_tail(f, len);
+    fclose(f);
+    return ret;
+}
+
+static int write_all(int fd, const char *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t w = write(fd, buf, len);
+        if (w < 0 && errno == EINTR) {
+            continue;
+        } else if (w <= 0) {
+            return 0;
+        }
+
+        buf += w;
+        len -= w;
+    }
+    return 1;
+}
+
+// Reads len bytes unless EOF is hit first, returns the number of bytes read
+static size_t read_all(int fd, char *buf, size_t len)
+{
+    size_t ret = 0;
+    while (ret < len) {
+        ssize_t r = read(fd, buf + ret, len - ret);
+        if (r < 0 && errno == EINTR) {
+            continue;
+        } else if (r <= 0) {
+            break;
+        }
+        ret += r;
+    }
+    return ret;
+}
+
+// Relays the output in RELAY_BLOCK_SIZE blocks to stdout and, the log file.
+static void read_relay(int in, int log_fd)
+{
+    for (;;) {
+        ssize_t n = read(in, relay_buffer, sizeof(relay_buffer));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n <= 0) {
+            break;
+        }
+
+        write_all(STDOUT_FILENO, relay_buffer, n);
+        write_all(log_fd, relay_buffer, n);
+    }
+}
+
+#ifdef LINUX
+// The log file gets its copy of the output through tee and, splice so it never
+// passes through user space, the original is then read once for stdout.
+// Returns 1 at EOF or, 0 if splicing is not supported in
+// which case everything teed so far has been relayed and, read_relay can
+// carry on from there.
+static int splice_relay(int in, int log_fd)
+{
+    int side[2];
+    if (pipe(side) != 0) {
+        return 0;
+    }
+
+    int status = 1;
+    for (;;) {
+        ssize_t n = tee(in, side[1], RELAY_BLOCK_SIZE, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0) {
+            status = 0;
+            break;
+        } else if (n == 0) {
+            break;
+        }
+
+        size_t left = n;
+        while (left > 0) {
+            ssize_t s = splice(side[0], NULL, log_fd, NULL, left, SPLICE_F_MOVE);
+            if (s < 0 && errno == EINTR) {
+                continue;
+            } else if (s <= 0) {
+                // Not supported for this file, drain the copy by hand
+                left = read_all(side[0], relay_buffer, left);
+                write_all(log_fd, relay_buffer, left);
+                status = 0;
+                break;
+            }
+            left -= s;
+        }
 
-static char in_memory_log[DISCORD_MESSAGE_LIMIT];
-static size_t f_ptr, b_ptr;
+        // Consume the original
+        size_t r = read_all(in, relay_buffer, n);
+        write_all(STDOUT_FILENO, relay_buffer, r);
+
+        if (!status) {
+            break;
+        }
+    }
+
+    close(side[0]);
+    close(side[1]);
+    return status;
+}
+#endif
+
+static int load_config(crash_handler_config_t *conf)
+{
+    FILE *f = fopen(CONFIG_FILE, "r");
+    int s = read_config(conf, f);
+    if (f != NULL) {
+        fclose(f);
+    }
+    return s;
+}
+
+// Spools the report then, tries to send it straight away. If that fails it is
+// sent on a later launch.
+static void report_crash(const char *endpoint)
+{
+    lprintf(LOG_INFO, "Sending report...\n");
+
+    char *log_buf_final = read_crash_report(SPOOL_REPORT_SIZE);
+    if (log_buf_final == NULL) {
+        lprintf(LOG_ERROR, "Cannot read the crash log.\n");
+        return;
+    }
+
+    spool_sender_stop();
+    if (spool_add(SPOOL_DIR, log_buf_final, strlen(log_buf_final), time(NULL))) {
+        spool_trim(SPOOL_DIR, SPOOL_MAX_REPORTS, SPOOL_MAX_BYTES);
+    }
+    free(log_buf_final);
+
+    // A new crash is worth a try even while an earlier failure is backing off
+    if (!spool_flush(SPOOL_DIR, endpoint, &send_webhook, time(NULL), 1)) {
+        lprintf(LOG_WARNING, "Cannot send crash report yet, it is saved in " SPOOL_DIR " and, will be sent later\n");
+    }
+}
 
 int main(int argc, char **argv)
 {
@@ -31,6 +227,10 @@ int main(int argc, char **argv)
     }
 
     lprintf(LOG_INFO, "Starting %s\n", exec_file);
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    // A crash log left by an earlier run must not be reported for this one
+    remove(CRASH_LOG_FILE);
 
     int fid[2]; // r, w for stderr
     ASSERT(pipe(fid) == 0);
@@ -56,39 +256,34 @@ int main(int argc, char **argv)
         // Close write end
         close(fid[1]);
 
-        f_ptr = b_ptr = 0;
-
-        FILE *pipe_r = fdopen(fid[0], "rb");
-        ASSERT(pipe_r != NULL);
+        // Reports spooled by earlier runs are sent while the app runs
+        crash_handler_config_t launch_conf;
+        load_config(&launch_conf);
+        size_t spooled = spool_count(SPOOL_DIR);
+        if (launch_conf.send_crash_report && spooled > 0) {
+            lprintf(LOG_INFO, "Sending %lu spooled crash reports\n", (unsigned long) spooled);
+            spool_sender_start(SPOOL_DIR, config_endpoint(&launch_conf), &send_webhook);
+        }
+        free_config(&launch_conf);
 
-        FILE *log_file = fopen(LOG_FILE, "w");
+        FILE *log_file = fopen(LOG_FILE, "wb");
         if (log_file == NULL) {
             lprintf(LOG_ERROR, "Cannot log the application.\n");
             return 1;
         }
 
-        for (int c; c = fgetc(pipe_r), c != EOF;) {
-            fputc(c, stdout);
-            fflush(stdout);
-
-            fputc(c, log_file);
-            fflush(log_file);
-
-            in_memory_log[b_ptr] = c;
-            b_ptr++;
-            b_ptr %= sizeof(in_memory_log);
-
-            // Truncate the log.
-            if (b_ptr == f_ptr) {
-                f_ptr++;
-                f_ptr %= sizeof(in_memory_log);
-            }
+        int log_fd = fileno(log_file);
+#ifdef LINUX
+        if (!splice_relay(fid[0], log_fd)) {
+            read_relay(fid[0], log_fd);
         }
-        close(fid[0]);
+#else
+        read_relay(fid[0], log_fd);
+#endif
 
         // Close pipe and, log
+        close(fid[0]);
         fclose(log_file);
-        fclose(pipe_r);
 
         int r = -1;
         int pid2 = waitpid(pid, &r, 0);
@@ -103,52 +298,23 @@ int main(int argc, char **argv)
         } else if (r != 0 && r != 9) {
             lprintf(LOG_ERROR, "Crash detected in squire desktop\n");
 
+            // Re-read as the settings may have been changed while the app ran
             crash_handler_config_t conf;
-            FILE *f = fopen(CONFIG_FILE, "r");
-            int s = read_config(&conf, f);
-            if (f != NULL) {
-                fclose(f);
-            }
-
+            int s = load_config(&conf);
             if (!s) {
                 lprintf(LOG_WARNING, "No valid configuration found, assuming that crash reports are off\n");
             }
 
-            int report = conf.send_crash_report;
-            free_config(&conf);
-
-            if (report) {
-                lprintf(LOG_INFO, "Sending report...\n");
-
-                char *log_buf_final = calloc(0, sizeof * log_buf_final * (sizeof * in_memory_log + 1));
-                if (log_buf_final == NULL) {
-                    lprintf(LOG_ERROR, "Cannot alloc webhook buffer.\n");
-                    return 1;
-                }
-
-                // Copy from the front to the buffer end.
-                // Case 1 - non-full buffer - b_ptr - f_ptr
-                // .... f ------> b .....
-                // Case 2 - full buffer - sizeof * in_memory_log - f_ptr
-                // ---> b f ------------>
-
-                // j is the log_buf_final index, i is the in_memory_log index.
-                size_t i, j = 0;
-                for (i = f_ptr; i != b_ptr; i++, i %= sizeof * in_memory_log, j++) {
-                    log_buf_final[j] = in_memory_log[i];
-                }
-                log_buf_final[j++] = in_memory_log[b_ptr];
-                log_buf_final[j++] = 0;
-
-                // Send the message log then free.
-                if (!send_webhook(log_buf_final)) {
-                    lprintf(LOG_ERROR, "Cannot send crash report :(, please upload a log to github issues when you can\n)");
-                }
-                free(log_buf_final);
+            if (conf.send_crash_report) {
+                report_crash(config_endpoint(&conf));
             }
+            free_config(&conf);
+            spool_sender_stop();
             return 1;
         }
     }
 
+    spool_sender_stop();
+    curl_global_cleanup();
     return 0;
 }
@@ -0,0 +1,538 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef WINDOWS
+#include <direct.h>
+#include <io.h>
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#include <zlib.h>
+#include "./spool.h"
+#include "../testing_h/logger.h"
+
+#define SPOOL_PATH_LENGTH 4096
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+typedef struct spool_entry_t {
+    char *name;
+    size_t size;
+} spool_entry_t;
+
+static int spool_path(char *buffer, const char *dir, const char *name)
+{
+    int len = snprintf(buffer, SPOOL_PATH_LENGTH, "%s/%s", dir, name);
+    return len > 0 && len < SPOOL_PATH_LENGTH;
+}
+
+static int is_report(const char *name)
+{
+    size_t len = strlen(name), ext_len = strlen(SPOOL_EXTENTION);
+    return len > ext_len && strcmp(name + len - ext_len, SPOOL_EXTENTION) == 0;
+}
+
+static int cmp_entry(const void *a, const void *b)
+{
+    return strcmp(((spool_entry_t *) a)->name, ((spool_entry_t *) b)->name);
+}
+
+static void free_entries(spool_entry_t *entries, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        free(entries[i].name);
+    }
+    free(entries);
+}
+
+// Adds a file to the list if it is a report, returns 0 when out of memory
+static int add_entry(const char *dir, const char *name, spool_entry_t **ret, size_t *n, size_t *cap)
+{
+    if (!is_report(name)) {
+        return 1;
+    }
+
+    char path[SPOOL_PATH_LENGTH];
+    struct stat st;
+    if (!spool_path(path, dir, name) || stat(path, &st) != 0) {
+        return 1;
+    }
+
+    if (*n == *cap) {
+        *cap = *cap == 0 ? 16 : *cap * 2;
+        spool_entry_t *tmp = realloc(*ret, sizeof * tmp * *cap);
+        if (tmp == NULL) {
+            return 0;
+        }
+        *ret = tmp;
+    }
+
+    (*ret)[*n].name = strdup(name);
+    (*ret)[*n].size = st.st_size;
+    if ((*ret)[*n].name != NULL) {
+        (*n)++;
+    }
+    return 1;
+}
+
+// Lists the reports oldest first, free them with free_entries
+static size_t list_reports(const char *dir, spool_entry_t **ret)
+{
+    *ret = NULL;
+    size_t n = 0, cap = 0;
+#ifdef WINDOWS
+    char pattern[SPOOL_PATH_LENGTH];
+    if (!spool_path(pattern, dir, "*" SPOOL_EXTENTION)) {
+        return 0;
+    }
+
+    WIN32_FIND_DATAA ent;
+    HANDLE d = FindFirstFileA(pattern, &ent);
+    if (d == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+
+    do {
+        if (!add_entry(dir, ent.cFileName, ret, &n, &cap)) {
+            break;
+        }
+    } while (FindNextFileA(d, &ent));
+    FindClose(d);
+#else
+    DIR *d = opendir(dir);
+    if (d == NULL) {
+        return 0;
+    }
+
+    struct dirent *ent;
+    while ((ent = readdir(d)) != NULL) {
+        if (!add_entry(dir, ent->d_name, ret, &n, &cap)) {
+            break;
+        }
+    }
+    closedir(d);
+#endif
+
+    if (n > 0) {
+        qsort(*ret, n, sizeof(**ret), &cmp_entry);
+    }
+    return n;
+}
+
+static void remove_report(const char *dir, const char *name)
+{
+    char path[SPOOL_PATH_LENGTH];
+    if (spool_path(path, dir, name)) {
+        remove(path);
+    }
+}
+
+static int make_dir(const char *dir)
+{
+#ifdef WINDOWS
+    return _mkdir(dir);
+#else
+    return mkdir(dir, 0755);
+#endif
+}
+
+int spool_add(const char *dir, const char *report, size_t len, time_t now)
+{
+    if (make_dir(dir) != 0 && errno != EEXIST) {
+        lprintf(LOG_ERROR, "Cannot create crash report spool %s\n", dir);
+        return 0;
+    }
+
+    // Reports from the same second get a suffix
+    char path[SPOOL_PATH_LENGTH];
+    int fd = -1;
+    for (int i = 0; fd < 0 && i < 100; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "report-%012lld-%02d" SPOOL_EXTENTION, (long long) now, i);
+        if (!spool_path(path, dir, name)) {
+            return 0;
+        }
+
+        fd = open(path, O_WRONLY | O_CREAT | O_EXCL | O_BINARY, 0644);
+        if (fd < 0 && errno != EEXIST) {
+            break;
+        }
+    }
+
+    if (fd < 0) {
+        lprintf(LOG_ERROR, "Cannot create a crash report in %s\n", dir);
+        return 0;
+    }
+
+    gzFile gz = gzdopen(fd, "wb9");
+    if (gz == NULL) {
+        close(fd);
+        remove(path);
+        return 0;
+    }
+
+    int ok = len == 0 || gzwrite(gz, report, len) == (int) len;
+    if (gzclose(gz) != Z_OK || !ok) {
+        lprintf(LOG_ERROR, "Cannot write crash report %s\n", path);
+        remove(path);
+        return 0;
+    }
+    return 1;
+}
+
+void spool_trim(const char *dir, size_t max_reports, size_t max_bytes)
+{
+    spool_entry_t *entries;
+    size_t n = list_reports(dir, &entries);
+
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += entries[i].size;
+    }
+
+    for (size_t i = 0; i < n && (n - i > max_reports || total > max_bytes); i++) {
+        lprintf(LOG_WARNING, "Crash report spool is full, removing %s\n", entries[i].name);
+        remove_report(dir, entries[i].name);
+        total -= entries[i].size;
+    }
+    free_entries(entries, n);
+}
+
+size_t spool_count(const char *dir)
+{
+    spool_entry_t *entries;
+    size_t n = list_reports(dir, &entries);
+    free_entries(entries, n);
+    return n;
+}
+
+int spool_read_state(const char *dir, spool_state_t *state)
+{
+    state->failures = 0;
+    state->next_attempt = 0;
+
+    char path[SPOOL_PATH_LENGTH];
+    if (!spool_path(path, dir, SPOOL_STATE_FILE)) {
+        return 0;
+    }
+
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return 0;
+    }
+
+    long long next;
+    int r = fscanf(f, "%d %lld", &state->failures, &next) == 2;
+    fclose(f);
+
+    if (!r || state->failures < 0) {
+        state->failures = 0;
+        return 0;
+    }
+    state->next_attempt = (time_t) next;
+    return 1;
+}
+
+int spool_write_state(const char *dir, spool_state_t state)
+{
+    char path[SPOOL_PATH_LENGTH], tmp_path[SPOOL_PATH_LENGTH];
+    if (!spool_path(path, dir, SPOOL_STATE_FILE) || !spool_path(tmp_path, dir, SPOOL_STATE_FILE ".tmp")) {
+        return 0;
+    }
+
+    FILE *f = fopen(tmp_path, "w");
+    if (f == NULL) {
+        return 0;
+    }
+
+    int ok = fprintf(f, "%d %lld\n", state.failures, (long long) state.next_attempt) > 0;
+    ok = fclose(f) == 0 && ok;
+#ifdef WINDOWS
+    // rename does not replace an existing file here
+    return ok && MoveFileExA(tmp_path, path, MOVEFILE_REPLACE_EXISTING);
+#else
+    return ok && rename(tmp_path, path) == 0;
+#endif
+}
+
+time_t spool_backoff(int failures)
+{
+    time_t ret = SPOOL_BACKOFF_MIN;
+    for (int i = 1; i < failures && ret < SPOOL_BACKOFF_MAX; i++) {
+        ret *= 2;
+    }
+    return ret < SPOOL_BACKOFF_MAX ? ret : SPOOL_BACKOFF_MAX;
+}
+
+// Reads at most SPOOL_REPORT_SIZE bytes of a report
+static int read_report(const char *dir, const char *name, spool_report_t *ret)
+{
+    char path[SPOOL_PATH_LENGTH];
+    if (!spool_path(path, dir, name)) {
+        return 0;
+    }
+
+    gzFile gz = gzopen(path, "rb");
+    if (gz == NULL) {
+        return 0;
+    }
+
+    ret->data = malloc(SPOOL_REPORT_SIZE + 1);
+    ret->name = strdup(name);
+    int len = -1;
+    if (ret->data != NULL && ret->name != NULL) {
+        len = gzread(gz, ret->data, SPOOL_REPORT_SIZE);
+    }
+    gzclose(gz);
+
+    if (len < 0) {
+        free(ret->data);
+        free(ret->name);
+        return 0;
+    }
+
+    ret->data[len] = 0;
+    ret->len = len;
+    return 1;
+}
+
+int spool_flush(const char *dir, const char *endpoint, spool_send_t send, time_t now, int ignore_backoff)
+{
+    spool_state_t state;
+    spool_read_state(dir, &state);
+    if (!ignore_backoff && now < state.next_attempt) {
+        return 0;
+    }
+
+    spool_entry_t *entries;
+    size_t n = list_reports(dir, &entries);
+    if (n == 0 && state.failures == 0) {
+        return 1;
+    }
+
+    int status = 1;
+    for (size_t i = 0; i < n && status; i += SPOOL_BATCH_SIZE) {
+        spool_report_t batch[SPOOL_BATCH_SIZE];
+        size_t count = 0;
+        for (size_t j = i; j < n && j < i + SPOOL_BATCH_SIZE; j++) {
+            if (read_report(dir, entries[j].name, &batch[count])) {
+                count++;
+            } else {
+                lprintf(LOG_WARNING, "Removing unreadable crash report %s\n", entries[j].name);
+                remove_report(dir, entries[j].name);
+            }
+        }
+
+        if (count > 0 && send(endpoint, batch, count)) {
+            for (size_t j = 0; j < count; j++) {
+                remove_report(dir, batch[j].name);
+            }
+            lprintf(LOG_INFO, "Sent %lu crash reports\n", (unsigned long) count);
+        } else if (count > 0) {
+            status = 0;
+        }
+
+        for (size_t j = 0; j < count; j++) {
+            free(batch[j].name);
+            free(batch[j].data);
+        }
+    }
+    free_entries(entries, n);
+
+    if (status) {
+        state.failures = 0;
+        state.next_attempt = 0;
+    } else {
+        state.failures++;
+        state.next_attempt = now + spool_backoff(state.failures);
+        lprintf(LOG_WARNING, "Cannot send crash reports, retrying in %llds\n", (long long) (state.next_attempt - now));
+    }
+
+    spool_write_state(dir, state);
+    return status;
+}
+
+#ifdef WINDOWS
+typedef HANDLE sender_thread_t;
+static CRITICAL_SECTION sender_lock;
+static CONDITION_VARIABLE sender_cond;
+static INIT_ONCE sender_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK init_sender_lock(PINIT_ONCE once, PVOID arg, PVOID *ctx)
+{
+    (void) once;
+    (void) arg;
+    (void) ctx;
+    InitializeCriticalSection(&sender_lock);
+    InitializeConditionVariable(&sender_cond);
+    return TRUE;
+}
+
+static void lock_sender()
+{
+    InitOnceExecuteOnce(&sender_once, &init_sender_lock, NULL, NULL);
+    EnterCriticalSection(&sender_lock);
+}
+
+static void unlock_sender()
+{
+    LeaveCriticalSection(&sender_lock);
+}
+
+static void signal_sender()
+{
+    WakeConditionVariable(&sender_cond);
+}
+
+// Returns 0 once the time is up
+static int wait_sender(time_t until)
+{
+    time_t now = time(NULL);
+    if (now >= until) {
+        return 0;
+    }
+    return SleepConditionVariableCS(&sender_cond, &sender_lock, (DWORD) (until - now) * 1000) != 0;
+}
+#else
+typedef pthread_t sender_thread_t;
+static pthread_mutex_t sender_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sender_cond = PTHREAD_COND_INITIALIZER;
+
+static void lock_sender()
+{
+    pthread_mutex_lock(&sender_lock);
+}
+
+static void unlock_sender()
+{
+    pthread_mutex_unlock(&sender_lock);
+}
+
+static void signal_sender()
+{
+    pthread_cond_signal(&sender_cond);
+}
+
+// Returns 0 once the time is up
+static int wait_sender(time_t until)
+{
+    struct timespec wake = {until, 0};
+    return pthread_cond_timedwait(&sender_cond, &sender_lock, &wake) != ETIMEDOUT;
+}
+#endif
+
+static sender_thread_t sender_thread;
+static int sender_running = 0, sender_stopping = 0;
+static char *sender_dir = NULL, *sender_endpoint = NULL;
+static spool_send_t sender_send = NULL;
+
+static void sender_loop()
+{
+    lock_sender();
+    while (!sender_stopping) {
+        unlock_sender();
+        int empty = spool_flush(sender_dir, sender_endpoint, sender_send, time(NULL), 0);
+
+        spool_state_t state;
+        spool_read_state(sender_dir, &state);
+        lock_sender();
+        if (empty) {
+            break;
+        }
+
+        time_t wake = state.next_attempt;
+        if (wake <= time(NULL)) {
+            wake = time(NULL) + SPOOL_BACKOFF_MIN;
+        }
+
+        while (!sender_stopping && wait_sender(wake));
+    }
+    unlock_sender();
+}
+
+#ifdef WINDOWS
+static DWORD WINAPI sender_main(LPVOID arg)
+{
+    (void) arg;
+    sender_loop();
+    return 0;
+}
+
+static int start_sender_thread()
+{
+    sender_thread = CreateThread(NULL, 0, &sender_main, NULL, 0, NULL);
+    return sender_thread != NULL;
+}
+
+static void join_sender_thread()
+{
+    WaitForSingleObject(sender_thread, INFINITE);
+    CloseHandle(sender_thread);
+}
+#else
+static void *sender_main(void *arg)
+{
+    (void) arg;
+    sender_loop();
+    return NULL;
+}
+
+static int start_sender_thread()
+{
+    return pthread_create(&sender_thread, NULL, &sender_main, NULL) == 0;
+}
+
+static void join_sender_thread()
+{
+    pthread_join(sender_thread, NULL);
+}
+#endif
+
+int spool_sender_start(const char *dir, const char *endpoint, spool_send_t send)
+{
+    if (sender_running) {
+        return 1;
+    }
+
+    sender_dir = strdup(dir);
+    sender_endpoint = strdup(endpoint);
+    sender_send = send;
+    sender_stopping = 0;
+    if (sender_dir == NULL || sender_endpoint == NULL || !start_sender_thread()) {
+        lprintf(LOG_ERROR, "Cannot start the crash report sender\n");
+        free(sender_dir);
+        free(sender_endpoint);
+        sender_dir = sender_endpoint = NULL;
+        return 0;
+    }
+
+    sender_running = 1;
+    return 1;
+}
+
+void spool_sender_stop()
+{
+    if (!sender_running) {
+        return;
+    }
+
+    // A send in progress is bounded by the sender's timeout
+    lock_sender();
+    sender_stopping = 1;
+    signal_sender();
+    unlock_sender();
+    join_sender_thread();
+
+    free(sender_dir);
+    free(sender_endpoint);
+    sender_dir = sender_endpoint = NULL;
+    sender_running = 0;
+}
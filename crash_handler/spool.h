@@ -0,0 +1,60 @@
+#pragma once
+#include <stddef.h>
+#include <time.h>
+
+/*
+ * Crash reports are spooled to SPOOL_DIR as gzipped files so that they are
+ * not lost when there is no network (convention halls), a sender then
+ * delivers them in batches on later launches and, backs off when it fails.
+ * Report names start with a zero padded time so they sort oldest first.
+ * */
+#define SPOOL_DIR "crash_reports"
+#define SPOOL_EXTENTION ".log.gz"
+#define SPOOL_STATE_FILE "state"
+#define SPOOL_MAX_REPORTS 32
+#define SPOOL_MAX_BYTES (2 * 1024 * 1024) // Compressed size of the whole spool
+#define SPOOL_REPORT_SIZE (64 * 1024) // Bytes of log kept in each report
+#define SPOOL_BATCH_SIZE 5
+#define SPOOL_BACKOFF_MIN 30 // Seconds
+#define SPOOL_BACKOFF_MAX (6 * 60 * 60)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct spool_state_t {
+    int failures; // Failed deliveries in a row
+    time_t next_attempt;
+} spool_state_t;
+
+typedef struct spool_report_t {
+    char *name; // File name in the spool
+    char *data;
+    size_t len;
+} spool_report_t;
+
+// Delivers a batch of reports, returns 1 if all of them were delivered
+typedef int (*spool_send_t)(const char *endpoint, spool_report_t *reports, size_t count);
+
+int spool_add(const char *dir, const char *report, size_t len, time_t now);
+// Removes the oldest reports until the spool is within both limits
+void spool_trim(const char *dir, size_t max_reports, size_t max_bytes);
+size_t spool_count(const char *dir);
+
+int spool_read_state(const char *dir, spool_state_t *state);
+int spool_write_state(const char *dir, spool_state_t state);
+time_t spool_backoff(int failures);
+
+// Sends the spool oldest first in batches of SPOOL_BATCH_SIZE, delivered reports
+// are removed. Nothing is sent before the state's next_attempt unless
+// ignore_backoff is set (a new crash). Returns 1 if the spool is empty afterwards.
+int spool_flush(const char *dir, const char *endpoint, spool_send_t send, time_t now, int ignore_backoff);
+
+// Flushes the spool in a thread, retrying with backoff until it is empty or,
+// the sender is stopped.
+int spool_sender_start(const char *dir, const char *endpoint, spool_send_t send);
+void spool_sender_stop();
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,76 @@
+"""
+A local stand-in for the crash report webhook, point the crash handler at it by
+setting "crash-report-endpoint": "http://localhost:8080/" in config.json.
+
+Every batch is acknowledged like Discord would unless --fail-rate says to fail
+it, so the spool and, its backoff can be tested without a network.
+"""
+import argparse
+import random
+import re
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+stats_lock = threading.Lock()
+stats = {"batches": 0, "reports": 0, "bytes": 0, "failed": 0}
+
+
+class CrashReportHandler(BaseHTTPRequestHandler):
+    fail_rate = 0.0
+    delay = 0.0
+
+    def do_POST(self):
+        length = int(self.headers.get("Content-Length", 0))
+        body = self.rfile.read(length)
+        time.sleep(self.delay)
+
+        if random.random() < self.fail_rate:
+            with stats_lock:
+                stats["failed"] += 1
+            self.send_response(503)
+            self.end_headers()
+            return
+
+        reports = len(re.findall(rb'name="files\[\d+\]"', body))
+        with stats_lock:
+            stats["batches"] += 1
+            stats["reports"] += reports
+            stats["bytes"] += length
+            print(
+                f">> batch of {reports} reports ({length} bytes), totals: {stats}",
+                flush=True,
+            )
+
+        self.send_response(204)
+        self.end_headers()
+
+    def log_message(self, format, *args):
+        pass
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument(
+        "--fail-rate", type=float, default=0.0, help="Fraction of batches to fail"
+    )
+    parser.add_argument(
+        "--delay", type=float, default=0.0, help="Seconds to wait before replying"
+    )
+    args = parser.parse_args()
+
+    CrashReportHandler.fail_rate = args.fail_rate
+    CrashReportHandler.delay = args.delay
+
+    server = ThreadingHTTPServer(("localhost", args.port), CrashReportHandler)
+    print(f"Listening on http://localhost:{args.port}/", flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    print(f"Final totals: {stats}")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,6 +1,12 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <jansson.h>
+#include <curl/curl.h>
 #include "./webhooks.h"
+#include "../testing_h/logger.h"
 
-#define WEBHOOK_COLOUR "#ce0cff"
+#define WEBHOOK_COLOUR 0xce0cff
 #define WEBHOOK_TITLE "Squire Desktop Crash Report"
 #define WEBHOOK_SUB_TITLE VERSION " running on " OS
 #ifdef APPLE
@@ -11,12 +17,109 @@
 #define IMG_URL "https://cdn.discordapp.com/app-assets/869668721264853022/1037029304233627709.png"
 #endif
 
-#ifdef LINUX
+#ifndef IMG_URL
 #define IMG_URL "https://cdn.discordapp.com/app-assets/869668721264853022/1037029304334299156.png"
 #endif
 
-int send_webhook(char *log_data)
+static json_t *report_embed(spool_report_t *report)
 {
+    // The end of the log, starting on a UTF-8 character boundary
+    const char *tail = report->data;
+    if (report->len > WEBHOOK_EMBED_LIMIT) {
+        tail += report->len - WEBHOOK_EMBED_LIMIT;
+    }
+    while (((unsigned char) *tail & 0xc0) == 0x80) {
+        tail++;
+    }
 
+    json_t *description = json_string(tail);
+    if (description == NULL) {
+        description = json_string("The log is not valid UTF-8, see the attachment.");
+    }
+
+    json_t *footer = json_object();
+    json_object_set_new(footer, "text", json_string(WEBHOOK_SUB_TITLE));
+
+    json_t *thumbnail = json_object();
+    json_object_set_new(thumbnail, "url", json_string(IMG_URL));
+
+    json_t *embed = json_object();
+    json_object_set_new(embed, "title", json_string(WEBHOOK_TITLE));
+    json_object_set_new(embed, "description", description);
+    json_object_set_new(embed, "color", json_integer(WEBHOOK_COLOUR));
+    json_object_set_new(embed, "footer", footer);
+    json_object_set_new(embed, "thumbnail", thumbnail);
+    return embed;
+}
+
+static char *webhook_payload(spool_report_t *reports, size_t count)
+{
+    json_t *embeds = json_array();
+    for (size_t i = 0; i < count; i++) {
+        json_array_append_new(embeds, report_embed(&reports[i]));
+    }
+
+    json_t *root = json_object();
+    json_object_set_new(root, "embeds", embeds);
+
+    char *ret = json_dumps(root, JSON_COMPACT);
+    json_decref(root);
+    return ret;
+}
+
+int send_webhook(const char *endpoint, spool_report_t *reports, size_t count)
+{
+    char *payload = webhook_payload(reports, count);
+    if (payload == NULL) {
+        lprintf(LOG_ERROR, "Cannot make the webhook payload\n");
+        return 0;
+    }
+
+    CURL *curl = curl_easy_init();
+    if (curl == NULL) {
+        free(payload);
+        return 0;
+    }
+
+    // One request per batch, the logs are attached as files[i]
+    curl_mime *mime = curl_mime_init(curl);
+    curl_mimepart *part = curl_mime_addpart(mime);
+    curl_mime_name(part, "payload_json");
+    curl_mime_data(part, payload, CURL_ZERO_TERMINATED);
+    curl_mime_type(part, "application/json");
+
+    for (size_t i = 0; i < count; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "files[%lu]", (unsigned long) i);
+
+        part = curl_mime_addpart(mime);
+        curl_mime_name(part, name);
+        curl_mime_data(part, reports[i].data, reports[i].len);
+        curl_mime_filename(part, "crash.log");
+        curl_mime_type(part, "text/plain");
+    }
+
+    curl_easy_setopt(curl, CURLOPT_URL, endpoint);
+    curl_easy_setopt(curl, CURLOPT_MIMEPOST, mime);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, (long) WEBHOOK_TIMEOUT);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L); // Sent from the spool's thread
+
+    long code = 0;
+    CURLcode res = curl_easy_perform(curl);
+    if (res == CURLE_OK) {
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+    }
+
+    curl_mime_free(mime);
+    curl_easy_cleanup(curl);
+    free(payload);
+
+    if (res != CURLE_OK) {
+        lprintf(LOG_WARNING, "Cannot reach crash report endpoint: %s\n", curl_easy_strerror(res));
+        return 0;
+    } else if (code < 200 || code >= 300) {
+        lprintf(LOG_WARNING, "Crash report endpoint returned HTTP %ld\n", code);
+        return 0;
+    }
     return 1;
 }
@@ -1,4 +1,11 @@
 #pragma once
+#include <stddef.h>
+#include "./spool.h"
 
-int send_webhook(char *log_data);
+#define WEBHOOK_TIMEOUT 10 // Seconds
+#define WEBHOOK_EMBED_LIMIT 1000 // Discord allows 6000 characters across all embeds
 
+// Posts a batch of reports to endpoint as a Discord webhook, each report is an
+// embed with the end of its log and, the full log as an attachment. Matches
+// spool_send_t.
+int send_webhook(const char *endpoint, spool_report_t *reports, size_t count);
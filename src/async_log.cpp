@@ -0,0 +1,229 @@
+#include "./async_log.h"
+#include "./crash_log.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+// A bounded MPSC queue, each slot's sequence number says whether it is free
+// for the producer at pos (seq == pos) or, ready for the consumer (seq == pos + 1).
+typedef struct log_record_t {
+    std::atomic<size_t> seq;
+    int level;
+    char msg[ASYNC_LOG_RECORD_SIZE];
+} log_record_t;
+
+static log_record_t records[ASYNC_LOG_RECORDS];
+static std::atomic<size_t> enqueue_pos(0);
+static size_t dequeue_pos = 0; // Guarded by drain_lock
+
+static std::atomic<bool> running(false);
+static std::atomic<bool> sleeping(false);
+static std::atomic<async_log_sink_t> sink(NULL);
+static std::mutex drain_lock; // Only taken by the consumer side
+static std::condition_variable wake;
+static std::thread drain_thread;
+
+static void write_record(int level, const char *msg)
+{
+    async_log_sink_t s = sink.load(std::memory_order_relaxed);
+    if (s != NULL) {
+        s(level, msg);
+    } else {
+        // (lprintf) is the function in testing_h, not the macro
+        (lprintf)(level, "%s", msg);
+    }
+}
+
+static bool record_ready()
+{
+    log_record_t *r = &records[dequeue_pos & (ASYNC_LOG_RECORDS - 1)];
+    return r->seq.load(std::memory_order_acquire) == dequeue_pos + 1;
+}
+
+static bool drain_one()
+{
+    log_record_t *r = &records[dequeue_pos & (ASYNC_LOG_RECORDS - 1)];
+    if (r->seq.load(std::memory_order_acquire) != dequeue_pos + 1) {
+        return false;
+    }
+
+    write_record(r->level, r->msg);
+    r->seq.store(dequeue_pos + ASYNC_LOG_RECORDS, std::memory_order_release);
+    dequeue_pos++;
+    return true;
+}
+
+static void drain_loop()
+{
+    std::unique_lock<std::mutex> l(drain_lock);
+    while (running.load(std::memory_order_acquire)) {
+        if (drain_one()) {
+            continue;
+        }
+
+        // Producers only notify when this is set, they check it after publishing
+        // a record and, this checks for a record after setting it (see wake_drain)
+        sleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wake.wait(l, []() {
+            return !running.load(std::memory_order_acquire) || record_ready();
+        });
+        sleeping.store(false);
+    }
+
+    while (drain_one());
+    fflush(LOG_STREAM);
+}
+
+void async_log_init()
+{
+    if (running.load()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> l(drain_lock);
+        for (size_t i = 0; i < ASYNC_LOG_RECORDS; i++) {
+            records[i].seq.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos.store(0);
+        dequeue_pos = 0;
+    }
+
+    running.store(true, std::memory_order_release);
+    drain_thread = std::thread(drain_loop);
+
+    static bool registered = false;
+    if (!registered) {
+        atexit(async_log_stop);
+        registered = true;
+    }
+}
+
+void async_log_stop()
+{
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    {
+        // The drain thread is either before its check of running or, waiting
+        std::lock_guard<std::mutex> l(drain_lock);
+    }
+    wake.notify_one();
+    if (drain_thread.joinable()) {
+        drain_thread.join();
+    }
+}
+
+void async_log_flush()
+{
+    {
+        std::lock_guard<std::mutex> l(drain_lock);
+        while (drain_one());
+    }
+    fflush(LOG_STREAM);
+}
+
+// Called after a record is published
+static void wake_drain()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed)) {
+        {
+            std::lock_guard<std::mutex> l(drain_lock);
+        }
+        wake.notify_one();
+    }
+}
+
+void async_log_set_sink(async_log_sink_t s)
+{
+    sink.store(s);
+}
+
+static void write_long(int level, const char *fmt, va_list args, int len)
+{
+    char *msg = (char *) malloc(len + 1);
+    if (msg == NULL) {
+        write_record(level, "Cannot allocate log record\n");
+        return;
+    }
+
+    vsnprintf(msg, len + 1, fmt, args);
+    crash_log_append_record(level, msg, len);
+
+    // The records before it are written first
+    {
+        std::lock_guard<std::mutex> l(drain_lock);
+        while (drain_one());
+        write_record(level, msg);
+    }
+    free(msg);
+}
+
+void async_lprintf(int level, const char *fmt, ...)
+{
+    char msg[ASYNC_LOG_RECORD_SIZE];
+    va_list args, args_long;
+    va_start(args, fmt);
+    va_copy(args_long, args);
+    int len = vsnprintf(msg, sizeof(msg), fmt, args);
+    va_end(args);
+
+    if (len < 0) {
+        va_end(args_long);
+        return;
+    }
+
+    if ((size_t) len >= sizeof(msg)) {
+        write_long(level, fmt, args_long, len);
+        va_end(args_long);
+        return;
+    }
+    va_end(args_long);
+
+    // The crash log gets every record as it is logged, not when it is drained
+    crash_log_append_record(level, msg, len);
+    if (!running.load(std::memory_order_acquire)) {
+        write_record(level, msg);
+        return;
+    }
+
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    log_record_t *r;
+    for (;;) {
+        r = &records[pos & (ASYNC_LOG_RECORDS - 1)];
+        size_t seq = r->seq.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+        if (diff == 0) {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Full, wait for the drain thread rather than write this ahead of it
+            if (!running.load(std::memory_order_acquire)) {
+                std::lock_guard<std::mutex> l(drain_lock);
+                while (drain_one());
+                write_record(level, msg);
+                return;
+            }
+
+            wake_drain();
+            std::this_thread::yield();
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        } else {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    r->level = level;
+    memcpy(r->msg, msg, len + 1);
+    r->seq.store(pos + 1, std::memory_order_release);
+    wake_drain();
+}
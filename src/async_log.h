@@ -0,0 +1,36 @@
+#pragma once
+#include "../testing_h/logger.h"
+
+/*
+ * Asynchronous backend for lprintf. Records are formatted on the calling
+ * thread into a lock-free ring buffer and, written by a drain thread so that
+ * logging does not block hot paths on the log stream. When the drain thread
+ * is not running (tests, after a crash) records are written straight away.
+ * The drain thread sleeps until a record is logged, when the ring is full the
+ * producer waits for a free slot so that records are never reordered.
+ * Every record is also copied into the crash log (crash_log.h) as it is logged.
+ * */
+
+// Levels below LOG_MIN_LEVEL are compiled out, their arguments are not evaluated
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_INFO
+#endif
+
+#define ASYNC_LOG_RECORDS 4096 // Must be a power of two
+#define ASYNC_LOG_RECORD_SIZE 512 // Longer records are written synchronously
+
+typedef void (*async_log_sink_t)(int level, const char *msg);
+
+void async_log_init(); // Starts the drain thread, it is stopped at exit
+void async_log_stop(); // Writes everything then, stops the drain thread
+void async_log_flush(); // Writes everything logged so far
+void async_log_set_sink(async_log_sink_t sink); // NULL writes with lprintf
+void async_lprintf(int level, const char *fmt, ...);
+
+// Files that include this header log through the async backend
+#define lprintf(level, ...) \
+  do { \
+    if ((level) >= LOG_MIN_LEVEL) { \
+      async_lprintf(level, __VA_ARGS__); \
+    } \
+  } while (0)
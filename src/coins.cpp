@@ -3,7 +3,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include "./coins.h"
-#include "../testing_h/logger.h"
+#include "./async_log.h"
 
 #define fast_rand() \
   x ^= x << 16; \
@@ -19,14 +19,51 @@
 #  define __builtin_popcountl __popcnt64
 #endif
 
+#define LONG_BITS (sizeof(unsigned long) * 8)
+
+// The generator state lives for the whole thread, reseeding on each call with
+// time(NULL) ^ clock() gave identical results for calls in the same clock tick.
+static thread_local unsigned long rng_x, rng_y, rng_z;
+static thread_local bool rng_seeded = false;
+
+static inline void seed_rng()
+{
+    if (rng_seeded) {
+        return;
+    }
+
+    rng_x = (unsigned long) time(NULL) ^ (unsigned long) clock() ^ (unsigned long) &rng_seeded;
+    rng_y = 362436069;
+    rng_z = 521288629;
+    if (rng_x == 0) {
+        rng_x = 123456789;
+    }
+    rng_seeded = true;
+}
+
+// Loads the thread state into locals so that the hot loops stay in registers
+#define RNG_LOAD() \
+  seed_rng(); \
+  unsigned long x = rng_x, y = rng_y, z = rng_z; \
+  unsigned long t;
+
+#define RNG_STORE() \
+  rng_x = x; \
+  rng_y = y; \
+  rng_z = z;
+
 int flip_krark_coins(int coins)
 {
-    unsigned long x=time(NULL) ^ clock(), y=362436069, z=521288629;
-    unsigned long t, t2;
+    if (coins <= 0) {
+        return 0;
+    }
 
-    unsigned long i, count;
-    i = count = 0;
-    for (; (i += sizeof(long) * 8) <= coins;) {
+    RNG_LOAD();
+    unsigned long t2;
+
+    unsigned long full = coins / LONG_BITS, rem = coins % LONG_BITS;
+    unsigned long count = 0;
+    for (unsigned long i = 0; i < full; i++) {
         fast_rand();
         t2 = t;
         fast_rand();
@@ -34,38 +71,48 @@ int flip_krark_coins(int coins)
         count += __builtin_popcountl(t | t2);
     }
 
-    fast_rand();
-    t2 = t;
-    fast_rand();
-    count += __builtin_popcountl((t | t2) << ((sizeof(long) * 8) - coins + i));
+    // Only keep the bits for the remaining coins, the old shift was >= LONG_BITS
+    if (rem > 0) {
+        fast_rand();
+        t2 = t;
+        fast_rand();
+        count += __builtin_popcountl((t | t2) >> (LONG_BITS - rem));
+    }
 
+    RNG_STORE();
     return count;
 }
 
 int flip_coins(int coins)
 {
-    unsigned long x=time(NULL) ^ clock(), y=362436069, z=521288629;
-    unsigned long t;
+    if (coins <= 0) {
+        return 0;
+    }
+
+    RNG_LOAD();
 
-    unsigned long i, count;
-    i = count = 0;
-    for (; (i += sizeof(long) * 8) <= coins;) {
+    unsigned long full = coins / LONG_BITS, rem = coins % LONG_BITS;
+    unsigned long count = 0;
+    for (unsigned long i = 0; i < full; i++) {
         fast_rand();
 
         count += __builtin_popcountl(t);
     }
 
-    fast_rand();
-    count += __builtin_popcountl(t << ((sizeof(long) * 8) - coins + i));
+    if (rem > 0) {
+        fast_rand();
+        count += __builtin_popcountl(t >> (LONG_BITS - rem));
+    }
 
+    RNG_STORE();
     return count;
 }
 
-dice_roll_ret_t roll_dice(int sides, int number, int *status)
+dice_roll_ret_t new_dice_roll_ret(int sides, int *status)
 {
     // Alloc ret
     dice_roll_ret_t ret;
-    ret.dice_rolled = number;
+    ret.dice_rolled = 0;
     ret.sides = sides;
     ret.results = (dice_roll_res_line_t *) malloc(sizeof * ret.results * sides);
 
@@ -79,22 +126,37 @@ dice_roll_ret_t roll_dice(int sides, int number, int *status)
         *status = 1;
     }
 
-    memset(ret.results, NULL, sizeof * ret.results * sides);
+    memset(ret.results, 0, sizeof * ret.results * sides);
     for (int i = 0; i < sides; i++) {
         ret.results[i].side_number = i + 1;
     }
+    return ret;
+}
+
+void roll_dice_into(dice_roll_ret_t *ret, long long number)
+{
+    if (ret->results == NULL || number <= 0) {
+        return;
+    }
 
     // Fast random, same as coin flipper
-    unsigned long x=time(NULL) ^ clock(), y=362436069, z=521288629;
-    unsigned long t;
+    RNG_LOAD();
 
-    for (int i = 0; i < number; i++) {
+    unsigned long sides = ret->sides;
+    for (long long i = 0; i < number; i++) {
         fast_rand();
 
-        int dice_ret = t % sides;
-        ret.results[dice_ret].number_rolled++;
+        ret->results[t % sides].number_rolled++;
     }
 
+    RNG_STORE();
+    ret->dice_rolled += number;
+}
+
+dice_roll_ret_t roll_dice(int sides, long long number, int *status)
+{
+    dice_roll_ret_t ret = new_dice_roll_ret(sides, status);
+    roll_dice_into(&ret, number);
     return ret;
 }
 
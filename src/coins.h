@@ -5,11 +5,11 @@ int flip_coins(int coins);
 
 typedef struct dice_roll_res_line_t {
     int side_number;
-    int number_rolled;
+    long long number_rolled;
 } dice_roll_res_line_t;
 
 typedef struct dice_roll_ret_t {
-    int dice_rolled;
+    long long dice_rolled;
     int sides;
     dice_roll_res_line_t *results;
 } dice_roll_ret_t;
@@ -21,7 +21,13 @@ typedef struct dice_roll_ret_t {
 // 0 is fail
 // 1 is success
 // Ret (dice_roll_ret_t): A struct that has the distribution of the dice
-dice_roll_ret_t roll_dice(int sides, int number, int *status);
+dice_roll_ret_t roll_dice(int sides, long long number, int *status);
+
+// A distribution for a die with nothing rolled yet, status is as above
+dice_roll_ret_t new_dice_roll_ret(int sides, int *status);
+
+// Rolls number more dice into ret, so large rolls can be done in parts
+void roll_dice_into(dice_roll_ret_t *ret, long long number);
 
 void free_dice_roll_ret (dice_roll_ret_t ret);
 
@@ -4,126 +4,432 @@
 #include <string.h>
 #include <string>
 #include <list>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
 #include <sys/stat.h>
 #include <filesystem>
-#include "../testing_h/logger.h"
+#include "./async_log.h"
 #include "./utils.h"
 #include "./config.h"
+#include "./trace.h"
 
 #define TOURN_STYLE_TAG "style"
 #define TOURN_NAME_TAG "name"
+#define TOURN_FORMAT_TAG "format"
 #define TOURN_PAIRING_TAG "pairing_sys"
+#define TOURN_PLAYER_REG_TAG "player_reg"
+#define TOURN_PLAYERS_TAG "players"
+#define TOURN_STATUS_TAG "status"
 
-// Reads a recent tournament and, returns it
-static recent_tournament_t get_recent_tourn(char *name, int *status)
+// Reads the dashboard metadata of a tournament without building the whole json
+// tree, parsing stops as soon as everything has been seen.
+class RecentTournSax : public nlohmann::json_sax<nlohmann::json>
 {
-    recent_tournament_t ret;
-    memset(&ret, 0, sizeof(ret));
+public:
+    std::string name;
+    std::string pairingSys;
+    std::string status;
+    std::string format;
+    int playerCount = 0;
+    bool hasName = false;
+    bool hasFormat = false;
+    bool hasPairingSys = false;
+    bool hasStatus = false;
+    bool hasPlayers = false;
+
+    // The name and, pairing system are required, the rest is optional
+    bool valid()
+    {
+        return this->hasName && this->hasPairingSys;
+    }
+
+    bool done()
+    {
+        return this->valid() && this->hasStatus && this->hasPlayers && this->hasFormat;
+    }
+
+    bool null() override
+    {
+        return true;
+    }
+
+    bool boolean(bool) override
+    {
+        return true;
+    }
+
+    bool number_integer(number_integer_t) override
+    {
+        return true;
+    }
+
+    bool number_unsigned(number_unsigned_t) override
+    {
+        return true;
+    }
+
+    bool number_float(number_float_t, const string_t &) override
+    {
+        return true;
+    }
+
+    bool string(string_t &val) override
+    {
+        if (this->path.size() == 1 && this->lastKey == TOURN_NAME_TAG) {
+            this->name = val;
+            this->hasName = true;
+        } else if (this->path.size() == 1 && this->lastKey == TOURN_STATUS_TAG) {
+            this->status = val;
+            this->hasStatus = true;
+        } else if (this->path.size() == 1 && this->lastKey == TOURN_FORMAT_TAG) {
+            this->format = val;
+            this->hasFormat = true;
+        }
+        return !this->done();
+    }
+
+    bool binary(binary_t &) override
+    {
+        return true;
+    }
+
+    bool start_object(std::size_t) override
+    {
+        this->path.push_back(this->lastKey);
+        this->lastKey = "";
+        return true;
+    }
+
+    bool key(string_t &val) override
+    {
+        this->lastKey = val;
+
+        // The pairing system is the only key of root.pairing_sys.style
+        if (this->path.size() == 3
+            && this->path[1] == TOURN_PAIRING_TAG
+            && this->path[2] == TOURN_STYLE_TAG) {
+            this->pairingSys = val;
+            this->hasPairingSys = true;
+        } else if (this->inPlayers()) {
+            // root.player_reg.players is keyed by player id
+            this->playerCount++;
+        }
+        return !this->done();
+    }
+
+    bool end_object() override
+    {
+        if (this->inPlayers()) {
+            this->hasPlayers = true;
+        }
+
+        this->path.pop_back();
+        return !this->done();
+    }
 
-    ret.file_path = clone_string(name);
-    if (ret.file_path == NULL) {
-        *status = 0;
-        return ret;
+    bool start_array(std::size_t) override
+    {
+        this->path.push_back(this->lastKey);
+        this->lastKey = "";
+        return true;
     }
 
+    bool end_array() override
+    {
+        this->path.pop_back();
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &e) override
+    {
+        this->error = e.what();
+        return false;
+    }
+
+    std::string error;
+private:
+    std::vector<std::string> path;
+    std::string lastKey;
+
+    bool inPlayers()
+    {
+        return this->path.size() == 3
+               && this->path[1] == TOURN_PLAYER_REG_TAG
+               && this->path[2] == TOURN_PLAYERS_TAG;
+    }
+};
+
+static void local_time(time_t t, struct tm *ret)
+{
+#ifdef WINDOWS
+    localtime_s(ret, &t);
+#else
+    localtime_r(&t, ret);
+#endif
+}
+
+tourn_status_t tourn_status_from_str(std::string s)
+{
+    for (int i = TOURN_STATUS_PLANNED; i <= TOURN_STATUS_CANCELLED; i++) {
+        if (s == tourn_status_str((tourn_status_t) i)) {
+            return (tourn_status_t) i;
+        }
+    }
+    return TOURN_STATUS_UNKNOWN;
+}
+
+bool read_tourn_metadata(const char *path, tourn_metadata_t *ret)
+{
+    ret->name = "";
+    ret->format = "";
+    ret->pairing_sys = "";
+    ret->player_count = -1;
+    ret->status = TOURN_STATUS_UNKNOWN;
+    ret->file_size = -1;
+    ret->mtime = 0;
+
     // Get last time
     struct stat stat_ret;
-    int r = stat(name, &stat_ret);
+    int r = stat(path, &stat_ret);
     if (r != 0) {
-        lprintf(LOG_ERROR, "Cannot stat %s\n", name);
-        *status = 0;
-        return ret;
+        lprintf(LOG_ERROR, "Cannot stat %s\n", path);
+        return false;
     }
 
-    struct tm *edit_time = localtime(&stat_ret.st_mtime);
-    memcpy(&ret.last_opened, edit_time, sizeof * edit_time);
+    ret->file_size = stat_ret.st_size;
+    ret->mtime = stat_ret.st_mtime;
 
-    // Read file + data
-    FILE *f = fopen(name, "r");
-    if (f == NULL) {
-        lprintf(LOG_ERROR, "Cannot open %s\n", name);
-        *status = 0;
-        return ret;
-    }
-
-    char *data = read_all_f(f);
-    if (data == NULL) {
-        lprintf(LOG_ERROR, "Cannot read %s\n", name);
-        fclose(f);
-        *status = 0;
-        return ret;
+    // Read rather than mapped as squire_core may rewrite it in place meanwhile
+    file_view_t view;
+    if (!read_file_path(path, &view)) {
+        return false;
     }
-    fclose(f);
 
     // Parse data
-    int s = 0;
+    RecentTournSax sax;
     try {
-        nlohmann::json tourn = nlohmann::json::parse(data);
-        std::string name;
-        tourn.at(TOURN_NAME_TAG).get_to(name);
-        ret.name = clone_std_string(name);
-
-        nlohmann::json pairing = tourn.at(TOURN_PAIRING_TAG).at(TOURN_STYLE_TAG);
-        std::string sys;
-        int i = 0;
-        for (nlohmann::json::iterator it = pairing.begin(); it != pairing.end(); it++) {
-            sys = it.key();
-            i++;
-        }
+        nlohmann::json::sax_parse(view.data, view.data + view.size, &sax);
+    } catch(std::exception &e) {
+        lprintf(LOG_ERROR, "An error %s occurred reading a tournament's %s data\n", e.what(), path);
+    }
+    unmap_file(&view);
 
-        ret.pairing_sys = clone_std_string(sys);
-        if (ret.pairing_sys == NULL || strcmp(ret.pairing_sys, "") == 0) {
+    if (!sax.valid()) {
+        if (sax.error != "") {
+            lprintf(LOG_ERROR, "An error %s occurred reading a tournament's %s data\n", sax.error.c_str(), path);
+        } else if (!sax.hasPairingSys || sax.pairingSys == "") {
             lprintf(LOG_ERROR, "No tournament system\n");
-            goto cleanup;
-        }
-
-        if (ret.name == NULL) {
+        } else {
             lprintf(LOG_ERROR, "No tournament name\n");
-            goto cleanup;
         }
+        return false;
+    }
 
-        s = 1;
-    } catch(std::exception &e) {
-        lprintf(LOG_ERROR, "An error %s occurred reading a tournament's %s data\n", e.what(), name);
+    if (sax.pairingSys == "") {
+        return false;
     }
 
-    free(data);
+    ret->name = sax.name;
+    ret->format = sax.format;
+    ret->pairing_sys = sax.pairingSys;
+    if (sax.hasPlayers) {
+        ret->player_count = sax.playerCount;
+    }
+    ret->status = tourn_status_from_str(sax.status);
+    return true;
+}
+
+// Reads the metadata of the recent tournament at t->file_path into t, any
+// previous metadata is freed. Returns false if the file cannot be read.
+static bool read_recent_tourn(recent_tournament_t *t)
+{
+    if (t->name != NULL) {
+        free(t->name);
+    }
+    t->name = NULL;
+
+    if (t->pairing_sys != NULL) {
+        free(t->pairing_sys);
+    }
+    t->pairing_sys = NULL;
 
-cleanup:
+    t->player_count = -1;
+    t->status = TOURN_STATUS_UNKNOWN;
+    t->pending = false;
+
+    tourn_metadata_t meta;
+    bool s = read_tourn_metadata(t->file_path, &meta);
+    if (meta.file_size == -1) {
+        return false; // Cannot stat it
+    }
+
+    t->file_size = meta.file_size;
+    t->mtime = meta.mtime;
+    local_time((time_t) meta.mtime, &t->last_opened);
     if (!s) {
-        if (ret.name != NULL) {
-            free(ret.name);
+        return false;
+    }
+
+    t->name = clone_std_string(meta.name);
+    t->pairing_sys = clone_std_string(meta.pairing_sys);
+    t->player_count = meta.player_count;
+    t->status = meta.status;
+    s = t->name != NULL && t->pairing_sys != NULL;
+
+    if (!s) {
+        if (t->name != NULL) {
+            free(t->name);
         }
-        ret.name = NULL;
+        t->name = NULL;
 
-        if (ret.pairing_sys != NULL) {
-            free(ret.pairing_sys);
+        if (t->pairing_sys != NULL) {
+            free(t->pairing_sys);
         }
-        ret.pairing_sys = NULL;
+        t->pairing_sys = NULL;
     }
 
-    *status = s;
-    return ret;
+    return s;
+}
+
+// Reads the given recent tournaments from disk, as each file is independent
+// the results are written straight into their slot.
+static void get_recent_tourns(recent_tournament_t *tourns, std::vector<size_t> &indexes)
+{
+    parallel_for(indexes.size(), [&](size_t i) {
+        recent_tournament_t *t = &tourns[indexes[i]];
+        if (!read_recent_tourn(t)) {
+            lprintf(LOG_WARNING, "Cannot read tournament file %s\n", t->file_path);
+        }
+    });
 }
 
+// Fills the recent tournaments that have an entry in the cache, returns the
+// number of entries filled. The tournament files are not touched.
+static int read_recent_cache(recent_tournament_t *tourns, int count, FILE *f)
+{
+    file_view_t view;
+    if (!map_file(f, &view)) {
+        return 0;
+    }
+
+    std::unordered_map<std::string, std::vector<int>> index;
+    for (int i = 0; i < count; i++) {
+        index[std::string(tourns[i].file_path)].push_back(i);
+    }
+
+    int hits = 0;
+    try {
+        nlohmann::json j = nlohmann::json::parse(view.data, view.data + view.size);
+        for (nlohmann::json &entry : j.at(CACHE_ENTRIES)) {
+            std::string path;
+            entry.at(CACHE_PATH).get_to(path);
+
+            auto it = index.find(path);
+            if (it == index.end()) {
+                continue;
+            }
+
+            std::string name, pairing_sys, status;
+            long long size, mtime;
+            int player_count;
+            entry.at(CACHE_NAME).get_to(name);
+            entry.at(CACHE_PAIRING_SYS).get_to(pairing_sys);
+            entry.at(CACHE_STATUS).get_to(status);
+            entry.at(CACHE_SIZE).get_to(size);
+            entry.at(CACHE_MTIME).get_to(mtime);
+            entry.at(CACHE_PLAYER_COUNT).get_to(player_count);
+
+            for (int i : it->second) {
+                recent_tournament_t *t = &tourns[i];
+                if (t->name != NULL) {
+                    continue;
+                }
+
+                t->name = clone_std_string(name);
+                t->pairing_sys = clone_std_string(pairing_sys);
+                t->status = tourn_status_from_str(status);
+                t->file_size = size;
+                t->mtime = mtime;
+                t->player_count = player_count;
+                local_time((time_t) mtime, &t->last_opened);
+                hits++;
+            }
+        }
+    } catch (std::exception &e) {
+        lprintf(LOG_WARNING, "Cannot parse the recent tournament cache - %s\n", e.what());
+    }
+
+    unmap_file(&view);
+    return hits;
+}
+
+typedef std::unordered_map<std::string, int> recent_index_t;
+
+static recent_index_t *get_recent_index(config_t *config)
+{
+    if (config->recent_tournament_index == NULL) {
+        config->recent_tournament_index = new recent_index_t();
+    }
+    return (recent_index_t *) config->recent_tournament_index;
+}
+
+// Older configs may have duplicates or, too many entries. The newest copy of
+// each path is kept and, then only the newest MAXIMUM_RECENT_LIST_SIZE paths.
+static void dedup_recent_paths(std::vector<std::string> &paths)
+{
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> ret;
+    for (auto it = paths.rbegin(); it != paths.rend() && ret.size() < MAXIMUM_RECENT_LIST_SIZE; it++) {
+        if (seen.insert(*it).second) {
+            ret.push_back(*it);
+        }
+    }
+
+    std::reverse(ret.begin(), ret.end());
+    paths = ret;
+}
+
+static bool read_config(config_t *config, FILE *f, FILE *cache, bool defer_misses);
+
 bool init_config(config_t *config, FILE *f)
 {
+    return read_config(config, f, NULL, false);
+}
+
+bool init_config_cached(config_t *config, FILE *f, FILE *cache)
+{
+    return read_config(config, f, cache, false);
+}
+
+bool init_config_deferred(config_t *config, FILE *f, FILE *cache)
+{
+    return read_config(config, f, cache, true);
+}
+
+static bool read_config(config_t *config, FILE *f, FILE *cache, bool defer_misses)
+{
+    TRACE_SPAN("init_config", TRACE_CAT_IO);
     if (f == NULL) {
         lprintf(LOG_ERROR, "Invalid stream\n");
         return false;
     }
 
     lprintf(LOG_INFO, "Reading configuration...\n");
-    memset(config, 0, sizeof(config));
+    memset(config, 0, sizeof(*config));
 
-    char *data = read_all_f(f);
-    if (data == NULL) {
+    file_view_t view;
+    if (!map_file(f, &view)) {
         return false;
     }
 
     bool status = false;
     try {
-        nlohmann::json j = nlohmann::json::parse(data);
+        nlohmann::json j = nlohmann::json::parse(view.data, view.data + view.size);
 
         // Version check
         std::string ver;
@@ -157,6 +463,13 @@ bool init_config(config_t *config, FILE *f)
         j.at(CONFIG_REMEMBER_USER).get_to(config->remember_user);
         j.at(CONFIG_REPORT_CRASH).get_to(config->report_crashes);
 
+        // Only set by hand, to load test the crash report pipeline for example
+        if (j.contains(CONFIG_CRASH_REPORT_ENDPOINT)) {
+            std::string endpoint;
+            j.at(CONFIG_CRASH_REPORT_ENDPOINT).get_to(endpoint);
+            config->crash_report_endpoint = clone_std_string(endpoint);
+        }
+
         config->logged_in = name != "" && token != "";
 
         // Read root settings
@@ -165,23 +478,43 @@ bool init_config(config_t *config, FILE *f)
         config->tourn_save_path = clone_std_string(path);
 
         nlohmann::json recent = j.at(CONFIG_RECENT_TOURNS);
-        std::list<std::string> paths;
+        std::vector<std::string> paths;
         recent.get_to(paths);
+        dedup_recent_paths(paths);
 
-        int len = recent.size();
-        config->recent_tournaments = (recent_tournament_t *) malloc(sizeof * config->recent_tournaments * len);
+        int len = paths.size();
+        config->recent_tournaments = (recent_tournament_t *) malloc(sizeof * config->recent_tournaments * MAXIMUM_RECENT_LIST_SIZE);
         if (config->recent_tournaments != NULL) {
+            memset(config->recent_tournaments, 0, sizeof * config->recent_tournaments * MAXIMUM_RECENT_LIST_SIZE);
             config->recent_tournament_count = len;
-            int i = 0;
 
-            for (std::string path : paths) {
-                int r;
-                config->recent_tournaments[i] = get_recent_tourn((char *) path.c_str(), &r);
+            // Loaded lists start at slot 0
+            recent_index_t *index = get_recent_index(config);
+            for (int i = 0; i < len; i++) {
+                config->recent_tournaments[i].file_path = clone_std_string(paths[i]);
+                config->recent_tournaments[i].player_count = -1;
+                (*index)[paths[i]] = i;
+            }
 
-                if (!r) {
-                    lprintf(LOG_WARNING, "Cannot read tournament file %s\n", path.c_str());
+            int hits = 0;
+            if (cache != NULL) {
+                hits = read_recent_cache(config->recent_tournaments, len, cache);
+                lprintf(LOG_INFO, "Read %d/%d recent tournaments from the cache\n", hits, len);
+            }
+
+            // Only the files that were not in the cache are read
+            std::vector<size_t> misses;
+            for (int i = 0; i < len; i++) {
+                if (config->recent_tournaments[i].name == NULL) {
+                    misses.push_back(i);
+                    config->recent_tournaments[i].pending = defer_misses;
                 }
-                i++;
+            }
+
+            if (!defer_misses) {
+                get_recent_tourns(config->recent_tournaments, misses);
+            } else if (misses.size() > 0) {
+                lprintf(LOG_INFO, "Deferred reading %lu recent tournaments\n", (unsigned long) misses.size());
             }
         }
         status = true;
@@ -190,7 +523,7 @@ bool init_config(config_t *config, FILE *f)
         status = false;
     }
 
-    free(data);
+    unmap_file(&view);
 
     if (valid_config(*config) && status) {
         lprintf(LOG_INFO, "Confiuration is valid\n");
@@ -209,6 +542,11 @@ void free_config(config_t *config)
         config->tourn_save_path = NULL;
     }
 
+    if (config->crash_report_endpoint != NULL) {
+        free(config->crash_report_endpoint);
+        config->crash_report_endpoint = NULL;
+    }
+
     if (config->user.uuid != NULL) {
         free(config->user.uuid);
         config->user.uuid = NULL;
@@ -226,22 +564,16 @@ void free_config(config_t *config)
 
     if (config->recent_tournaments != NULL) {
         for (int i = 0; i < config->recent_tournament_count; i++) {
-            recent_tournament_t r = config->recent_tournaments[i];
-            if (r.name != NULL) {
-                free(r.name);
-            }
-
-            if (r.file_path != NULL) {
-                free(r.file_path);
-            }
-
-            if (r.pairing_sys != NULL) {
-                free(r.pairing_sys);
-            }
+            free_recent_tourn(recent_tourn_at(config, i));
         }
 
         free(config->recent_tournaments);
     }
+
+    if (config->recent_tournament_index != NULL) {
+        delete (recent_index_t *) config->recent_tournament_index;
+        config->recent_tournament_index = NULL;
+    }
 }
 
 bool valid_config(config_t config)
@@ -254,50 +586,68 @@ bool valid_config(config_t config)
 
 #define to_std_string(str) (str == NULL ? "": std::string(str))
 
+recent_tournament_t *recent_tourn_at(config_t *config, int i)
+{
+    return &config->recent_tournaments[(config->recent_tournament_head + i) % MAXIMUM_RECENT_LIST_SIZE];
+}
+
 bool add_recent_tourn(config_t *config, recent_tournament_t t, FILE *f)
 {
-    size_t offset = 0;
-    size_t cnt = config->recent_tournament_count + 1;
-    if (cnt > MAXIMUM_RECENT_LIST_SIZE) {
-        offset = cnt - MAXIMUM_RECENT_LIST_SIZE;
-        for (int i = 0; i < offset; i++) {
-            if (config->recent_tournaments[i].name != NULL)
-                free(config->recent_tournaments[i].name);
-            if (config->recent_tournaments[i].file_path != NULL)
-                free(config->recent_tournaments[i].file_path);
-            if (config->recent_tournaments[i].pairing_sys != NULL)
-                free(config->recent_tournaments[i].pairing_sys);
+    if (config->recent_tournaments == NULL) {
+        config->recent_tournaments = (recent_tournament_t *) malloc(sizeof * config->recent_tournaments * MAXIMUM_RECENT_LIST_SIZE);
+        if (config->recent_tournaments == NULL) {
+            lprintf(LOG_ERROR, "Malloc error\n");
+            return false;
         }
 
-        cnt = MAXIMUM_RECENT_LIST_SIZE;
-
-        lprintf(LOG_WARNING, "Maximum recents list reached, deleteing %ld entries\n", offset);
+        config->recent_tournament_count = 0;
+        config->recent_tournament_head = 0;
     }
 
-    recent_tournament_t *tmp = (recent_tournament_t *) malloc(cnt * sizeof * config->recent_tournaments);
-    if (tmp == NULL) {
-        lprintf(LOG_ERROR, "Malloc error\n");
-        return false;
-    }
+    recent_index_t *index = get_recent_index(config);
+    std::string path(t.file_path);
+    auto it = index->find(path);
 
-    if (config->recent_tournaments != NULL) {
-        // cnt - 1 is where to write the new tourn
-        memcpy(tmp, &config->recent_tournaments[offset], (cnt - 1 - (offset > 1 ? offset - 1 : 0)) * sizeof * config->recent_tournaments);
-        free(config->recent_tournaments);
+    int slot;
+    if (it != index->end()) {
+        int newest = (config->recent_tournament_head + config->recent_tournament_count - 1) % MAXIMUM_RECENT_LIST_SIZE;
+        slot = it->second;
+        if (slot == newest) {
+            return true; // Already the newest, nothing to write
+        }
+
+        // Move the entry to the newest slot, the entries after it shift back one
+        free_recent_tourn(&config->recent_tournaments[slot]);
+        for (int s = slot; s != newest; s = (s + 1) % MAXIMUM_RECENT_LIST_SIZE) {
+            config->recent_tournaments[s] = config->recent_tournaments[(s + 1) % MAXIMUM_RECENT_LIST_SIZE];
+            (*index)[std::string(config->recent_tournaments[s].file_path)] = s;
+        }
+        slot = newest;
+    } else {
+        if (config->recent_tournament_count == MAXIMUM_RECENT_LIST_SIZE) {
+            recent_tournament_t *oldest = recent_tourn_at(config, 0);
+            index->erase(std::string(oldest->file_path));
+            free_recent_tourn(oldest);
+
+            config->recent_tournament_head = (config->recent_tournament_head + 1) % MAXIMUM_RECENT_LIST_SIZE;
+            config->recent_tournament_count--;
+            lprintf(LOG_WARNING, "Maximum recents list reached, deleting the oldest entry\n");
+        }
+
+        slot = (config->recent_tournament_head + config->recent_tournament_count) % MAXIMUM_RECENT_LIST_SIZE;
+        config->recent_tournament_count++;
     }
 
-    // Clone input strings
-    t.name = clone_string(t.name);
-    t.pairing_sys = clone_string(t.pairing_sys);
-    t.file_path = clone_string(t.file_path);
+    config->recent_tournaments[slot] = clone_recent_tourn(t);
+    (*index)[path] = slot;
 
-    tmp[cnt - 1] = t;
-    config->recent_tournaments = tmp;
-    config->recent_tournament_count = cnt;
+    if (f == NULL) {
+        return true;
+    }
     return write_config(config, f);
 }
 
-bool write_config(config_t *config, FILE *f)
+std::string serialise_config(config_t *config)
 {
     nlohmann::json default_settings_json;
     default_settings_json[CONFIG_MATCH_SIZE] = config->default_settings.match_size;
@@ -315,7 +665,7 @@ bool write_config(config_t *config, FILE *f)
 
     std::list<std::string> recent;
     for (int i = 0; i < config->recent_tournament_count; i++) {
-        recent.push_back(std::string(config->recent_tournaments[i].file_path));
+        recent.push_back(std::string(recent_tourn_at(config, i)->file_path));
     }
 
     nlohmann::json ret;
@@ -326,8 +676,16 @@ bool write_config(config_t *config, FILE *f)
     ret[CONFIG_TOURN_SAVE_PATH] = to_std_string(config->tourn_save_path);
     ret[CONFIG_RECENT_TOURNS] = recent;
     ret[CONFIG_REPORT_CRASH] = config->report_crashes;
+    if (config->crash_report_endpoint != NULL) {
+        ret[CONFIG_CRASH_REPORT_ENDPOINT] = std::string(config->crash_report_endpoint);
+    }
 
-    std::string output = ret.dump();
+    return ret.dump();
+}
+
+bool write_config(config_t *config, FILE *f)
+{
+    std::string output = serialise_config(config);
 
     // Write and flush
     int num = fprintf(f, "%s", output.c_str());
@@ -337,6 +695,144 @@ bool write_config(config_t *config, FILE *f)
     return ((size_t) num) == output.size() && flush_status == 0;
 }
 
+bool save_config(config_t *config, const char *path)
+{
+    TRACE_SPAN("save_config", TRACE_CAT_IO);
+    atomic_file_t af;
+    if (!atomic_file_open(&af, path)) {
+        return false;
+    }
+
+    if (!write_config(config, af.f)) {
+        lprintf(LOG_ERROR, "Cannot write config to %s\n", af.tmp_path);
+        atomic_file_abort(&af);
+        return false;
+    }
+    return atomic_file_commit(&af);
+}
+
+bool revalidate_recent_tourns(recent_tournament_t *tourns, int count)
+{
+    std::atomic<bool> changed(false);
+    parallel_for(count, [&](size_t i) {
+        recent_tournament_t *t = &tourns[i];
+
+        struct stat stat_ret;
+        if (t->name != NULL
+            && stat(t->file_path, &stat_ret) == 0
+            && (long long) stat_ret.st_size == t->file_size
+            && (long long) stat_ret.st_mtime == t->mtime) {
+            return;
+        }
+
+        // A file that still cannot be read has not changed, unless it was pending
+        bool had = t->name != NULL || t->pending;
+        if (read_recent_tourn(t) || had) {
+            changed = true;
+        }
+    });
+
+    return changed;
+}
+
+bool write_recent_cache(recent_tournament_t *tourns, int count, FILE *f)
+{
+    nlohmann::json entries = nlohmann::json::array();
+    for (int i = 0; i < count; i++) {
+        recent_tournament_t t = tourns[i];
+        if (t.file_path == NULL || t.name == NULL || t.pairing_sys == NULL) {
+            continue;
+        }
+
+        nlohmann::json entry;
+        entry[CACHE_PATH] = std::string(t.file_path);
+        entry[CACHE_SIZE] = t.file_size;
+        entry[CACHE_MTIME] = t.mtime;
+        entry[CACHE_NAME] = std::string(t.name);
+        entry[CACHE_PAIRING_SYS] = std::string(t.pairing_sys);
+        entry[CACHE_PLAYER_COUNT] = t.player_count;
+        entry[CACHE_STATUS] = std::string(tourn_status_str(t.status));
+        entries.push_back(entry);
+    }
+
+    nlohmann::json ret;
+    ret[CONFIG_VERSION] = std::string(VERSION);
+    ret[CACHE_ENTRIES] = entries;
+
+    std::string output = ret.dump();
+    int num = fprintf(f, "%s", output.c_str());
+    int flush_status = fflush(f);
+
+    return ((size_t) num) == output.size() && flush_status == 0;
+}
+
+int merge_recent_tourns(config_t *config, recent_tournament_t *tourns, int count)
+{
+    bool same = count == config->recent_tournament_count;
+    for (int i = 0; same && i < count; i++) {
+        same = strcmp(tourns[i].file_path, recent_tourn_at(config, i)->file_path) == 0;
+    }
+
+    int ret = 0;
+    recent_index_t *index = get_recent_index(config);
+    for (int i = 0; i < count; i++) {
+        auto it = index->find(std::string(tourns[i].file_path));
+        recent_tournament_t *t = it == index->end() ? NULL : &config->recent_tournaments[it->second];
+        if (t != NULL && (same || t->pending)) {
+            free_recent_tourn(t);
+            *t = tourns[i];
+            ret++;
+        } else {
+            free_recent_tourn(&tourns[i]);
+        }
+    }
+    return ret;
+}
+
+recent_tournament_t clone_recent_tourn(recent_tournament_t t)
+{
+    t.file_path = t.file_path == NULL ? NULL : clone_string(t.file_path);
+    t.name = t.name == NULL ? NULL : clone_string(t.name);
+    t.pairing_sys = t.pairing_sys == NULL ? NULL : clone_string(t.pairing_sys);
+    return t;
+}
+
+void free_recent_tourn(recent_tournament_t *t)
+{
+    if (t->name != NULL) {
+        free(t->name);
+    }
+    t->name = NULL;
+
+    if (t->file_path != NULL) {
+        free(t->file_path);
+    }
+    t->file_path = NULL;
+
+    if (t->pairing_sys != NULL) {
+        free(t->pairing_sys);
+    }
+    t->pairing_sys = NULL;
+}
+
+const char *tourn_status_str(tourn_status_t s)
+{
+    switch(s) {
+    case TOURN_STATUS_PLANNED:
+        return "Planned";
+    case TOURN_STATUS_STARTED:
+        return "Started";
+    case TOURN_STATUS_FROZEN:
+        return "Frozen";
+    case TOURN_STATUS_ENDED:
+        return "Ended";
+    case TOURN_STATUS_CANCELLED:
+        return "Cancelled";
+    default:
+        return "Unknown";
+    }
+}
+
 const char *pairing_sys_str(tourn_type_t t)
 {
     switch(t) {
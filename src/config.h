@@ -1,9 +1,11 @@
 #pragma once
 #include <time.h>
 #include <stdio.h>
+#include <string>
 #include "./utils.h"
 
 #define CONFIG_FILE "config.json"
+#define RECENT_CACHE_FILE "recent_cache.json"
 #define TOURNAMENT_EXTENTION ".tourn"
 #define PAIRING_SWISS "Swiss"
 #define PAIRING_FLUID "Fluid"
@@ -22,13 +24,41 @@ typedef enum tourn_type_t {
     FLUID_TOURN = 1
 } tourn_type_t;
 
+typedef enum tourn_status_t {
+    TOURN_STATUS_UNKNOWN = 0,
+    TOURN_STATUS_PLANNED,
+    TOURN_STATUS_STARTED,
+    TOURN_STATUS_FROZEN,
+    TOURN_STATUS_ENDED,
+    TOURN_STATUS_CANCELLED
+} tourn_status_t;
+
 typedef struct recent_tournament_t {
     char *file_path;
     char *name;
     char *pairing_sys;
     struct tm last_opened;
+
+    // Metadata kept in RECENT_CACHE_FILE, an entry is stale when the file's
+    // size or, mtime no longer match.
+    long long file_size;
+    long long mtime;
+    int player_count; // -1 when unknown
+    tourn_status_t status;
+    bool pending; // Not read yet, revalidate_recent_tourns will read it
 } recent_tournament_t;
 
+// The dashboard metadata of a tournament file
+typedef struct tourn_metadata_t {
+    std::string name;
+    std::string format;
+    std::string pairing_sys;
+    int player_count; // -1 when unknown
+    tourn_status_t status;
+    long long file_size; // -1 when the file cannot be stat'ed
+    long long mtime;
+} tourn_metadata_t;
+
 typedef struct tourn_settings_t {
     // Default tournament settings
     // Player details
@@ -72,25 +102,32 @@ typedef struct tourn_settings_t {
 typedef struct config_t {
     squire_user_t user;
     bool report_crashes;
+    char *crash_report_endpoint; // NULL sends them to the crash handler's default
     bool logged_in; // Whether .user is set.
     bool remember_user;
     char *tourn_save_path; // Default path to save the tournaments to
     tourn_settings_t default_settings;
 
-    // Recent tournaments
+    // Recent tournaments, a ring buffer of MAXIMUM_RECENT_LIST_SIZE slots from
+    // the oldest to the newest entry. Use recent_tourn_at() to index it.
     int recent_tournament_count;
     recent_tournament_t *recent_tournaments;
+    int recent_tournament_head; // Slot of the oldest entry
+    void *recent_tournament_index; // File path -> slot, owned by config.cpp
 } config_t;
 
 #define DEFAULT_SAVE_PATH clone_string("tourns/")
 #define DEFAULT_CONFIG { \
   DEFAULT_USER,\
   false,\
+  NULL,\
   false,\
   false,\
   DEFAULT_SAVE_PATH,\
   DEFAULT_TOURN,\
   0,\
+  NULL,\
+  0,\
   NULL\
 }
 
@@ -120,14 +157,57 @@ typedef struct config_t {
 #define CONFIG_TOURN_SAVE_PATH "tourn-save-path"
 #define CONFIG_RECENT_TOURNS "recently-opened"
 #define CONFIG_REPORT_CRASH "report-crashes"
+#define CONFIG_CRASH_REPORT_ENDPOINT "crash-report-endpoint" // Optional
+
+// Recent tournament cache tags
+#define CACHE_ENTRIES "entries"
+#define CACHE_PATH "path"
+#define CACHE_SIZE "size"
+#define CACHE_MTIME "mtime"
+#define CACHE_NAME "name"
+#define CACHE_PAIRING_SYS "pairing-sys"
+#define CACHE_PLAYER_COUNT "player-count"
+#define CACHE_STATUS "status"
+#define CACHE_FORMAT "format"
 
 bool init_tourn_folder(config_t *config);
 bool init_config(config_t *config, FILE *f);
+// Same as init_config but, recent tournaments found in the cache are not read
+// from disk. cache can be NULL.
+bool init_config_cached(config_t *config, FILE *f, FILE *cache);
+// Same as init_config_cached but, the recent tournaments that are not in the
+// cache are left pending so that start up does not wait on them.
+bool init_config_deferred(config_t *config, FILE *f, FILE *cache);
 void free_config(config_t *config);
+
+// Adds t as the newest recent tournament, a path that is already in the list
+// is moved to the end instead. f is only written to if the list changed, it
+// can be NULL when the caller saves the config itself.
 bool add_recent_tourn(config_t *config, recent_tournament_t t, FILE *f);
+recent_tournament_t *recent_tourn_at(config_t *config, int i); // 0 is the oldest
 
 bool valid_config(config_t config);
 bool write_config(config_t *config, FILE *f);
+std::string serialise_config(config_t *config);
+// Writes the config to a temporary file then, renames it over path
+bool save_config(config_t *config, const char *path);
+
+// Re-reads each recent tournament whose size or, mtime has changed since it
+// was last read, returns true if any entry changed.
+bool revalidate_recent_tourns(recent_tournament_t *tourns, int count);
+// Reads a tournament file's metadata without parsing all of it, the size and,
+// mtime are set whenever the file can be stat'ed even if it cannot be parsed.
+bool read_tourn_metadata(const char *path, tourn_metadata_t *ret);
+bool write_recent_cache(recent_tournament_t *tourns, int count, FILE *f);
+// Moves revalidated copies of the recent tournaments into the config by path, the
+// copies are consumed. If the list changed since the copies were made only the
+// entries that are still pending are replaced as the others may be newer.
+// Returns how many entries were replaced.
+int merge_recent_tourns(config_t *config, recent_tournament_t *tourns, int count);
+recent_tournament_t clone_recent_tourn(recent_tournament_t t);
+void free_recent_tourn(recent_tournament_t *t);
 
 const char *pairing_sys_str(tourn_type_t t);
+const char *tourn_status_str(tourn_status_t s);
+tourn_status_t tourn_status_from_str(std::string s); // TOURN_STATUS_UNKNOWN if not known
 
@@ -0,0 +1,225 @@
+#include "./crash_log.h"
+#include "./async_log.h"
+#include <string.h>
+#include <atomic>
+#include <new>
+#ifdef UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#ifdef USE_BACKTRACE
+#include <execinfo.h>
+#endif
+
+#ifndef STDERR_FILENO
+#define STDERR_FILENO 2
+#endif
+#define CRASH_LOG_FRAMES 100
+
+// write_pos is in the mapped file so, it must be a plain lock free 64 bit word
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "std::atomic<uint64_t> has a different layout to uint64_t");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "std::atomic<uint64_t> must be lock free to be async signal safe");
+
+static std::atomic<crash_log_header_t *> header(NULL);
+static std::atomic<uint64_t> *write_pos = NULL; // &header->write_pos
+static char *ring = NULL;
+static size_t mapped_size = 0;
+
+bool crash_log_init(const char *path, size_t capacity)
+{
+    crash_log_close();
+#ifdef UNIX
+    if (capacity == 0) {
+        lprintf(LOG_ERROR, "Cannot make an empty crash log\n");
+        return false;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        lprintf(LOG_ERROR, "Cannot open crash log %s\n", path);
+        return false;
+    }
+
+    size_t size = sizeof(*header) + capacity;
+    if (ftruncate(fd, size) != 0) {
+        lprintf(LOG_ERROR, "Cannot size crash log %s\n", path);
+        close(fd);
+        return false;
+    }
+
+    // Shared so that the page cache keeps the writes when the process dies
+    void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        lprintf(LOG_ERROR, "Cannot mmap crash log %s\n", path);
+        return false;
+    }
+
+    crash_log_header_t *h = (crash_log_header_t *) data;
+    memcpy(h->magic, CRASH_LOG_MAGIC, sizeof(h->magic));
+    h->capacity = capacity;
+    write_pos = new (&h->write_pos) std::atomic<uint64_t>(0);
+
+#ifdef USE_BACKTRACE
+    // The first call loads libgcc which is not safe in a signal handler
+    void *frame;
+    backtrace(&frame, 1);
+#endif
+
+    mapped_size = size;
+    ring = (char *) data + sizeof(*header);
+    header.store(h, std::memory_order_release);
+    return true;
+#else
+    (void) path;
+    (void) capacity;
+    return false;
+#endif
+}
+
+void crash_log_close()
+{
+#ifdef UNIX
+    crash_log_header_t *h = header.exchange(NULL, std::memory_order_acq_rel);
+    if (h != NULL) {
+        munmap((void *) h, mapped_size);
+    }
+#endif
+}
+
+// Copies len bytes to the ring starting at pos, wrapping around the end
+static void ring_copy(uint64_t pos, uint64_t capacity, const char *msg, size_t len)
+{
+    if (len > capacity) {
+        pos += len - capacity;
+        msg += len - capacity;
+        len = capacity;
+    }
+
+    size_t start = pos % capacity;
+    size_t first = capacity - start;
+    if (first > len) {
+        first = len;
+    }
+
+    memcpy(ring + start, msg, first);
+    memcpy(ring, msg + first, len - first);
+}
+
+void crash_log_append(const char *msg, size_t len)
+{
+    crash_log_header_t *h = header.load(std::memory_order_acquire);
+    if (h == NULL || len == 0) {
+        return;
+    }
+
+    // Each writer reserves its own range so concurrent writers do not overlap
+    uint64_t pos = write_pos->fetch_add(len, std::memory_order_relaxed);
+    ring_copy(pos, h->capacity, msg, len);
+}
+
+void crash_log_append_record(int level, const char *msg, size_t len)
+{
+    crash_log_header_t *h = header.load(std::memory_order_acquire);
+    if (h == NULL) {
+        return;
+    }
+
+    const char *prefix;
+    switch (level) {
+    case LOG_INFO:
+        prefix = "[INFO] ";
+        break;
+    case LOG_WARNING:
+        prefix = "[WARNING] ";
+        break;
+    case LOG_ERROR:
+        prefix = "[ERROR] ";
+        break;
+    default:
+        prefix = "[?] ";
+        break;
+    }
+
+    size_t prefix_len = strlen(prefix);
+    uint64_t pos = write_pos->fetch_add(prefix_len + len, std::memory_order_relaxed);
+    ring_copy(pos, h->capacity, prefix, prefix_len);
+    ring_copy(pos + prefix_len, h->capacity, msg, len);
+}
+
+#ifdef UNIX
+// write(2) to stderr and, the ring
+static void report(const char *msg, size_t len)
+{
+    crash_log_append(msg, len);
+    while (len > 0) {
+        ssize_t w = write(STDERR_FILENO, msg, len);
+        if (w <= 0) {
+            return;
+        }
+        msg += w;
+        len -= w;
+    }
+}
+
+static void report_str(const char *msg)
+{
+    report(msg, strlen(msg));
+}
+
+// snprintf is not async signal safe
+static void report_int(int i)
+{
+    char buffer[16];
+    size_t p = sizeof(buffer);
+    unsigned int u = i < 0 ? -(unsigned int) i : (unsigned int) i;
+    do {
+        buffer[--p] = '0' + u % 10;
+        u /= 10;
+    } while (u > 0);
+
+    if (i < 0) {
+        buffer[--p] = '-';
+    }
+    report(buffer + p, sizeof(buffer) - p);
+}
+#endif
+
+void crash_log_signal_report(int sig, const char *context)
+{
+#ifdef UNIX
+    report_str("Crash detected, please share the following information in a crash report:\nSignal ");
+    report_int(sig);
+    report_str(":\n");
+
+#ifdef USE_BACKTRACE
+    void *frames[CRASH_LOG_FRAMES];
+    int size = backtrace(frames, CRASH_LOG_FRAMES);
+
+    // The symbols go through a pipe so that the ring gets a copy, a hundred
+    // frames is well under the pipe's buffer.
+    int fid[2];
+    if (pipe(fid) != 0) {
+        backtrace_symbols_fd(frames, size, STDERR_FILENO);
+    } else {
+        backtrace_symbols_fd(frames, size, fid[1]);
+        close(fid[1]);
+
+        char buffer[1024];
+        ssize_t r;
+        while ((r = read(fid[0], buffer, sizeof(buffer))) > 0) {
+            report(buffer, r);
+        }
+        close(fid[0]);
+    }
+#endif
+
+    if (context != NULL) {
+        report_str(context);
+    }
+#else
+    (void) sig;
+    (void) context;
+#endif
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <stddef.h>
+#include "./crash_log_format.h"
+
+/*
+ * Persistent crash log, every log record is copied into an mmap'ed file as it
+ * is logged so the last CRASH_LOG_SIZE bytes survive a hard crash without
+ * anything being copied at crash time. Appending is lock free and, async
+ * signal safe. It is a no-op before crash_log_init and, on windoze.
+ * */
+
+// Neither may be called while other threads are logging
+bool crash_log_init(const char *path, size_t capacity); // Truncates the file
+void crash_log_close();
+void crash_log_append(const char *msg, size_t len);
+void crash_log_append_record(int level, const char *msg, size_t len); // Prefixes the level
+
+// Appends the signal, context and, a raw backtrace to the crash log and,
+// stderr, only async signal safe calls are used.
+void crash_log_signal_report(int sig, const char *context);
@@ -0,0 +1,65 @@
+#pragma once
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * On disk layout of the crash log, this header is shared with the crash
+ * handler so it has to stay valid C. The file is a crash_log_header_t followed
+ * by capacity bytes of log used as a ring, write_pos counts every byte ever
+ * written so once it is past capacity the oldest byte is at write_pos % capacity.
+ * */
+#define CRASH_LOG_FILE "squiredesktop.crash.log"
+#define CRASH_LOG_MAGIC "SQCRASH1"
+#define CRASH_LOG_SIZE (4 * 1024 * 1024)
+
+typedef struct crash_log_header_t {
+    char magic[8];
+    uint64_t capacity;
+    uint64_t write_pos; // Bumped atomically by the writers
+} crash_log_header_t;
+
+// Returns the last max_len bytes of a crash log as a C string, free it after.
+// NULL is returned if the file is not a crash log.
+static inline char *crash_log_read_tail(FILE *f, size_t max_len)
+{
+    crash_log_header_t header;
+    if (f == NULL || fread(&header, sizeof(header), 1, f) != 1) {
+        return NULL;
+    }
+
+    if (memcmp(header.magic, CRASH_LOG_MAGIC, sizeof(header.magic)) != 0 || header.capacity == 0) {
+        return NULL;
+    }
+
+    uint64_t used = header.write_pos < header.capacity ? header.write_pos : header.capacity;
+    size_t len = used < max_len ? (size_t) used : max_len;
+    size_t start = (size_t) ((header.write_pos - len) % header.capacity);
+    size_t first = (size_t) header.capacity - start;
+    if (first > len) {
+        first = len;
+    }
+
+    char *ret = (char *) malloc(sizeof * ret * (len + 1));
+    if (ret == NULL) {
+        return NULL;
+    }
+
+    size_t r = 0;
+    if (fseek(f, (long) (sizeof(header) + start), SEEK_SET) == 0) {
+        r = fread(ret, 1, first, f);
+    }
+    if (r == first && len > first && fseek(f, (long) sizeof(header), SEEK_SET) == 0) {
+        r += fread(ret + first, 1, len - first, f);
+    }
+
+    // A writer that crashed mid record leaves zeros behind
+    for (size_t i = 0; i < r; i++) {
+        if (ret[i] == 0) {
+            ret[i] = '?';
+        }
+    }
+    ret[r] = 0;
+    return ret;
+}
@@ -0,0 +1,116 @@
+#include "./ffi_ledger.h"
+#include "./async_log.h"
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+typedef struct ffi_ledger_entry_t {
+    size_t size;
+    const char *func;
+} ffi_ledger_entry_t;
+
+static std::mutex ledger_lock;
+static std::unordered_map<const void *, ffi_ledger_entry_t> live;
+static ffi_ledger_stats_t totals;
+static std::chrono::steady_clock::time_point ledger_start = std::chrono::steady_clock::now();
+
+void ffi_ledger_alloc(const void *ptr, size_t size, const char *func)
+{
+    std::lock_guard<std::mutex> l(ledger_lock);
+    auto it = live.find(ptr);
+    if (it != live.end()) {
+        // The old one was freed without the ledger seeing it
+        lprintf(LOG_ERROR, "FFI allocation %p from %s was handed out again by %s\n", ptr, it->second.func, func);
+        totals.live_bytes -= it->second.size;
+        totals.live_allocs--;
+    }
+
+    live[ptr] = {size, func};
+    totals.allocs++;
+    totals.alloc_bytes += size;
+    totals.live_allocs++;
+    totals.live_bytes += size;
+}
+
+size_t ffi_ledger_free(const void *ptr, size_t size, const char *func)
+{
+    std::lock_guard<std::mutex> l(ledger_lock);
+    auto it = live.find(ptr);
+    if (it == live.end()) {
+        lprintf(LOG_ERROR, "%s frees %p (%lu bytes) which squire_core did not allocate, or was already freed\n",
+                func, ptr, (unsigned long) size);
+        totals.bad_frees++;
+        return size;
+    }
+
+    ffi_ledger_entry_t e = it->second;
+    live.erase(it);
+    if (e.size != size) {
+        lprintf(LOG_ERROR, "%s frees %p from %s with %lu bytes but it is %lu bytes\n",
+                func, ptr, e.func, (unsigned long) size, (unsigned long) e.size);
+        totals.bad_frees++;
+    }
+
+    totals.frees++;
+    totals.free_bytes += e.size;
+    totals.live_allocs--;
+    totals.live_bytes -= e.size;
+    return e.size;
+}
+
+ffi_ledger_stats_t ffi_ledger_stats()
+{
+    std::lock_guard<std::mutex> l(ledger_lock);
+    ffi_ledger_stats_t ret = totals;
+    std::chrono::duration<double> s = std::chrono::steady_clock::now() - ledger_start;
+    ret.seconds = s.count();
+    return ret;
+}
+
+void ffi_ledger_reset()
+{
+    std::lock_guard<std::mutex> l(ledger_lock);
+    live.clear();
+    memset(&totals, 0, sizeof(totals));
+    ledger_start = std::chrono::steady_clock::now();
+}
+
+void ffi_ledger_log()
+{
+    ffi_ledger_stats_t s = ffi_ledger_stats();
+    double seconds = s.seconds > 0 ? s.seconds : 1;
+    lprintf(LOG_INFO, "FFI ledger: %llu allocations (%.1f/s), %llu bytes (%.1f bytes/s) over %.1fs, %llu bad frees\n",
+            (unsigned long long) s.allocs, s.allocs / seconds,
+            (unsigned long long) s.alloc_bytes, s.alloc_bytes / seconds,
+            s.seconds,
+            (unsigned long long) s.bad_frees);
+}
+
+size_t ffi_ledger_report_leaks()
+{
+    typedef struct leak_t {
+        size_t count;
+        size_t bytes;
+    } leak_t;
+
+    std::map<std::string, leak_t> by_func;
+    size_t ret;
+    {
+        std::lock_guard<std::mutex> l(ledger_lock);
+        ret = live.size();
+        for (auto &a : live) {
+            leak_t &leak = by_func[a.second.func];
+            leak.count++;
+            leak.bytes += a.second.size;
+        }
+    }
+
+    for (auto &f : by_func) {
+        lprintf(LOG_WARNING, "Leaked %lu FFI allocations (%lu bytes) from %s\n",
+                (unsigned long) f.second.count, (unsigned long) f.second.bytes, f.first.c_str());
+    }
+    return ret;
+}
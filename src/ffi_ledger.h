@@ -0,0 +1,40 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "./ffi_stats.h"
+
+/*
+ * Ledger of the allocations that squire_core hands back, when built with
+ * FFI_LEDGER (debug and, test builds, or cmake -DUSE_FFI_LEDGER=ON) every
+ * allocation is recorded with the size that it was made with and, SQ_FREE checks
+ * that the caller frees it with the same size. Anything left at exit is a leak.
+ * */
+
+typedef struct ffi_ledger_stats_t {
+    uint64_t allocs;
+    uint64_t alloc_bytes;
+    uint64_t frees;
+    uint64_t free_bytes;
+    uint64_t bad_frees; // Wrong size or, not from squire_core
+    uint64_t live_allocs;
+    uint64_t live_bytes;
+    double seconds; // Since the ledger was started or, reset
+} ffi_ledger_stats_t;
+
+void ffi_ledger_alloc(const void *ptr, size_t size, const char *func);
+
+// Returns the size to free with, the recorded one if the given one is wrong
+size_t ffi_ledger_free(const void *ptr, size_t size, const char *func);
+
+ffi_ledger_stats_t ffi_ledger_stats();
+void ffi_ledger_reset(); // Forgets every allocation
+void ffi_ledger_log(); // Logs the traffic per second
+size_t ffi_ledger_report_leaks(); // Logs the live allocations by function, returns how many
+
+#ifdef FFI_LEDGER
+#define FFI_LEDGER_ALLOC(ptr, size) ffi_ledger_alloc(ptr, size, __func__)
+#define SQ_FREE(ptr, size) SQ_CALL(sq_free, ptr, ffi_ledger_free(ptr, size, __func__))
+#else
+#define FFI_LEDGER_ALLOC(ptr, size)
+#define SQ_FREE(ptr, size) SQ_CALL(sq_free, ptr, size)
+#endif
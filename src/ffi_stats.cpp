@@ -0,0 +1,192 @@
+#include "./ffi_stats.h"
+#include "./async_log.h"
+#include "./utils.h"
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+
+// Only the owning thread writes its counters so they are updated with plain
+// relaxed loads and, stores, the atomics are for the readers in ffi_stats_totals.
+typedef struct ffi_thread_stats_t {
+    std::atomic<uint64_t> calls[FFI_STATS_MAX_FUNCTIONS];
+    std::atomic<uint64_t> total_ns[FFI_STATS_MAX_FUNCTIONS];
+    std::atomic<uint64_t> max_ns[FFI_STATS_MAX_FUNCTIONS];
+    std::atomic<uint64_t> buckets[FFI_STATS_MAX_FUNCTIONS][FFI_STATS_BUCKETS];
+} ffi_thread_stats_t;
+
+static std::mutex stats_lock;
+static ffi_stat_t stats[FFI_STATS_MAX_FUNCTIONS];
+static size_t stat_count = 0;
+
+// Kept until exit so that calls from threads that have exited are still counted
+static std::vector<std::unique_ptr<ffi_thread_stats_t>> thread_stats;
+static thread_local ffi_thread_stats_t *local_stats = NULL;
+
+ffi_stat_t *ffi_stats_register(const char *name)
+{
+    std::lock_guard<std::mutex> l(stats_lock);
+    for (size_t i = 0; i < stat_count; i++) {
+        if (strcmp(stats[i].name, name) == 0) {
+            return &stats[i];
+        }
+    }
+
+    if (stat_count >= FFI_STATS_MAX_FUNCTIONS) {
+        lprintf(LOG_WARNING, "Too many FFI functions to instrument %s\n", name);
+        return NULL;
+    }
+
+    stats[stat_count].name = name;
+    stats[stat_count].index = stat_count;
+    return &stats[stat_count++];
+}
+
+size_t ffi_stats_bucket(uint64_t ns)
+{
+    size_t ret = 0;
+    while (ns > 0 && ret < FFI_STATS_BUCKETS - 1) {
+        ns >>= 1;
+        ret++;
+    }
+    return ret;
+}
+
+static void clear_thread_stats(ffi_thread_stats_t *s, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        s->calls[i].store(0, std::memory_order_relaxed);
+        s->total_ns[i].store(0, std::memory_order_relaxed);
+        s->max_ns[i].store(0, std::memory_order_relaxed);
+        for (size_t b = 0; b < FFI_STATS_BUCKETS; b++) {
+            s->buckets[i][b].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+static inline void bump(std::atomic<uint64_t> &c, uint64_t n)
+{
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+void ffi_stats_record(ffi_stat_t *stat, uint64_t ns)
+{
+    if (stat == NULL) {
+        return;
+    }
+
+    if (local_stats == NULL) {
+        local_stats = new ffi_thread_stats_t;
+        clear_thread_stats(local_stats, FFI_STATS_MAX_FUNCTIONS);
+        std::lock_guard<std::mutex> l(stats_lock);
+        thread_stats.push_back(std::unique_ptr<ffi_thread_stats_t>(local_stats));
+    }
+
+    size_t i = stat->index;
+    bump(local_stats->calls[i], 1);
+    bump(local_stats->total_ns[i], ns);
+    bump(local_stats->buckets[i][ffi_stats_bucket(ns)], 1);
+    if (ns > local_stats->max_ns[i].load(std::memory_order_relaxed)) {
+        local_stats->max_ns[i].store(ns, std::memory_order_relaxed);
+    }
+}
+
+std::vector<ffi_stat_totals_t> ffi_stats_totals()
+{
+    std::vector<ffi_stat_totals_t> ret;
+    std::lock_guard<std::mutex> l(stats_lock);
+    for (size_t i = 0; i < stat_count; i++) {
+        ffi_stat_totals_t t;
+        memset(&t, 0, sizeof(t));
+        t.name = stats[i].name;
+
+        for (std::unique_ptr<ffi_thread_stats_t> &s : thread_stats) {
+            t.calls += s->calls[i].load(std::memory_order_relaxed);
+            t.total_ns += s->total_ns[i].load(std::memory_order_relaxed);
+            t.max_ns = std::max<uint64_t>(t.max_ns, s->max_ns[i].load(std::memory_order_relaxed));
+            for (size_t b = 0; b < FFI_STATS_BUCKETS; b++) {
+                t.buckets[b] += s->buckets[i][b].load(std::memory_order_relaxed);
+            }
+        }
+
+        if (t.calls > 0) {
+            ret.push_back(t);
+        }
+    }
+
+    std::sort(ret.begin(), ret.end(), [](const ffi_stat_totals_t &a, const ffi_stat_totals_t &b) {
+        return a.total_ns > b.total_ns;
+    });
+    return ret;
+}
+
+void ffi_stats_reset()
+{
+    std::lock_guard<std::mutex> l(stats_lock);
+    for (std::unique_ptr<ffi_thread_stats_t> &s : thread_stats) {
+        clear_thread_stats(s.get(), stat_count);
+    }
+}
+
+std::string ffi_stats_json()
+{
+    nlohmann::json functions = nlohmann::json::array();
+    for (ffi_stat_totals_t &t : ffi_stats_totals()) {
+        nlohmann::json histogram = nlohmann::json::array();
+        for (size_t b = 0; b < FFI_STATS_BUCKETS; b++) {
+            if (t.buckets[b] > 0) {
+                histogram.push_back({(uint64_t) 1 << b, t.buckets[b]});
+            }
+        }
+
+        nlohmann::json f;
+        f[FFI_STATS_NAME] = std::string(t.name);
+        f[FFI_STATS_CALLS] = t.calls;
+        f[FFI_STATS_TOTAL_NS] = t.total_ns;
+        f[FFI_STATS_MEAN_NS] = t.total_ns / t.calls;
+        f[FFI_STATS_MAX_NS] = t.max_ns;
+        f[FFI_STATS_HISTOGRAM] = histogram;
+        functions.push_back(f);
+    }
+
+    nlohmann::json ret;
+    ret[FFI_STATS_FUNCTIONS] = functions;
+    return ret.dump();
+}
+
+bool ffi_stats_write(const char *path)
+{
+    atomic_file_t af;
+    if (!atomic_file_open(&af, path)) {
+        return false;
+    }
+
+    std::string output = ffi_stats_json();
+    if (fwrite(output.c_str(), 1, output.size(), af.f) != output.size()) {
+        lprintf(LOG_ERROR, "Cannot write FFI stats to %s\n", af.tmp_path);
+        atomic_file_abort(&af);
+        return false;
+    }
+
+    bool r = atomic_file_commit(&af);
+    if (r) {
+        lprintf(LOG_INFO, "Wrote FFI stats to %s\n", path);
+    }
+    return r;
+}
+
+void ffi_stats_log()
+{
+    std::vector<ffi_stat_totals_t> totals = ffi_stats_totals();
+    lprintf(LOG_INFO, "FFI stats for %lu functions:\n", (unsigned long) totals.size());
+    for (ffi_stat_totals_t &t : totals) {
+        lprintf(LOG_INFO, "%-32s %10llu calls %12.3fms total %10llu ns mean %12llu ns max\n",
+                t.name,
+                (unsigned long long) t.calls,
+                t.total_ns / 1e6,
+                (unsigned long long) (t.total_ns / t.calls),
+                (unsigned long long) t.max_ns);
+    }
+}
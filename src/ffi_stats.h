@@ -0,0 +1,94 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "./trace.h"
+
+/*
+ * Instrumentation for calls into squire_core. SQ_CALL(fn, args...) calls
+ * squire_core::fn(args...) and, when built with FFI_STATS (cmake
+ * -DUSE_FFI_STATS=ON) it also counts the call and, adds its latency to a log2
+ * histogram. Counters are thread local and, are only summed when dumped.
+ * Without FFI_STATS it is the bare call, it takes no locks and, is not
+ * serialised with other threads (see ffi_tourns_lock in ffi_utils.h).
+ * */
+
+#define FFI_STATS_MAX_FUNCTIONS 128
+#define FFI_STATS_BUCKETS 32 // Bucket i counts calls that took < 2^i ns
+#define FFI_STATS_FILE "ffi_stats.json"
+
+// Json tags
+#define FFI_STATS_FUNCTIONS "functions"
+#define FFI_STATS_NAME "name"
+#define FFI_STATS_CALLS "calls"
+#define FFI_STATS_TOTAL_NS "total-ns"
+#define FFI_STATS_MEAN_NS "mean-ns"
+#define FFI_STATS_MAX_NS "max-ns"
+#define FFI_STATS_HISTOGRAM "histogram" // [upper bound ns, calls] for non-empty buckets
+
+typedef struct ffi_stat_t {
+    const char *name;
+    size_t index;
+} ffi_stat_t;
+
+typedef struct ffi_stat_totals_t {
+    const char *name;
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t buckets[FFI_STATS_BUCKETS];
+} ffi_stat_totals_t;
+
+// The same name always returns the same stat, NULL if there are too many
+ffi_stat_t *ffi_stats_register(const char *name);
+void ffi_stats_record(ffi_stat_t *stat, uint64_t ns);
+size_t ffi_stats_bucket(uint64_t ns);
+
+// Sums every thread's counters, the most total time first
+std::vector<ffi_stat_totals_t> ffi_stats_totals();
+void ffi_stats_reset(); // Calls that are in flight may still be counted
+std::string ffi_stats_json();
+bool ffi_stats_write(const char *path);
+void ffi_stats_log();
+
+// The call is also the current span so that stalls inside it are named after it
+typedef struct ffi_stat_timer_t {
+    ffi_stat_t *stat;
+    const char *parent;
+    std::chrono::steady_clock::time_point start;
+
+    ffi_stat_timer_t(ffi_stat_t *s) : stat(s), start(std::chrono::steady_clock::now())
+    {
+        parent = trace_current_span.load(std::memory_order_relaxed);
+        if (s != NULL) {
+            if (parent == NULL) {
+                std::chrono::nanoseconds ns = start.time_since_epoch();
+                trace_outer_span_start.store(ns.count(), std::memory_order_relaxed);
+            }
+            trace_current_span.store(s->name, std::memory_order_relaxed);
+        }
+    }
+
+    ~ffi_stat_timer_t()
+    {
+        std::chrono::nanoseconds ns = std::chrono::steady_clock::now() - start;
+        ffi_stats_record(stat, ns.count());
+        trace_current_span.store(parent, std::memory_order_relaxed);
+    }
+} ffi_stat_timer_t;
+
+// Times expr under name, the stat is looked up once per call site
+#define FFI_STAT_CALL(name, expr) \
+  ([&]() { \
+    static ffi_stat_t *ffi_stat = ffi_stats_register(name); \
+    ffi_stat_timer_t ffi_stat_timer(ffi_stat); \
+    return expr; \
+  }())
+
+#ifdef FFI_STATS
+#define SQ_CALL(fn, ...) FFI_STAT_CALL(#fn, squire_core::fn(__VA_ARGS__))
+#else
+#define SQ_CALL(fn, ...) squire_core::fn(__VA_ARGS__)
+#endif
@@ -1,6 +1,7 @@
 #include <string.h>
 #include <stdio.h>
-#include "../testing_h/logger.h"
+#include "./ffi_utils.h"
+#include "./async_log.h"
 
 bool is_null_id(const unsigned char id[16])
 {
@@ -28,3 +29,9 @@ void print_id(const unsigned char id[16])
         fputc(to_hex(c1), LOG_STREAM);
     }
 }
+
+std::mutex &ffi_tourns_lock()
+{
+    static std::mutex l;
+    return l;
+}
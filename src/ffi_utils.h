@@ -1,5 +1,35 @@
 #pragma once
+#include <stddef.h>
+#include <mutex>
 
 bool is_null_id(const unsigned char id[16]);
 void print_id(const unsigned char id[16]);
 
+// squire_core is not known to be safe to add or, remove tournaments on more
+// than one thread at once so, load_tournament_from_file,
+// new_tournament_from_settings and close_tourn are only called with this held.
+// Calls on an open tournament do not take it, the preload worker is paused
+// while a tournament tab is active instead (see preload_queue_pause).
+std::mutex &ffi_tourns_lock();
+
+// The allocated size of a null id terminated array from squire_core
+template <class T>
+size_t id_array_size(const T *arr)
+{
+    size_t i = 0;
+    while (!is_null_id(arr[i]._0)) {
+        i++;
+    }
+    return (i + 1) * sizeof(*arr);
+}
+
+// As above for arrays that are terminated by a null player id
+template <class T>
+size_t pid_array_size(const T *arr)
+{
+    size_t i = 0;
+    while (!is_null_id(arr[i].pid._0)) {
+        i++;
+    }
+    return (i + 1) * sizeof(*arr);
+}
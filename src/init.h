@@ -1,4 +0,0 @@
-#pragma once
-
-// This inits all shared resources
-void init();
@@ -0,0 +1,210 @@
+#include "./library.h"
+#include "./async_log.h"
+#include "./trace.h"
+#include <sys/stat.h>
+#include <atomic>
+#include <filesystem>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <nlohmann/json.hpp>
+
+LibraryEntry::LibraryEntry()
+{
+    this->meta.player_count = -1;
+    this->meta.status = TOURN_STATUS_UNKNOWN;
+    this->meta.file_size = -1;
+    this->meta.mtime = 0;
+}
+
+LibraryEntry::LibraryEntry(std::string path, tourn_metadata_t meta)
+{
+    this->path = path;
+    this->meta = meta;
+}
+
+static bool contains(std::string str, std::string &query)
+{
+    toLowerCase(str);
+    return str.find(query) != std::string::npos;
+}
+
+bool LibraryEntry::matches(std::string query)
+{
+    toLowerCase(query);
+    return contains(this->meta.name, query)
+           || contains(this->meta.format, query)
+           || contains(this->meta.pairing_sys, query)
+           || contains(this->path, query);
+}
+
+std::vector<int (*)(const LibraryEntry &, const LibraryEntry &)> LibraryEntry::getDefaultAlgs()
+{
+    // One per column of the library table
+    std::vector<int (*)(const LibraryEntry &, const LibraryEntry &)> ret;
+    ret.push_back(&cmpLibDate);
+    ret.push_back(&cmpLibName);
+    ret.push_back(&cmpLibFormat);
+    ret.push_back(&cmpLibPairing);
+    ret.push_back(&cmpLibPlayers);
+    return ret;
+}
+
+// Newest first
+int cmpLibDate(const LibraryEntry &a, const LibraryEntry &b)
+{
+    return a.meta.mtime > b.meta.mtime;
+}
+
+int cmpLibName(const LibraryEntry &a, const LibraryEntry &b)
+{
+    return a.meta.name < b.meta.name;
+}
+
+int cmpLibFormat(const LibraryEntry &a, const LibraryEntry &b)
+{
+    return a.meta.format < b.meta.format;
+}
+
+int cmpLibPairing(const LibraryEntry &a, const LibraryEntry &b)
+{
+    return a.meta.pairing_sys < b.meta.pairing_sys;
+}
+
+int cmpLibPlayers(const LibraryEntry &a, const LibraryEntry &b)
+{
+    return a.meta.player_count < b.meta.player_count;
+}
+
+std::vector<std::string> library_find_files(const char *dir)
+{
+    std::vector<std::string> ret;
+    std::error_code ec;
+    std::filesystem::recursive_directory_iterator it(dir, std::filesystem::directory_options::skip_permission_denied, ec);
+    if (ec) {
+        lprintf(LOG_WARNING, "Cannot list %s - %s\n", dir, ec.message().c_str());
+        return ret;
+    }
+
+    for (; it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) {
+            lprintf(LOG_WARNING, "Cannot list %s - %s\n", dir, ec.message().c_str());
+            break;
+        }
+
+        if (it->is_regular_file(ec) && it->path().extension() == TOURNAMENT_EXTENTION) {
+            ret.push_back(it->path().string());
+        }
+    }
+    return ret;
+}
+
+static void read_library_cache(FILE *f, std::unordered_map<std::string, LibraryEntry> &ret)
+{
+    file_view_t view;
+    if (!map_file(f, &view)) {
+        return;
+    }
+
+    try {
+        nlohmann::json j = nlohmann::json::parse(view.data, view.data + view.size);
+        for (nlohmann::json &entry : j.at(CACHE_ENTRIES)) {
+            LibraryEntry e;
+            entry.at(CACHE_PATH).get_to(e.path);
+            entry.at(CACHE_NAME).get_to(e.meta.name);
+            entry.at(CACHE_FORMAT).get_to(e.meta.format);
+            entry.at(CACHE_PAIRING_SYS).get_to(e.meta.pairing_sys);
+            e.meta.status = tourn_status_from_str(entry.at(CACHE_STATUS).get<std::string>());
+            entry.at(CACHE_SIZE).get_to(e.meta.file_size);
+            entry.at(CACHE_MTIME).get_to(e.meta.mtime);
+            entry.at(CACHE_PLAYER_COUNT).get_to(e.meta.player_count);
+            ret[e.path] = e;
+        }
+    } catch (std::exception &e) {
+        lprintf(LOG_WARNING, "Cannot parse the library cache - %s\n", e.what());
+    }
+
+    unmap_file(&view);
+}
+
+std::vector<LibraryEntry> library_index(std::vector<std::string> paths, FILE *cache)
+{
+    TRACE_SPAN("library_index", TRACE_CAT_IO);
+    std::unordered_map<std::string, LibraryEntry> cached;
+    if (cache != NULL) {
+        read_library_cache(cache, cached);
+    }
+
+    // Duplicate paths would be read twice
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> unique;
+    for (std::string &path : paths) {
+        if (seen.insert(path).second) {
+            unique.push_back(path);
+        }
+    }
+
+    std::vector<LibraryEntry> entries(unique.size());
+    std::vector<char> found(unique.size(), 0);
+    std::atomic<size_t> hits(0);
+    parallel_for(unique.size(), [&](size_t i) {
+        const char *path = unique[i].c_str();
+        auto it = cached.find(unique[i]);
+
+        struct stat stat_ret;
+        if (it != cached.end()
+            && stat(path, &stat_ret) == 0
+            && (long long) stat_ret.st_size == it->second.meta.file_size
+            && (long long) stat_ret.st_mtime == it->second.meta.mtime) {
+            entries[i] = it->second;
+            found[i] = 1;
+            hits++;
+            return;
+        }
+
+        tourn_metadata_t meta;
+        if (read_tourn_metadata(path, &meta)) {
+            entries[i] = LibraryEntry(unique[i], meta);
+            found[i] = 1;
+        }
+    });
+
+    std::vector<LibraryEntry> ret;
+    ret.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (found[i]) {
+            ret.push_back(entries[i]);
+        }
+    }
+
+    lprintf(LOG_INFO, "Indexed %lu tournaments, %lu from the cache\n",
+            (unsigned long) ret.size(), (unsigned long) hits.load());
+    return ret;
+}
+
+bool library_write_cache(std::vector<LibraryEntry> &entries, FILE *f)
+{
+    nlohmann::json arr = nlohmann::json::array();
+    for (LibraryEntry &e : entries) {
+        nlohmann::json entry;
+        entry[CACHE_PATH] = e.path;
+        entry[CACHE_SIZE] = e.meta.file_size;
+        entry[CACHE_MTIME] = e.meta.mtime;
+        entry[CACHE_NAME] = e.meta.name;
+        entry[CACHE_FORMAT] = e.meta.format;
+        entry[CACHE_PAIRING_SYS] = e.meta.pairing_sys;
+        entry[CACHE_PLAYER_COUNT] = e.meta.player_count;
+        entry[CACHE_STATUS] = std::string(tourn_status_str(e.meta.status));
+        arr.push_back(entry);
+    }
+
+    nlohmann::json ret;
+    ret[CONFIG_VERSION] = std::string(VERSION);
+    ret[CACHE_ENTRIES] = arr;
+
+    std::string output = ret.dump();
+    int num = fprintf(f, "%s", output.c_str());
+    int flush_status = fflush(f);
+
+    return ((size_t) num) == output.size() && flush_status == 0;
+}
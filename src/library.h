@@ -0,0 +1,41 @@
+#pragma once
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "./config.h"
+
+/*
+ * The tournament library, every tournament file under the save folder. The
+ * metadata is kept in LIBRARY_CACHE_FILE so that only new or, changed files
+ * are read when the library is indexed.
+ * */
+
+#define LIBRARY_CACHE_FILE "library_cache.json"
+
+class LibraryEntry
+{
+public:
+    LibraryEntry();
+    LibraryEntry(std::string path, tourn_metadata_t meta);
+    bool matches(std::string query);
+    std::vector<int (*)(const LibraryEntry &, const LibraryEntry &)> getDefaultAlgs();
+
+    std::string path;
+    tourn_metadata_t meta;
+};
+
+// These are used as std::stable_sort comparisons, so they return a < b
+int cmpLibDate(const LibraryEntry &a, const LibraryEntry &b);
+int cmpLibName(const LibraryEntry &a, const LibraryEntry &b);
+int cmpLibFormat(const LibraryEntry &a, const LibraryEntry &b);
+int cmpLibPairing(const LibraryEntry &a, const LibraryEntry &b);
+int cmpLibPlayers(const LibraryEntry &a, const LibraryEntry &b);
+
+// Every file with TOURNAMENT_EXTENTION under dir
+std::vector<std::string> library_find_files(const char *dir);
+
+// Reads the metadata of each path, entries in the cache whose size and, mtime
+// still match are not read again. cache can be NULL. Unreadable files are left
+// out.
+std::vector<LibraryEntry> library_index(std::vector<std::string> paths, FILE *cache);
+bool library_write_cache(std::vector<LibraryEntry> &entries, FILE *f);
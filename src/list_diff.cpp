@@ -0,0 +1,65 @@
+#include "./list_diff.h"
+#include <unordered_set>
+
+std::vector<list_op_t> list_diff(const std::vector<std::string> &old_keys,
+                                 const std::vector<std::string> &new_keys)
+{
+    std::vector<list_op_t> ret;
+    std::unordered_set<std::string> kept(new_keys.begin(), new_keys.end());
+
+    // Remove from the bottom so that the indexes above stay valid
+    std::vector<std::string> cur = old_keys;
+    for (size_t i = cur.size(); i > 0; i--) {
+        if (kept.find(cur[i - 1]) == kept.end()) {
+            ret.push_back({LIST_OP_REMOVE, i - 1, i - 1});
+            cur.erase(cur.begin() + (i - 1));
+        }
+    }
+
+    // Every row above i is in place, so a row that is out of place is either
+    // below i or, new
+    for (size_t i = 0; i < new_keys.size(); i++) {
+        if (i < cur.size() && cur[i] == new_keys[i]) {
+            continue;
+        }
+
+        size_t j = i + 1;
+        while (j < cur.size() && cur[j] != new_keys[i]) {
+            j++;
+        }
+
+        if (j < cur.size()) {
+            ret.push_back({LIST_OP_MOVE, j, i});
+            std::string key = cur[j];
+            cur.erase(cur.begin() + j);
+            cur.insert(cur.begin() + i, key);
+        } else {
+            ret.push_back({LIST_OP_INSERT, i, i});
+            cur.insert(cur.begin() + i, new_keys[i]);
+        }
+    }
+
+    return ret;
+}
+
+void list_diff_apply(std::vector<std::string> &keys,
+                     const std::vector<list_op_t> &ops,
+                     const std::vector<std::string> &new_keys)
+{
+    for (const list_op_t &op : ops) {
+        std::string key;
+        switch (op.type) {
+        case LIST_OP_REMOVE:
+            keys.erase(keys.begin() + op.from);
+            break;
+        case LIST_OP_MOVE:
+            key = keys[op.from];
+            keys.erase(keys.begin() + op.from);
+            keys.insert(keys.begin() + op.to, key);
+            break;
+        case LIST_OP_INSERT:
+            keys.insert(keys.begin() + op.to, new_keys[op.to]);
+            break;
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/*
+ * Turns one ordering of keyed rows into another as row removals, moves and,
+ * inserts so that a model can tell its views which rows moved rather than
+ * resetting. The ops are in the order to apply them, each index is into the
+ * list as it is after the ops before it.
+ * */
+
+typedef enum list_op_type_t {
+    LIST_OP_REMOVE, // Row from is removed
+    LIST_OP_MOVE, // Row from is moved to before row to, to is always < from
+    LIST_OP_INSERT // New row is inserted at to
+} list_op_type_t;
+
+typedef struct list_op_t {
+    list_op_type_t type;
+    size_t from;
+    size_t to;
+} list_op_t;
+
+// Keys must be unique within each list
+std::vector<list_op_t> list_diff(const std::vector<std::string> &old_keys,
+                                 const std::vector<std::string> &new_keys);
+
+// Applies the ops to old_keys, inserts are taken from new_keys
+void list_diff_apply(std::vector<std::string> &keys,
+                     const std::vector<list_op_t> &ops,
+                     const std::vector<std::string> &new_keys);
@@ -8,25 +8,32 @@
 #include <string.h>
 #include <time.h>
 #include <QApplication>
+#include <QEvent>
 #include <QLocale>
 #include <QTranslator>
 #include <QtGlobal>
+#include <QTimer>
+#include <functional>
 #include "./ui/mainwindow.h"
 #include "./config.h"
-#include "../testing_h/logger.h"
-#include "./init.h"
+#include "./async_log.h"
+#include "./crash_log.h"
+#include "./ffi_ledger.h"
+#include "./ffi_stats.h"
+#include "./trace.h"
+#include "./stall_watchdog.h"
+#include "./startup_profile.h"
 #include <squire_core/squire_core.h>
 
-static void print_error_system_information()
-{
-    lprintf(LOG_ERROR, "Operating System: " OS "\n");
-    lprintf(LOG_ERROR, "Squire Desktop Version: " VERSION "\n");
-    lprintf(LOG_ERROR, "Squire Core Version: " SQ_VERSION "\n");
+// Formatted at startup as the signal handler cannot call snprintf
+static char system_information[2048];
 
+static void init_system_information()
+{
+    char hostname[1024] = "unknown";
 #ifdef UNIX
-    char buffer[1024];
-    if (gethostname(buffer, sizeof(buffer)) == 0) {
-        lprintf(LOG_ERROR, "Hostname: %s\n", buffer);
+    if (gethostname(hostname, sizeof(hostname)) != 0) {
+        strcpy(hostname, "unknown");
     }
 #endif
 
@@ -35,61 +42,94 @@ static void print_error_system_information()
     int qt_major = (QT_VERSION >> 8) & 0xff;
     int qt_minor = QT_VERSION & 0xff;
 
-    lprintf(LOG_ERROR, "Qt Version: %x (%d.%d.%d)\n", QT_VERSION, qt_api, qt_major, qt_minor);
+    snprintf(system_information, sizeof(system_information),
+             "Operating System: " OS "\n"
+             "Squire Desktop Version: " VERSION "\n"
+             "Squire Core Version: " SQ_VERSION "\n"
+             "Hostname: %s\n"
+             "Qt Version: %x (%d.%d.%d)\n",
+             hostname, QT_VERSION, qt_api, qt_major, qt_minor);
 }
 
-#ifdef USE_BACKTRACE
-#ifndef STDERR_FILENO
-#define STDERR_FILENO 2
-#endif
-static void handler(int sig)
+static void print_error_system_information()
 {
-    void *array[100];
-    size_t size;
-
-    // get void*'s for all entries on the stack
-    size = backtrace(array, sizeof(array));
-
-    // print out all the frames to stderr
-    lprintf(LOG_ERROR, "Crash detected, please share the following information in a crash report:\n");
-    lprintf(LOG_ERROR, "Signal %d:\n", sig);
-
-    int fid[2];
-    int r = pipe(fid);
+    lprintf(LOG_ERROR, "%s", system_information);
+}
 
-    if (r != 0) {
-        // Write to stderr on error
-        lprintf(LOG_ERROR, "Printing stack trace to stderr, pipe err\n");
-        backtrace_symbols_fd(array, size, STDERR_FILENO);
-    } else {
-        lprintf(LOG_ERROR, "Printing stack trace...\n");
-        backtrace_symbols_fd(array, size, fid[1]);
-        close(fid[1]);
-
-        FILE *read = fdopen(fid[0], "r");
-        if (read == NULL) {
-            lprintf(LOG_ERROR, "Pipe error\n");
-            exit(1);
+// Calls fn once after the first paint of the widget that it is installed on
+class FirstPaintFilter : public QObject
+{
+public:
+    FirstPaintFilter(std::function<void()> fn) : fn(fn) {}
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *e) override
+    {
+        if (e->type() == QEvent::Paint && this->fn) {
+            obj->removeEventFilter(this);
+            QTimer::singleShot(0, this->fn);
+            this->fn = nullptr;
         }
+        return false;
+    }
 
-        char buffer[4096];
+private:
+    std::function<void()> fn;
+};
 
-        // Read line by line
-        for (int i = 0; fgets(buffer, sizeof(buffer), read) != NULL; i++) {
-            lprintf(LOG_ERROR, ANSI_BLUE "#%d" ANSI_RESET ": %s", i, buffer);
+// Brings the stall watchdog's ping rate back up when the user gives the app work
+class ActivityFilter : public QObject
+{
+protected:
+    bool eventFilter(QObject *obj, QEvent *e) override
+    {
+        switch (e->type()) {
+        case QEvent::KeyPress:
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::Wheel:
+            stall_watchdog_activity();
+            break;
+        default:
+            break;
         }
-        fclose(read);
+        return false;
     }
+};
 
-    print_error_system_information();
-    exit(1);
+#ifdef USE_BACKTRACE
+static void handler(int sig)
+{
+    // Everything logged so far is already in the crash log, so only async
+    // signal safe calls are made here.
+    crash_log_signal_report(sig, system_information);
+    _exit(1);
 }
 #endif
 
 int main(int argc, char *argv[])
 {
+    startup_profile_start();
+    init_system_information();
+#ifdef UNIX
+    if (!crash_log_init(CRASH_LOG_FILE, CRASH_LOG_SIZE)) {
+        lprintf(LOG_WARNING, "Cannot create the crash log, crash reports will have less information\n");
+    }
+#endif
+    async_log_init(); // Flushed at exit
     lprintf(LOG_INFO, "Starting...\n");
 
+    bool profile_startup = false;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], TRACE_ARG, strlen(TRACE_ARG)) == 0) {
+            trace_init(argv[i] + strlen(TRACE_ARG));
+            trace_set_thread_name("main");
+        } else if (strcmp(argv[i], STARTUP_PROFILE_ARG) == 0) {
+            profile_startup = true;
+        }
+    }
+    startup_phase("logging");
+
 #ifdef USE_BACKTRACE
     lprintf(LOG_INFO, "Crash detection is enabled in this build!\n");
 
@@ -101,12 +141,11 @@ int main(int argc, char *argv[])
 
     squire_core::init_squire_ffi(); // Inits the global tourn struct
     srand(time(NULL));
+    startup_phase("init_squire_ffi");
 
     // Qt init
     QApplication a(argc, argv);
-
-    lprintf(LOG_INFO, "Running shared asset init\n");
-    init();
+    startup_phase("QApplication");
 
     bool t = false;
     QTranslator translator;
@@ -124,41 +163,68 @@ int main(int argc, char *argv[])
     if (!t) {
         lprintf(LOG_INFO, "Using default translations (English)...\n");
     }
+    startup_phase("translations");
 
     // Read config
     config_t config;
     FILE *f = fopen(CONFIG_FILE, "r");
     if (f == NULL) {
-        f = fopen(CONFIG_FILE, "w");
         config_t default_config = DEFAULT_CONFIG;
         memcpy(&config, &default_config, sizeof(default_config));
 
-        if (f != NULL) {
-            lprintf(LOG_WARNING, "Cannot open config file to read it, trying to make a new one with default values...\n");
-
-            bool r = write_config(&config, f);
-            if (!r) {
-                lprintf(LOG_ERROR, "Cannot write config file.\n");
-            } else {
-                lprintf(LOG_INFO, "Created a new config file %s.\n", CONFIG_FILE);
-            }
-            fclose(f);
+        lprintf(LOG_WARNING, "Cannot open config file to read it, trying to make a new one with default values...\n");
+        bool r = save_config(&config, CONFIG_FILE);
+        if (!r) {
+            lprintf(LOG_ERROR, "Cannot write config file.\n");
         } else {
-            lprintf(LOG_ERROR, "Cannot open config file to write.\n");
+            lprintf(LOG_INFO, "Created a new config file %s.\n", CONFIG_FILE);
         }
     } else {
         lprintf(LOG_INFO, "Reading configuration file %s\n", CONFIG_FILE);
-        bool r = init_config(&config, f);
+        FILE *cache = fopen(RECENT_CACHE_FILE, "r");
+        bool r = init_config_deferred(&config, f, cache);
         if (!r) {
             lprintf(LOG_ERROR, "Cannot read config file as it is invalid.\n");
         }
         fclose(f);
+
+        if (cache != NULL) {
+            fclose(cache);
+        }
     }
 
+    startup_phase("config");
+
     // Start app
     lprintf(LOG_INFO, "Starting Squire Desktop " VERSION "...\n");
     MainWindow w(&config);
+    startup_phase("MainWindow");
     w.show();
+    startup_phase("show");
+
+    // Work that the first paint does not need
+    FirstPaintFilter firstPaint([&w, profile_startup]() {
+        startup_phase("first paint");
+        lprintf(LOG_INFO, "Window painted after %.1fms\n", startup_profile_total_ns() / 1e6);
+
+        w.startDiscord();
+        w.restoreSession();
+        w.preloadRecent();
+        startup_phase("deferred init");
+        if (profile_startup) {
+            startup_profile_log();
+        }
+    });
+    w.installEventFilter(&firstPaint);
+
+    // Pings are answered once the event loop is running
+    stall_watchdog_start([&a](uint64_t seq) {
+        QMetaObject::invokeMethod(&a, [seq]() {
+            stall_watchdog_pong(seq);
+        }, Qt::QueuedConnection);
+    }, STALL_THRESHOLD_MS);
+    ActivityFilter activity;
+    a.installEventFilter(&activity);
 
     int ret;
     try {
@@ -168,6 +234,16 @@ int main(int argc, char *argv[])
         print_error_system_information();
         ret = 1;
     }
+    stall_watchdog_stop();
+
+#ifdef FFI_STATS
+    ffi_stats_write(FFI_STATS_FILE);
+#endif
+#ifdef FFI_LEDGER
+    ffi_ledger_log();
+    ffi_ledger_report_leaks();
+#endif
+    trace_write(); // Does nothing unless --trace was given
 
     free_config(&config);
     lprintf(LOG_INFO, "Exiting application with status %d...\n", ret);
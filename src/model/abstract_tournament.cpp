@@ -1,6 +1,10 @@
 #include "./abstract_tournament.h"
 #include "../ffi_utils.h"
 #include "../../testing_h/testing.h"
+#include "../async_log.h"
+#include "../ffi_ledger.h"
+#include "../ffi_stats.h"
+#include "../trace.h"
 #include <string.h>
 #include <squire_core/squire_core.h>
 
@@ -11,18 +15,33 @@ static squire_core::sc_AdminId local_aid()
     return id;
 }
 
-Tournament *load_tournament(std::string file_name)
+bool load_tournament_id(std::string file_name, squire_core::sc_TournamentId *ret)
 {
-    squire_core::sc_TournamentId tid = squire_core::load_tournament_from_file(file_name.c_str());
+    TRACE_SPAN("load_tournament", TRACE_CAT_IO);
+    {
+        std::lock_guard<std::mutex> l(ffi_tourns_lock());
+        *ret = SQ_CALL(load_tournament_from_file, file_name.c_str());
+    }
 
-    if (is_null_id(tid._0)) {
+    if (is_null_id(ret->_0)) {
         lprintf(LOG_ERROR, "Cannot load tournament %s - NULL UUID returned due to invalid file\n", file_name.c_str());
-        return nullptr;
-    } else {
-        return new LocalTournament(std::string(file_name), tid);
+        return false;
     }
+    return true;
+}
 
-    return nullptr;
+Tournament *tournament_from_id(std::string file_name, squire_core::sc_TournamentId tid)
+{
+    return new LocalTournament(std::string(file_name), tid);
+}
+
+Tournament *load_tournament(std::string file_name)
+{
+    squire_core::sc_TournamentId tid;
+    if (!load_tournament_id(file_name, &tid)) {
+        return nullptr;
+    }
+    return tournament_from_id(file_name, tid);
 }
 
 Tournament *new_tournament(std::string file,
@@ -37,20 +56,25 @@ Tournament *new_tournament(std::string file,
                            bool require_check_in,
                            bool require_deck_reg)
 {
-    squire_core::sc_TournamentId tid = squire_core::new_tournament_from_settings(file.c_str(),
-                                       name.c_str(),
-                                       format.c_str(),
-                                       preset,
-                                       use_table_number,
-                                       game_size,
-                                       min_deck_count,
-                                       max_deck_count,
-                                       reg_open,
-                                       require_check_in,
-                                       require_deck_reg);
+    TRACE_SPAN("new_tournament", TRACE_CAT_IO);
+    squire_core::sc_TournamentId tid;
+    {
+        std::lock_guard<std::mutex> l(ffi_tourns_lock());
+        tid = SQ_CALL(new_tournament_from_settings, file.c_str(),
+                      name.c_str(),
+                      format.c_str(),
+                      preset,
+                      use_table_number,
+                      game_size,
+                      min_deck_count,
+                      max_deck_count,
+                      reg_open,
+                      require_check_in,
+                      require_deck_reg);
+    }
 
     squire_core::sc_AdminId laid = local_aid();
-    if (!squire_core::tid_add_admin_local(tid, "System User", laid, *(squire_core::sc_UserAccountId *) &laid)) {
+    if (!SQ_CALL(tid_add_admin_local, tid, "System User", laid, *(squire_core::sc_UserAccountId *) &laid)) {
         lprintf(LOG_ERROR, "Cannot add system user\n");
     }
 
@@ -103,14 +127,16 @@ Tournament::~Tournament()
 
 bool Tournament::close()
 {
-    lprintf(LOG_INFO, "Closing tournament %s\n", this->name().c_str());
+    TRACE_SPAN("Tournament::close", TRACE_CAT_MODEL);
+    lprintf(LOG_INFO, "Closing tournament %s\n", this->saveLocation.c_str());
 
     // Warn about unsaved data
     if (!saved) {
-        lprintf(LOG_WARNING, "The tournament '%s' has unsaved data which is now lost\n", this->name().c_str());
+        lprintf(LOG_WARNING, "The tournament %s has unsaved data which is now lost\n", this->saveLocation.c_str());
     }
     emit this->onClose();
-    return squire_core::close_tourn(this->tid);
+    std::lock_guard<std::mutex> l(ffi_tourns_lock());
+    return SQ_CALL(close_tourn, this->tid);
 }
 
 std::string Tournament::save_location()
@@ -127,38 +153,40 @@ squire_core::sc_TournamentId Tournament::id()
 
 std::string Tournament::name()
 {
-    char *name = (char *) squire_core::tid_name(this->tid);
+    char *name = (char *) SQ_CALL(tid_name, this->tid);
     if (name == NULL) {
         lprintf(LOG_ERROR, "Cannot get tournament name\n");
         return "";
     }
+    FFI_LEDGER_ALLOC(name, strlen(name) + 1);
 
     std::string ret = std::string(name);
-    squire_core::sq_free(name, ret.size() + 1);
+    SQ_FREE(name, ret.size() + 1);
     return ret;
 }
 
 bool Tournament::use_table_number()
 {
-    return squire_core::tid_use_table_number(this->tid);
+    return SQ_CALL(tid_use_table_number, this->tid);
 }
 
 std::string Tournament::format()
 {
-    char *format = (char *) squire_core::tid_format(this->tid);
+    char *format = (char *) SQ_CALL(tid_format, this->tid);
     if (format == NULL) {
         lprintf(LOG_ERROR, "Cannot get tournament format\n");
         return "";
     }
+    FFI_LEDGER_ALLOC(format, strlen(format) + 1);
 
     std::string ret = std::string(format);
-    squire_core::sq_free(format, ret.size() + 1);
+    SQ_FREE(format, ret.size() + 1);
     return ret;
 }
 
 int Tournament::game_size()
 {
-    int ret =  squire_core::tid_game_size(this->tid);
+    int ret =  SQ_CALL(tid_game_size, this->tid);
     if (ret == -1) {
         lprintf(LOG_ERROR, "Cannot get tournament game size\n");
     }
@@ -167,7 +195,7 @@ int Tournament::game_size()
 
 int Tournament::min_deck_count()
 {
-    int ret = squire_core::tid_min_deck_count(this->tid);
+    int ret = SQ_CALL(tid_min_deck_count, this->tid);
     if (ret == -1) {
         lprintf(LOG_ERROR, "Cannot get tournament min deck count\n");
     }
@@ -176,7 +204,7 @@ int Tournament::min_deck_count()
 
 int Tournament::max_deck_count()
 {
-    int ret = squire_core::tid_max_deck_count(this->tid);
+    int ret = SQ_CALL(tid_max_deck_count, this->tid);
     if (ret == -1) {
         lprintf(LOG_ERROR, "Cannot get tournament max deck count\n");
     }
@@ -185,13 +213,13 @@ int Tournament::max_deck_count()
 
 squire_core::sc_TournamentPreset Tournament::pairing_type()
 {
-    int ret = squire_core::tid_pairing_type(this->tid);
+    int ret = SQ_CALL(tid_pairing_type, this->tid);
     return squire_core::sc_TournamentPreset(ret);
 }
 
 int Tournament::round_length()
 {
-    int ret = squire_core::tid_round_length(this->tid);
+    int ret = SQ_CALL(tid_round_length, this->tid);
     if (ret == -1) {
         lprintf(LOG_ERROR, "Cannot get tournament round length\n");
     }
@@ -200,27 +228,27 @@ int Tournament::round_length()
 
 bool Tournament::reg_open()
 {
-    return squire_core::tid_reg_open(this->tid);
+    return SQ_CALL(tid_reg_open, this->tid);
 }
 
 bool Tournament::require_check_in()
 {
-    return squire_core::tid_require_check_in(this->tid);
+    return SQ_CALL(tid_require_check_in, this->tid);
 }
 
 bool Tournament::require_deck_reg()
 {
-    return squire_core::tid_require_deck_reg(this->tid);
+    return SQ_CALL(tid_require_deck_reg, this->tid);
 }
 
 squire_core::sc_TournamentStatus Tournament::status()
 {
-    return squire_core::tid_status(this->tid);
+    return SQ_CALL(tid_status, this->tid);
 }
 
 int Tournament::starting_table_number()
 {
-    return squire_core::tid_starting_table_number(this->tid);
+    return SQ_CALL(tid_starting_table_number, this->tid);
 }
 
 std::vector<squire_core::sc_TournamentStatus> Tournament::availableStatusChanges()
@@ -281,8 +309,9 @@ bool Tournament::updateSettings(std::string format,
                                 bool requireCheckIn,
                                 bool requireDeckReg)
 {
+    TRACE_SPAN("Tournament::updateSettings", TRACE_CAT_MODEL);
     squire_core::sc_AdminId laid = this->aid();
-    bool s = squire_core::tid_update_settings(this->tid,
+    bool s = SQ_CALL(tid_update_settings, this->tid,
              format.c_str(),
              startingTableNumber,
              useTableNumber,
@@ -305,11 +334,12 @@ bool Tournament::updateSettings(std::string format,
 
 Player Tournament::addPlayer(std::string name, bool *status)
 {
-    squire_core::sc_PlayerId pid = squire_core::tid_add_player(this->tid, name.c_str());
+    TRACE_SPAN("Tournament::addPlayer", TRACE_CAT_MODEL);
+    squire_core::sc_PlayerId pid = SQ_CALL(tid_add_player, this->tid, name.c_str());
     if (!is_null_id(pid._0)) {
         *status = true;
         Player p = Player(pid, this->tid);
-        lprintf(LOG_INFO, "Added player %s\n", p.name().c_str());
+        lprintf(LOG_INFO, "Added player %s\n", name.c_str());
         this->setSaveStatus(false);
         this->save();
         emit this->onPlayerAdded(p);
@@ -325,84 +355,92 @@ Player Tournament::addPlayer(std::string name, bool *status)
 
 std::vector<Player> Tournament::players()
 {
+    TRACE_SPAN("Tournament::players", TRACE_CAT_MODEL);
     std::vector<Player> players;
-    squire_core::sc_PlayerId *player_ptr = (squire_core::sc_PlayerId *) squire_core::tid_players(this->tid);
+    squire_core::sc_PlayerId *player_ptr = (squire_core::sc_PlayerId *) SQ_CALL(tid_players, this->tid);
     if (player_ptr == NULL) {
         lprintf(LOG_ERROR, "Cannot get tournament players\n");
         return players;
     }
+    FFI_LEDGER_ALLOC(player_ptr, id_array_size(player_ptr));
 
     for (int i = 0; !is_null_id(player_ptr[i]._0); i++) {
         players.push_back(Player(player_ptr[i], this->tid));
     }
-    squire_core::sq_free(player_ptr, (players.size() + 1) * sizeof * player_ptr);
+    SQ_FREE(player_ptr, (players.size() + 1) * sizeof * player_ptr);
 
     return players;
 }
 
 std::vector<PlayerScore> Tournament::standings()
 {
+    TRACE_SPAN("Tournament::standings", TRACE_CAT_MODEL);
     std::vector<PlayerScore> ret;
     squire_core::sc_PlayerScore<squire_core::sc_StandardScore> *standings_ptr =
-        (squire_core::sc_PlayerScore<squire_core::sc_StandardScore> *) squire_core::tid_standings(this->tid);
+        (squire_core::sc_PlayerScore<squire_core::sc_StandardScore> *) SQ_CALL(tid_standings, this->tid);
     if (standings_ptr == NULL) {
         lprintf(LOG_ERROR, "Cannot get tournament standings\n");
         return ret;
     }
+    FFI_LEDGER_ALLOC(standings_ptr, pid_array_size(standings_ptr));
 
-    size_t len = this->players().size();
-    for (size_t i = 0; !is_null_id(standings_ptr[i].pid._0) && i < len; i++) {
+    for (size_t i = 0; !is_null_id(standings_ptr[i].pid._0); i++) {
         ret.push_back(PlayerScore(Player(standings_ptr[i].pid, this->tid), standings_ptr[i].score));
     }
 
-    squire_core::sq_free(standings_ptr, (ret.size() + 1) * sizeof * standings_ptr);
+    SQ_FREE(standings_ptr, (ret.size() + 1) * sizeof * standings_ptr);
 
     return ret;
 }
 
 std::vector<Round> Tournament::rounds()
 {
+    TRACE_SPAN("Tournament::rounds", TRACE_CAT_MODEL);
     std::vector<Round> rounds;
-    squire_core::sc_RoundId *round_ptr = (squire_core::sc_RoundId *) squire_core::tid_rounds(this->tid);
+    squire_core::sc_RoundId *round_ptr = (squire_core::sc_RoundId *) SQ_CALL(tid_rounds, this->tid);
     if (round_ptr == NULL) {
         lprintf(LOG_ERROR, "Cannot get tournament rounds\n");
         return rounds;
     }
+    FFI_LEDGER_ALLOC(round_ptr, id_array_size(round_ptr));
 
     for (int i = 0; !is_null_id(round_ptr[i]._0); i++) {
         rounds.push_back(Round(round_ptr[i], this->tid));
     }
-    squire_core::sq_free(round_ptr, sizeof * round_ptr * (rounds.size() + 1));
+    SQ_FREE(round_ptr, sizeof * round_ptr * (rounds.size() + 1));
 
     return rounds;
 }
 
 std::vector<Round> Tournament::playerRounds(Player player)
 {
+    TRACE_SPAN("Tournament::playerRounds", TRACE_CAT_MODEL);
     std::vector<Round> ret;
-    squire_core::sc_RoundId *rids = (squire_core::sc_RoundId *) squire_core::pid_rounds(player.id(), this->tid);
+    squire_core::sc_RoundId *rids = (squire_core::sc_RoundId *) SQ_CALL(pid_rounds, player.id(), this->tid);
     if (rids == NULL) {
         lprintf(LOG_ERROR, "Cannot get rounds for player\n");
         return ret;
     }
+    FFI_LEDGER_ALLOC(rids, id_array_size(rids));
 
     for (int i = 0; !is_null_id(rids[i]._0); i++) {
         ret.push_back(Round(rids[i], this->tid));
     }
 
-    squire_core::sq_free(rids, sizeof(*rids) * (ret.size() + 1));
+    SQ_FREE(rids, sizeof(*rids) * (ret.size() + 1));
     return ret;
 }
 
 
 bool Tournament::save()
 {
+    TRACE_SPAN("Tournament::save", TRACE_CAT_IO);
     this->setSaveStatus(false);
-    bool ret = squire_core::save_tourn(this->tid, this->saveLocation.c_str());
+    bool ret = SQ_CALL(save_tourn, this->tid, this->saveLocation.c_str());
     if (!ret) {
         lprintf(LOG_ERROR, "Cannot save tournament as %s\n", this->saveLocation.c_str());
     } else {
-        lprintf(LOG_INFO, "Saved %s as %s\n", this->name().c_str(), this->saveLocation.c_str());
+        lprintf(LOG_INFO, "Saved tournament as %s\n", this->saveLocation.c_str());
         this->setSaveStatus(true);
     }
     return ret;
@@ -410,20 +448,22 @@ bool Tournament::save()
 
 std::vector<Round> Tournament::pairRounds()
 {
+    TRACE_SPAN("Tournament::pairRounds", TRACE_CAT_MODEL);
     std::vector<Round> ret = std::vector<Round>();
     squire_core::sc_AdminId laid = this->aid();
-    squire_core::sc_RoundId *rids = (squire_core::sc_RoundId *) squire_core::tid_pair_round(this->tid, laid);
+    squire_core::sc_RoundId *rids = (squire_core::sc_RoundId *) SQ_CALL(tid_pair_round, this->tid, laid);
     if (rids == NULL) {
         lprintf(LOG_ERROR, "Cannot pair rounds\n");
         return ret;
     }
+    FFI_LEDGER_ALLOC(rids, id_array_size(rids));
 
     for (int i = 0; !is_null_id(rids[i]._0); i++) {
         Round rnd = Round(rids[i], this->tid);
         ret.push_back(rnd);
         emit onRoundAdded(rnd);
     }
-    squire_core::sq_free(rids, ret.size() + 1);
+    SQ_FREE(rids, sizeof(*rids) * (ret.size() + 1));
     this->save();
 
     return ret;
@@ -431,8 +471,9 @@ std::vector<Round> Tournament::pairRounds()
 
 bool Tournament::start()
 {
+    TRACE_SPAN("Tournament::start", TRACE_CAT_MODEL);
     squire_core::sc_AdminId laid = this->aid();
-    bool r = squire_core::tid_start(this->tid, laid);
+    bool r = SQ_CALL(tid_start, this->tid, laid);
     emit this->onStatusChanged(this->status());
     this->save();
 
@@ -444,8 +485,9 @@ bool Tournament::start()
 
 bool Tournament::end()
 {
+    TRACE_SPAN("Tournament::end", TRACE_CAT_MODEL);
     squire_core::sc_AdminId laid = this->aid();
-    bool r = squire_core::tid_end(this->tid, laid);
+    bool r = SQ_CALL(tid_end, this->tid, laid);
     emit this->onStatusChanged(this->status());
     this->save();
 
@@ -457,8 +499,9 @@ bool Tournament::end()
 
 bool Tournament::cancel()
 {
+    TRACE_SPAN("Tournament::cancel", TRACE_CAT_MODEL);
     squire_core::sc_AdminId laid = this->aid();
-    bool r = squire_core::tid_cancel(this->tid, laid);
+    bool r = SQ_CALL(tid_cancel, this->tid, laid);
     emit this->onStatusChanged(this->status());
     this->save();
 
@@ -470,8 +513,9 @@ bool Tournament::cancel()
 
 bool Tournament::freeze()
 {
+    TRACE_SPAN("Tournament::freeze", TRACE_CAT_MODEL);
     squire_core::sc_AdminId laid = this->aid();
-    bool r = squire_core::tid_freeze(this->tid, laid);
+    bool r = SQ_CALL(tid_freeze, this->tid, laid);
     emit this->onStatusChanged(this->status());
     this->save();
 
@@ -483,8 +527,9 @@ bool Tournament::freeze()
 
 bool Tournament::thaw()
 {
+    TRACE_SPAN("Tournament::thaw", TRACE_CAT_MODEL);
     squire_core::sc_AdminId laid = this->aid();
-    bool r = squire_core::tid_thaw(this->tid, laid);
+    bool r = SQ_CALL(tid_thaw, this->tid, laid);
     emit this->onStatusChanged(this->status());
     this->save();
 
@@ -507,8 +552,9 @@ bool Tournament::isSaved()
 
 bool Tournament::recordResult(Round round, Player p, int wins)
 {
+    TRACE_SPAN("Tournament::recordResult", TRACE_CAT_MODEL);
     squire_core::sc_AdminId laid = this->aid();
-    bool r = rid_record_result(round.id(), this->tid, laid, p.id(), wins);
+    bool r = SQ_CALL(rid_record_result, round.id(), this->tid, laid, p.id(), wins);
     emit onRoundsChanged(this->rounds()); // TODO: emit something better
     this->save();
 
@@ -521,8 +567,9 @@ bool Tournament::recordResult(Round round, Player p, int wins)
 
 bool Tournament::recordDraws(Round round, int draws)
 {
+    TRACE_SPAN("Tournament::recordDraws", TRACE_CAT_MODEL);
     squire_core::sc_AdminId laid = this->aid();
-    bool r = rid_record_draws(round.id(), this->tid, laid, draws);
+    bool r = SQ_CALL(rid_record_draws, round.id(), this->tid, laid, draws);
     emit onRoundsChanged(this->rounds()); // TODO: emit something better
     this->save();
 
@@ -534,8 +581,9 @@ bool Tournament::recordDraws(Round round, int draws)
 
 bool Tournament::confirmPlayer(Round round, Player p)
 {
+    TRACE_SPAN("Tournament::confirmPlayer", TRACE_CAT_MODEL);
     squire_core::sc_AdminId laid = this->aid();
-    bool r = rid_confirm_player(round.id(), this->tid, laid, p.id());
+    bool r = SQ_CALL(rid_confirm_player, round.id(), this->tid, laid, p.id());
     emit onRoundsChanged(this->rounds());
     this->save();
 
@@ -547,8 +595,9 @@ bool Tournament::confirmPlayer(Round round, Player p)
 
 bool Tournament::killRound(Round round)
 {
+    TRACE_SPAN("Tournament::killRound", TRACE_CAT_MODEL);
     squire_core::sc_AdminId laid = this->aid();
-    bool r = rid_kill(round.id(), this->tid, laid);
+    bool r = SQ_CALL(rid_kill, round.id(), this->tid, laid);
     emit onRoundsChanged(this->rounds());
     this->save();
 
@@ -560,8 +609,9 @@ bool Tournament::killRound(Round round)
 
 bool Tournament::dropPlayer(Player p)
 {
+    TRACE_SPAN("Tournament::dropPlayer", TRACE_CAT_MODEL);
     squire_core::sc_AdminId laid = this->aid();
-    bool r = tid_drop_player(this->tid, p.id(), laid);
+    bool r = SQ_CALL(tid_drop_player, this->tid, p.id(), laid);
     emit this->onPlayersChanged(this->players());
     this->save();
 
@@ -573,6 +623,7 @@ bool Tournament::dropPlayer(Player p)
 
 void Tournament::emitAllProps()
 {
+    TRACE_SPAN("Tournament::emitAllProps", TRACE_CAT_MODEL);
     emit onPlayersChanged(this->players());
     emit onRoundsChanged(this->rounds());
     emit onNameChanged(this->name());
@@ -108,6 +108,10 @@ public:
 
 // Static util methods
 Tournament *load_tournament(std::string file_name);
+// The two halves of load_tournament, the first does not touch Qt so it can run
+// off the GUI thread. The Tournament must be made on the GUI thread.
+bool load_tournament_id(std::string file_name, squire_core::sc_TournamentId *ret);
+Tournament *tournament_from_id(std::string file_name, squire_core::sc_TournamentId tid);
 Tournament *new_tournament(std::string file,
                            std::string name,
                            std::string format,
@@ -1,5 +1,7 @@
 #include "./player.h"
 #include "../utils.h"
+#include "../ffi_ledger.h"
+#include "../ffi_stats.h"
 #include <string.h>
 
 Player::Player()
@@ -26,25 +28,27 @@ Player::~Player()
 
 std::string Player::name()
 {
-    char *name = (char *)squire_core::pid_name(this->pid, this->tid);
+    char *name = (char *)SQ_CALL(pid_name, this->pid, this->tid);
     if (name == NULL) {
         return "";
     }
+    FFI_LEDGER_ALLOC(name, strlen(name) + 1);
 
     std::string ret = std::string(name);
-    squire_core::sq_free(name, ret.size() + 1);
+    SQ_FREE(name, ret.size() + 1);
     return ret;
 }
 
 std::string Player::game_name()
 {
-    char *name = (char *)squire_core::pid_game_name(this->pid, this->tid);
+    char *name = (char *)SQ_CALL(pid_game_name, this->pid, this->tid);
     if (name == NULL) {
         return "";
     }
+    FFI_LEDGER_ALLOC(name, strlen(name) + 1);
 
     std::string ret = std::string(name);
-    squire_core::sq_free(name, ret.size() + 1);
+    SQ_FREE(name, ret.size() + 1);
     return ret;
 }
 
@@ -62,7 +66,7 @@ std::string Player::all_names()
 
 squire_core::sc_PlayerStatus Player::status()
 {
-    return squire_core::pid_status(this->pid, this->tid);
+    return SQ_CALL(pid_status, this->pid, this->tid);
 }
 
 std::string Player::statusAsStr()
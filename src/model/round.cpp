@@ -1,6 +1,8 @@
 #include "./round.h"
 #include "../ffi_utils.h"
-#include "../../testing_h/logger.h"
+#include "../async_log.h"
+#include "../ffi_ledger.h"
+#include "../ffi_stats.h"
 #include <string>
 #include <string.h>
 
@@ -42,22 +44,22 @@ squire_core::sc_TournamentId Round::tourn_id()
 
 squire_core::sc_RoundStatus Round::status()
 {
-    return squire_core::rid_status(this->rid, this->tid);
+    return SQ_CALL(rid_status, this->rid, this->tid);
 }
 
 long Round::time_left()
 {
-    return squire_core::rid_time_left(this->rid, this->tid);
+    return SQ_CALL(rid_time_left, this->rid, this->tid);
 }
 
 long Round::duration()
 {
-    return squire_core::rid_duration(this->rid, this->tid);
+    return SQ_CALL(rid_duration, this->rid, this->tid);
 }
 
 int Round::match_number()
 {
-    return squire_core::rid_match_number(this->rid, this->tid);
+    return SQ_CALL(rid_match_number, this->rid, this->tid);
 }
 
 bool Round::matches(std::string query)
@@ -80,46 +82,48 @@ bool Round::matches(std::string query)
 std::vector<Player> Round::players()
 {
     std::vector<Player> ret;
-    squire_core::sc_PlayerId *player_ptr = (squire_core::sc_PlayerId *) squire_core::rid_players(this->rid, this->tid);
+    squire_core::sc_PlayerId *player_ptr = (squire_core::sc_PlayerId *) SQ_CALL(rid_players, this->rid, this->tid);
 
     if (player_ptr == NULL) {
         return ret;
     }
+    FFI_LEDGER_ALLOC(player_ptr, id_array_size(player_ptr));
 
     for (int i = 0; !is_null_id(player_ptr[i]._0); i++) {
         ret.push_back(Player(player_ptr[i], this->tid));
     }
 
-    squire_core::sq_free(player_ptr, (ret.size() + 1) * sizeof(*player_ptr));
+    SQ_FREE(player_ptr, (ret.size() + 1) * sizeof(*player_ptr));
     return ret;
 }
 
 int Round::resultFor(Player p)
 {
-    return squire_core::rid_result_for(this->rid, this->tid, p.id());
+    return SQ_CALL(rid_result_for, this->rid, this->tid, p.id());
 }
 
 std::vector<Player> Round::confirmed_players()
 {
     std::vector<Player> ret;
-    squire_core::sc_PlayerId *player_ptr = (squire_core::sc_PlayerId *) squire_core::rid_confirmed_players(this->rid, this->tid);
+    squire_core::sc_PlayerId *player_ptr = (squire_core::sc_PlayerId *) SQ_CALL(rid_confirmed_players, this->rid, this->tid);
 
     if (player_ptr == NULL) {
         return ret;
     }
+    FFI_LEDGER_ALLOC(player_ptr, id_array_size(player_ptr));
 
     for (int i = 0; !is_null_id(player_ptr[i]._0); i++) {
         ret.push_back(Player(player_ptr[i], this->tid));
     }
 
-    squire_core::sq_free(player_ptr, (ret.size() + 1) * sizeof(*player_ptr));
+    SQ_FREE(player_ptr, (ret.size() + 1) * sizeof(*player_ptr));
     return ret;
 
 }
 
 int Round::draws()
 {
-    return squire_core::rid_draws(this->rid, this->tid);
+    return SQ_CALL(rid_draws, this->rid, this->tid);
 }
 
 std::string Round::players_as_str()
@@ -192,29 +196,47 @@ bool roundIsActive(Round r)
 
 RoundResults::RoundResults()
 {
-
+    this->drawCount = 0;
 }
 
 RoundResults::RoundResults(Round round)
+{
+    this->refresh(round);
+}
+
+RoundResults::~RoundResults()
+{
+
+}
+
+void RoundResults::refresh(Round round)
 {
     this->round = round;
     this->drawCount = this->round.draws();
-    this->playerWinsMap = std::map<Player, int>();
-    this->confirmsMap = std::map<Player, bool>();
 
+    // clear() keeps the storage for the next round
+    this->results.clear();
     for (Player p : this->round.players()) {
-        this->confirmsMap[p] = false;
-        this->playerWinsMap[p] = this->round.resultFor(p);
+        round_result_t r = {p, this->round.resultFor(p), false};
+        this->results.push_back(r);
     }
 
     for (Player p : this->round.confirmed_players()) {
-        this->confirmsMap[p] = true;
+        round_result_t *r = this->find(p);
+        if (r != NULL) {
+            r->confirmed = true;
+        }
     }
 }
 
-RoundResults::~RoundResults()
+round_result_t *RoundResults::find(Player player)
 {
-
+    for (round_result_t &r : this->results) {
+        if (!(r.player < player) && !(player < r.player)) {
+            return &r;
+        }
+    }
+    return NULL;
 }
 
 int RoundResults::draws()
@@ -224,16 +246,26 @@ int RoundResults::draws()
 
 int RoundResults::resultFor(Player player)
 {
-    return this->playerWinsMap[player];
+    round_result_t *r = this->find(player);
+    return r == NULL ? 0 : r->wins;
 }
 
 bool RoundResults::isConfirmed(Player player)
 {
-    return this->confirmsMap[player];
+    round_result_t *r = this->find(player);
+    return r != NULL && r->confirmed;
+}
+
+std::vector<Player> RoundResults::players()
+{
+    std::vector<Player> ret;
+    for (round_result_t &r : this->results) {
+        ret.push_back(r.player);
+    }
+    return ret;
 }
 
 Round RoundResults::getRound()
 {
     return this->round;
 }
-
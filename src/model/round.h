@@ -35,20 +35,29 @@ int cmpRndMatchNo(const Round &ra, const Round &rb);
 int cmpRndTimeLeft(const Round &ra, const Round &rb);
 int cmpRndPlayers(const Round &ra, const Round &rb);
 
+typedef struct round_result_t {
+    Player player;
+    int wins;
+    bool confirmed;
+} round_result_t;
+
+// The results of a round are read once and, can be refreshed in place when the
+// round changes, rounds only have a handful of players so a vector is searched
 class RoundResults
 {
 public:
     RoundResults();
     RoundResults(Round round);
     ~RoundResults();
+    void refresh(Round round);
     int draws();
     int resultFor(Player player);
     bool isConfirmed(Player player);
+    std::vector<Player> players();
     Round getRound();
 private:
-    std::map<Player, int> playerWinsMap;
-    std::map<Player, bool> confirmsMap;
+    round_result_t *find(Player player);
+    std::vector<round_result_t> results;
     int drawCount;
     Round round;
 };
-
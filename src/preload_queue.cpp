@@ -0,0 +1,277 @@
+#include "./preload_queue.h"
+#include "./async_log.h"
+#include "./trace.h"
+#include <sys/stat.h>
+#include <algorithm>
+#include <vector>
+
+static void stamp_file(const std::string &path, long long *file_size, long long *mtime)
+{
+    struct stat stat_ret;
+    if (stat(path.c_str(), &stat_ret) != 0) {
+        *file_size = -1;
+        *mtime = -1;
+        return;
+    }
+    *file_size = stat_ret.st_size;
+    *mtime = stat_ret.st_mtime;
+}
+
+// True if the file has not been changed since r was loaded
+static bool is_fresh(const preload_result_t &r)
+{
+    long long file_size, mtime;
+    stamp_file(r.path, &file_size, &mtime);
+    return file_size == r.file_size && mtime == r.mtime;
+}
+
+static std::list<preload_result_t>::iterator find_ready(preload_queue_t *q, const std::string &path)
+{
+    return std::find_if(q->ready.begin(), q->ready.end(), [&path](const preload_result_t &r) {
+        return r.path == path;
+    });
+}
+
+// While paused only the loads that preload_take is waiting on are run
+static std::deque<std::string>::iterator next_job(preload_queue_t *q)
+{
+    if (!q->paused) {
+        return q->jobs.begin();
+    }
+    return std::find_if(q->jobs.begin(), q->jobs.end(), [q](const std::string &path) {
+        return std::find(q->taking.begin(), q->taking.end(), path) != q->taking.end();
+    });
+}
+
+static void preload_main(preload_queue_t *q)
+{
+    trace_set_thread_name("preload");
+    std::unique_lock<std::mutex> l(q->lock);
+    while (true) {
+        q->cond.wait(l, [q]() {
+            return !q->running || next_job(q) != q->jobs.end();
+        });
+        if (!q->running) {
+            break;
+        }
+
+        auto job = next_job(q);
+        std::string path = *job;
+        q->jobs.erase(job);
+        q->loading = path;
+        l.unlock();
+
+        // Stamped before the load so a write during it is seen as a change
+        long long file_size, mtime;
+        stamp_file(path, &file_size, &mtime);
+
+        void *result;
+        {
+            TRACE_SPAN("preload", TRACE_CAT_IO);
+            result = q->load(path);
+        }
+        if (result == NULL) {
+            lprintf(LOG_WARNING, "Cannot preload %s\n", path.c_str());
+        }
+
+        // Evicted results are freed before this one can be taken so that
+        // freeing never runs at the same time as whoever takes it
+        std::vector<void *> evicted;
+        l.lock();
+        size_t unpinned = std::count_if(q->ready.begin(), q->ready.end(), [](const preload_result_t &r) {
+            return !r.pinned;
+        });
+        if (q->waiting.find(path) == q->waiting.end()) {
+            unpinned++;
+        }
+        for (auto it = q->ready.begin(); it != q->ready.end() && unpinned > q->max_ready;) {
+            if (it->pinned) {
+                it++;
+                continue;
+            }
+
+            evicted.push_back(it->result);
+            it = q->ready.erase(it);
+            unpinned--;
+        }
+
+        if (!evicted.empty()) {
+            l.unlock();
+            for (void *r : evicted) {
+                if (r != NULL) {
+                    q->free(r);
+                }
+            }
+            l.lock();
+        }
+
+        // done is called outside of the lock
+        preload_done_t done = nullptr;
+        auto w = q->waiting.find(path);
+        if (w != q->waiting.end()) {
+            done = w->second;
+            q->waiting.erase(w);
+        }
+        q->loading = "";
+        q->ready.push_back({path, result, done != nullptr, file_size, mtime});
+        q->cond.notify_all();
+
+        if (done != nullptr) {
+            l.unlock();
+            done(path);
+            l.lock();
+        }
+    }
+}
+
+void preload_queue_init(preload_queue_t *q, preload_load_t load, preload_free_t free, size_t max_ready)
+{
+    q->load = load;
+    q->free = free;
+    q->max_ready = std::max((size_t) 1, max_ready);
+    q->running = true;
+    q->paused = false;
+    q->loading = "";
+    q->worker = std::thread(&preload_main, q);
+}
+
+void preload_queue_free(preload_queue_t *q)
+{
+    {
+        std::lock_guard<std::mutex> l(q->lock);
+        q->running = false;
+        q->jobs.clear();
+        q->waiting.clear();
+    }
+    q->cond.notify_all();
+    if (q->worker.joinable()) {
+        q->worker.join();
+    }
+
+    for (preload_result_t &r : q->ready) {
+        if (r.result != NULL) {
+            q->free(r.result);
+        }
+    }
+    q->ready.clear();
+}
+
+void preload_request(preload_queue_t *q, std::string path)
+{
+    {
+        std::lock_guard<std::mutex> l(q->lock);
+        if (!q->running
+            || q->loading == path
+            || find_ready(q, path) != q->ready.end()
+            || std::find(q->jobs.begin(), q->jobs.end(), path) != q->jobs.end()) {
+            return;
+        }
+        q->jobs.push_back(path);
+    }
+    q->cond.notify_all();
+}
+
+void preload_request_notify(preload_queue_t *q, std::string path, preload_done_t done)
+{
+    std::unique_lock<std::mutex> l(q->lock);
+    if (!q->running) {
+        return;
+    }
+
+    auto it = find_ready(q, path);
+    if (it != q->ready.end()) {
+        it->pinned = true;
+        l.unlock();
+        done(path);
+        return;
+    }
+
+    q->waiting[path] = done;
+    if (q->loading != path && std::find(q->jobs.begin(), q->jobs.end(), path) == q->jobs.end()) {
+        q->jobs.push_back(path);
+    }
+    l.unlock();
+    q->cond.notify_all();
+}
+
+static void end_take(preload_queue_t *q, const std::string &path)
+{
+    auto it = std::find(q->taking.begin(), q->taking.end(), path);
+    if (it != q->taking.end()) {
+        q->taking.erase(it);
+    }
+}
+
+void *preload_take(preload_queue_t *q, std::string path)
+{
+    std::unique_lock<std::mutex> l(q->lock);
+    while (true) {
+        if (!q->running) {
+            return NULL;
+        }
+
+        auto it = find_ready(q, path);
+        if (it == q->ready.end() && q->loading != path) {
+            // Load it next
+            auto job = std::find(q->jobs.begin(), q->jobs.end(), path);
+            if (job != q->jobs.end()) {
+                q->jobs.erase(job);
+            }
+            q->jobs.push_front(path);
+        }
+        q->taking.push_back(path);
+        q->cond.notify_all();
+
+        q->cond.wait(l, [q, &path, &it]() {
+            it = find_ready(q, path);
+            return !q->running || it != q->ready.end();
+        });
+        end_take(q, path);
+        if (it == q->ready.end()) {
+            return NULL;
+        }
+
+        preload_result_t r = *it;
+        q->ready.erase(it);
+        l.unlock();
+        if (is_fresh(r)) {
+            return r.result;
+        }
+
+        // It was saved since it was loaded so, the copy would overwrite it
+        lprintf(LOG_INFO, "Preloaded %s is stale, reloading\n", path.c_str());
+        if (r.result != NULL) {
+            q->free(r.result);
+        }
+        l.lock();
+    }
+}
+
+void preload_queue_pause(preload_queue_t *q, bool paused)
+{
+    {
+        std::lock_guard<std::mutex> l(q->lock);
+        q->paused = paused;
+    }
+    q->cond.notify_all();
+}
+
+void preload_invalidate(preload_queue_t *q, std::string path)
+{
+    void *result = NULL;
+    {
+        // Queued loads have not read the file yet and, pinned results are
+        // still checked when they are taken
+        std::lock_guard<std::mutex> l(q->lock);
+        auto it = find_ready(q, path);
+        if (it == q->ready.end() || it->pinned) {
+            return;
+        }
+        result = it->result;
+        q->ready.erase(it);
+    }
+
+    if (result != NULL) {
+        q->free(result);
+    }
+}
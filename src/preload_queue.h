@@ -0,0 +1,77 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Loads files on one worker thread ahead of them being opened. Every load goes
+ * through the worker so that the loader is never run twice at once, opening a
+ * file that was not preloaded jumps the queue and, waits for it. Up to
+ * max_ready results that have not been taken are kept, the oldest is freed
+ * when another finishes. Results that were requested with a done callback are
+ * kept until they are taken. A result is reloaded when it is taken if the
+ * file's size or, mtime has changed since it was loaded. While the queue is
+ * paused the worker only loads files that preload_take is waiting on, so that
+ * nothing is loaded while the caller may be using the loader's library.
+ * */
+
+#define PRELOAD_MAX_READY 2
+
+// Runs on the worker, returns NULL if the file cannot be loaded
+typedef std::function<void *(const std::string &path)> preload_load_t;
+// Frees a result that was never taken
+typedef std::function<void(void *result)> preload_free_t;
+// Called once path can be taken without waiting
+typedef std::function<void(const std::string &path)> preload_done_t;
+
+typedef struct preload_result_t {
+    std::string path;
+    void *result;
+    bool pinned; // Not evicted
+    long long file_size; // -1 if the file could not be stat'd before it was loaded
+    long long mtime;
+} preload_result_t;
+
+typedef struct preload_queue_t {
+    std::mutex lock;
+    std::condition_variable cond;
+    std::thread worker;
+    std::deque<std::string> jobs;
+    std::list<preload_result_t> ready; // Oldest first
+    std::string loading; // Empty when idle
+    std::unordered_map<std::string, preload_done_t> waiting; // Path -> done callback
+    std::vector<std::string> taking; // Paths that preload_take is waiting on
+    preload_load_t load;
+    preload_free_t free;
+    size_t max_ready;
+    bool running;
+    bool paused;
+} preload_queue_t;
+
+void preload_queue_init(preload_queue_t *q, preload_load_t load, preload_free_t free, size_t max_ready);
+void preload_queue_free(preload_queue_t *q); // Stops the worker and, frees the unclaimed results
+
+// Queues a speculative load, nothing happens if path is queued or, loaded already
+void preload_request(preload_queue_t *q, std::string path);
+
+// As above but, the result is kept until it is taken and done is called on the
+// worker once it is loaded. done is called at once if it was already loaded.
+void preload_request_notify(preload_queue_t *q, std::string path, preload_done_t done);
+
+// Returns the result for path, loading it first if it has not been. The result
+// belongs to the caller afterwards, NULL is returned if it cannot be loaded.
+void *preload_take(preload_queue_t *q, std::string path);
+
+// Queued loads wait while paused unless they are being taken, a load that has
+// started is not stopped
+void preload_queue_pause(preload_queue_t *q, bool paused);
+
+// Frees the unclaimed result for path, call this once something other than the
+// queue has written to the file
+void preload_invalidate(preload_queue_t *q, std::string path);
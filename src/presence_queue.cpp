@@ -0,0 +1,65 @@
+#include "./presence_queue.h"
+#include <chrono>
+
+void presence_queue_push(presence_queue_t *q, std::string txt)
+{
+    {
+        std::lock_guard<std::mutex> l(q->lock);
+        q->txt = txt;
+        q->has_txt = true;
+    }
+    q->cond.notify_all();
+}
+
+void presence_queue_stop(presence_queue_t *q)
+{
+    {
+        std::lock_guard<std::mutex> l(q->lock);
+        q->running = false;
+    }
+    q->cond.notify_all();
+}
+
+bool presence_queue_wait(presence_queue_t *q, std::string *txt, int timeout_ms)
+{
+    std::unique_lock<std::mutex> l(q->lock);
+    q->cond.wait_for(l, std::chrono::milliseconds(timeout_ms), [q]() {
+        return q->has_txt || !q->running;
+    });
+
+    if (!q->running || !q->has_txt) {
+        return false;
+    }
+
+    *txt = q->txt;
+    q->has_txt = false;
+    return true;
+}
+
+bool presence_queue_running(presence_queue_t *q)
+{
+    std::lock_guard<std::mutex> l(q->lock);
+    return q->running;
+}
+
+int presence_backoff_ms(int failures)
+{
+    long long ret = PRESENCE_BACKOFF_MIN_MS;
+    for (int i = 1; i < failures && ret < PRESENCE_BACKOFF_MAX_MS; i++) {
+        ret *= 2;
+    }
+    return ret < PRESENCE_BACKOFF_MAX_MS ? ret : PRESENCE_BACKOFF_MAX_MS;
+}
+
+int presence_pump_interval_ms(int last_ms, bool active)
+{
+    if (active) {
+        return PRESENCE_PUMP_MIN_MS;
+    }
+
+    int ret = last_ms * 2;
+    if (ret < PRESENCE_PUMP_MIN_MS) {
+        return PRESENCE_PUMP_MIN_MS;
+    }
+    return ret < PRESENCE_PUMP_MAX_MS ? ret : PRESENCE_PUMP_MAX_MS;
+}
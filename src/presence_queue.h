@@ -0,0 +1,39 @@
+#pragma once
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+/*
+ * Hands Discord presence text from the GUI to the Discord thread, only the
+ * newest text is kept as older ones would be overwritten straight away. The
+ * thread sleeps on the condition variable so it only wakes for new text, a
+ * pump or, a retry.
+ * */
+
+#define PRESENCE_BACKOFF_MIN_MS 1000
+#define PRESENCE_BACKOFF_MAX_MS (5 * 60 * 1000)
+#define PRESENCE_PUMP_MIN_MS 100 // Straight after an update
+#define PRESENCE_PUMP_MAX_MS 5000 // Once idle
+
+typedef struct presence_queue_t {
+    std::mutex lock;
+    std::condition_variable cond;
+    std::string txt;
+    bool has_txt = false;
+    bool running = true;
+} presence_queue_t;
+
+void presence_queue_push(presence_queue_t *q, std::string txt);
+void presence_queue_stop(presence_queue_t *q);
+
+// Waits up to timeout_ms for new text, returns false on a timeout or, once the
+// queue is stopped (see presence_queue_running).
+bool presence_queue_wait(presence_queue_t *q, std::string *txt, int timeout_ms);
+bool presence_queue_running(presence_queue_t *q);
+
+// Time to wait after the given number of failed connection attempts
+int presence_backoff_ms(int failures);
+
+// The next interval between run_callbacks calls, it is reset by activity and,
+// doubles while idle.
+int presence_pump_interval_ms(int last_ms, bool active);
@@ -0,0 +1,180 @@
+#include "./rng_job.h"
+#include "./async_log.h"
+#include "./trace.h"
+#include <algorithm>
+#include <chrono>
+
+static bool due(std::chrono::steady_clock::time_point *last)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - *last < std::chrono::milliseconds(RNG_JOB_REPORT_MS)) {
+        return false;
+    }
+
+    *last = now;
+    return true;
+}
+
+static rng_progress_t progress(long long done, long long total, bool finished)
+{
+    rng_progress_t ret;
+    ret.done = done;
+    ret.total = total;
+    ret.heads = 0;
+    ret.finished = finished;
+    return ret;
+}
+
+static void coins_main(rng_job_t *job, long long coins, bool krark, rng_report_t report)
+{
+    trace_set_thread_name("rng job");
+    TRACE_SPAN("rng_job_flip_coins", TRACE_CAT_MODEL);
+
+    long long done = 0;
+    long long heads = 0;
+    std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+    while (done < coins && !job->cancelled) {
+        int n = (int) std::min((long long) RNG_JOB_COIN_CHUNK, coins - done);
+        heads += krark ? flip_krark_coins(n) : flip_coins(n);
+        done += n;
+
+        if (done < coins && due(&last)) {
+            rng_progress_t p = progress(done, coins, false);
+            p.heads = heads;
+            report(p);
+        }
+    }
+
+    rng_progress_t p = progress(done, coins, true);
+    p.heads = heads;
+    job->running = false;
+    report(p);
+}
+
+static void dice_main(rng_job_t *job, dice_roll_ret_t ret, long long number, rng_report_t report)
+{
+    trace_set_thread_name("rng job");
+    TRACE_SPAN("rng_job_roll_dice", TRACE_CAT_MODEL);
+
+    std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+    while (ret.dice_rolled < number && !job->cancelled) {
+        roll_dice_into(&ret, std::min((long long) RNG_JOB_DICE_CHUNK, number - ret.dice_rolled));
+
+        if (ret.dice_rolled < number && due(&last)) {
+            rng_progress_t p = progress(ret.dice_rolled, number, false);
+            p.faces.assign(ret.results, ret.results + ret.sides);
+            report(p);
+        }
+    }
+
+    rng_progress_t p = progress(ret.dice_rolled, number, true);
+    p.faces.assign(ret.results, ret.results + ret.sides);
+
+    // Kept by the job as the report may never be handled
+    if (job->cancelled) {
+        free_dice_roll_ret(ret);
+    } else {
+        job->dice = ret;
+    }
+
+    job->running = false;
+    report(p);
+}
+
+static void free_dice(rng_job_t *job)
+{
+    if (job->dice.results != NULL) {
+        free_dice_roll_ret(job->dice);
+    }
+    job->dice.dice_rolled = 0;
+    job->dice.sides = 0;
+    job->dice.results = NULL;
+}
+
+void rng_job_init(rng_job_t *job)
+{
+    job->cancelled = false;
+    job->running = false;
+    job->dice.results = NULL;
+    free_dice(job);
+}
+
+// The last job has reported that it finished but, may not have returned yet
+static bool start(rng_job_t *job)
+{
+    if (job->running) {
+        lprintf(LOG_ERROR, "An RNG job is already running\n");
+        return false;
+    }
+
+    if (job->worker.joinable()) {
+        job->worker.join();
+    }
+    free_dice(job);
+    job->cancelled = false;
+    job->running = true;
+    return true;
+}
+
+bool rng_job_flip_coins(rng_job_t *job, long long coins, bool krark, rng_report_t report)
+{
+    if (coins < 0 || !start(job)) {
+        return false;
+    }
+
+    job->worker = std::thread(&coins_main, job, coins, krark, report);
+    return true;
+}
+
+bool rng_job_roll_dice(rng_job_t *job, int sides, long long number, rng_report_t report)
+{
+    if (sides <= 0 || number < 0 || job->running) {
+        return false;
+    }
+
+    int status;
+    dice_roll_ret_t ret = new_dice_roll_ret(sides, &status);
+    if (!status) {
+        return false;
+    }
+
+    if (!start(job)) {
+        free_dice_roll_ret(ret);
+        return false;
+    }
+
+    job->worker = std::thread(&dice_main, job, ret, number, report);
+    return true;
+}
+
+bool rng_job_running(rng_job_t *job)
+{
+    return job->running;
+}
+
+void rng_job_cancel(rng_job_t *job)
+{
+    job->cancelled = true;
+    rng_job_wait(job);
+    free_dice(job);
+}
+
+void rng_job_wait(rng_job_t *job)
+{
+    if (job->worker.joinable()) {
+        job->worker.join();
+    }
+}
+
+bool rng_job_take_dice(rng_job_t *job, dice_roll_ret_t *ret)
+{
+    rng_job_wait(job);
+    if (job->dice.results == NULL) {
+        return false;
+    }
+
+    *ret = job->dice;
+    job->dice.results = NULL;
+    free_dice(job);
+    return true;
+}
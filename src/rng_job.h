@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "./coins.h"
+
+/*
+ * Runs a coin flip or, dice roll on a worker thread in chunks so that it can
+ * be cancelled between them and, report how far it has got. Reports are made
+ * on the worker at most every RNG_JOB_REPORT_MS, the last one is always made.
+ * A finished dice roll is kept by the job until it is taken so that it is
+ * still freed if the report is never handled.
+ * */
+
+#define RNG_JOB_COIN_CHUNK (1 << 24)
+#define RNG_JOB_DICE_CHUNK (1 << 20)
+#define RNG_JOB_REPORT_MS 50
+
+typedef struct rng_progress_t {
+    long long done;
+    long long total;
+    long long heads; // Coin jobs only
+    // Dice jobs only, a copy of the distribution so far. It is a copy so that a
+    // report that is never handled leaks nothing, the last roll is taken with
+    // rng_job_take_dice.
+    std::vector<dice_roll_res_line_t> faces;
+    bool finished; // The last report, done is short of total if it was cancelled
+} rng_progress_t;
+
+typedef std::function<void(rng_progress_t progress)> rng_report_t;
+
+typedef struct rng_job_t {
+    std::thread worker;
+    std::atomic<bool> cancelled;
+    std::atomic<bool> running;
+    dice_roll_ret_t dice; // The last roll that was not cancelled, results is NULL once it is taken
+} rng_job_t;
+
+void rng_job_init(rng_job_t *job);
+
+// These return false if a job is already running or, it cannot be started
+bool rng_job_flip_coins(rng_job_t *job, long long coins, bool krark, rng_report_t report);
+bool rng_job_roll_dice(rng_job_t *job, int sides, long long number, rng_report_t report);
+
+bool rng_job_running(rng_job_t *job);
+// Returns once the worker has stopped and, frees the roll if it was not taken
+void rng_job_cancel(rng_job_t *job);
+void rng_job_wait(rng_job_t *job);
+
+// Moves the finished roll to ret, which must be freed with free_dice_roll_ret.
+// Call it after the last report, false is returned if there is no roll.
+bool rng_job_take_dice(rng_job_t *job, dice_roll_ret_t *ret);
@@ -0,0 +1,172 @@
+#include <math.h>
+#include "./rng_stats.h"
+
+#define GAMMA_MAX_ITERATIONS 1000
+#define GAMMA_EPSILON 1e-15
+#define GAMMA_FP_MIN 1e-300
+#define RUNS_MIN_COUNT 10
+
+double chi_square_stat(const double *observed, const double *expected, size_t n)
+{
+    double ret = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (expected[i] <= 0) {
+            continue;
+        }
+
+        double diff = observed[i] - expected[i];
+        ret += diff * diff / expected[i];
+    }
+    return ret;
+}
+
+// Lower regularised gamma P(a, x) by its series, converges for x < a + 1
+static double gamma_p_series(double a, double x)
+{
+    double ap = a;
+    double sum = 1.0 / a;
+    double del = sum;
+    for (int i = 0; i < GAMMA_MAX_ITERATIONS; i++) {
+        ap++;
+        del *= x / ap;
+        sum += del;
+        if (fabs(del) < fabs(sum) * GAMMA_EPSILON) {
+            break;
+        }
+    }
+    return sum * exp(-x + a * log(x) - lgamma(a));
+}
+
+// Upper regularised gamma Q(a, x) by Lentz's continued fraction, for x >= a + 1
+static double gamma_q_continued_fraction(double a, double x)
+{
+    double b = x + 1.0 - a;
+    double c = 1.0 / GAMMA_FP_MIN;
+    double d = 1.0 / b;
+    double h = d;
+    for (int i = 1; i <= GAMMA_MAX_ITERATIONS; i++) {
+        double an = -i * (i - a);
+        b += 2.0;
+        d = an * d + b;
+        if (fabs(d) < GAMMA_FP_MIN) {
+            d = GAMMA_FP_MIN;
+        }
+
+        c = b + an / c;
+        if (fabs(c) < GAMMA_FP_MIN) {
+            c = GAMMA_FP_MIN;
+        }
+
+        d = 1.0 / d;
+        double del = d * c;
+        h *= del;
+        if (fabs(del - 1.0) < GAMMA_EPSILON) {
+            break;
+        }
+    }
+    return exp(-x + a * log(x) - lgamma(a)) * h;
+}
+
+double chi_square_p_value(double chi_sq, int dof)
+{
+    if (dof <= 0 || chi_sq < 0 || isnan(chi_sq)) {
+        return RNG_STATS_NOT_APPLICABLE;
+    }
+
+    if (chi_sq == 0) {
+        return 1.0;
+    }
+
+    double a = dof / 2.0;
+    double x = chi_sq / 2.0;
+    if (x < a + 1.0) {
+        return 1.0 - gamma_p_series(a, x);
+    }
+    return gamma_q_continued_fraction(a, x);
+}
+
+double dice_chi_square(dice_roll_ret_t ret, int *dof)
+{
+    *dof = ret.sides - 1;
+    if (ret.results == NULL || ret.sides <= 0) {
+        return 0;
+    }
+
+    double expected = ((double) ret.dice_rolled) / ret.sides;
+    double chi_sq = 0;
+    for (int i = 0; i < ret.sides; i++) {
+        double diff = ret.results[i].number_rolled - expected;
+        chi_sq += diff * diff / expected;
+    }
+    return chi_sq;
+}
+
+dice_stats_t dice_roll_stats(dice_roll_ret_t ret)
+{
+    dice_stats_t s;
+    s.mean = 0;
+    s.variance = 0;
+    s.chi_sq = 0;
+    s.dof = ret.sides - 1;
+    s.max_rolled = 0;
+    s.expected_mean = (ret.sides + 1) / 2.0;
+    s.expected_variance = (((double) ret.sides) * ret.sides - 1) / 12.0;
+    s.p_value = RNG_STATS_NOT_APPLICABLE;
+    if (ret.results == NULL || ret.sides <= 0 || ret.dice_rolled <= 0) {
+        return s;
+    }
+
+    double expected = ((double) ret.dice_rolled) / ret.sides;
+    double sum = 0;
+    double sum_sq = 0;
+    for (int i = 0; i < ret.sides; i++) {
+        double side = ret.results[i].side_number;
+        double count = ret.results[i].number_rolled;
+        sum += side * count;
+        sum_sq += side * side * count;
+
+        double diff = count - expected;
+        s.chi_sq += diff * diff / expected;
+        if (ret.results[i].number_rolled > s.max_rolled) {
+            s.max_rolled = ret.results[i].number_rolled;
+        }
+    }
+
+    s.mean = sum / ret.dice_rolled;
+    s.variance = sum_sq / ret.dice_rolled - s.mean * s.mean;
+    if (s.variance < 0) {
+        s.variance = 0; // Rounding when every roll is the same side
+    }
+    s.p_value = chi_square_p_value(s.chi_sq, s.dof);
+    return s;
+}
+
+double runs_test_p_value(const bool *seq, size_t n)
+{
+    if (seq == NULL || n == 0) {
+        return RNG_STATS_NOT_APPLICABLE;
+    }
+
+    double ones = 0;
+    double runs = 1;
+    for (size_t i = 0; i < n; i++) {
+        if (seq[i]) {
+            ones++;
+        }
+
+        if (i > 0 && seq[i] != seq[i - 1]) {
+            runs++;
+        }
+    }
+
+    double zeros = n - ones;
+    if (ones < RUNS_MIN_COUNT || zeros < RUNS_MIN_COUNT) {
+        return RNG_STATS_NOT_APPLICABLE;
+    }
+
+    double mean = 2.0 * ones * zeros / n + 1.0;
+    double variance = (mean - 1.0) * (mean - 2.0) / (n - 1.0);
+    double z = (runs - mean) / sqrt(variance);
+    return erfc(fabs(z) / sqrt(2.0));
+}
+
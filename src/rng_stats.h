@@ -0,0 +1,38 @@
+#pragma once
+#include <stddef.h>
+#include "./coins.h"
+
+// Statistical checks for the RNG utilities, these are used by the RNG benchmark
+// and, tests to make sure that faster kernels do not break the distribution.
+
+#define RNG_STATS_NOT_APPLICABLE -1.0
+
+// Pearson's chi-square statistic for observed counts against expected counts
+double chi_square_stat(const double *observed, const double *expected, size_t n);
+
+// Probability of a chi-square statistic at least this large with dof degrees of freedom
+// Returns RNG_STATS_NOT_APPLICABLE for invalid input
+double chi_square_p_value(double chi_sq, int dof);
+
+// Chi-square statistic of a dice roll against a fair die, dof is set to sides - 1
+double dice_chi_square(dice_roll_ret_t ret, int *dof);
+
+// Summary of a dice roll, the expected values are those of a fair die
+typedef struct dice_stats_t {
+    double mean;
+    double variance;
+    double expected_mean;
+    double expected_variance;
+    double chi_sq;
+    int dof;
+    double p_value; // RNG_STATS_NOT_APPLICABLE when dof is not positive
+    long long max_rolled; // The largest count of any side
+} dice_stats_t;
+
+// Computes every statistic in one pass over the results
+dice_stats_t dice_roll_stats(dice_roll_ret_t ret);
+
+// Wald-Wolfowitz runs test on a binary sequence, the p value is two sided
+// Returns RNG_STATS_NOT_APPLICABLE when either value occurs fewer than 10 times
+double runs_test_p_value(const bool *seq, size_t n);
+
@@ -0,0 +1,79 @@
+#include "./session.h"
+#include "./config.h"
+#include "./async_log.h"
+#include "./utils.h"
+#include <nlohmann/json.hpp>
+
+bool read_session(FILE *f, session_t *ret)
+{
+    ret->tourns.clear();
+    ret->current = -1;
+
+    file_view_t view;
+    if (!map_file(f, &view)) {
+        return false;
+    }
+
+    bool r = true;
+    try {
+        nlohmann::json j = nlohmann::json::parse(view.data, view.data + view.size);
+        for (nlohmann::json &entry : j.at(SESSION_TOURNS)) {
+            session_tourn_t t;
+            entry.at(SESSION_PATH).get_to(t.file_path);
+            entry.at(SESSION_ROUND).get_to(t.round_number);
+            entry.at(SESSION_PLAYER).get_to(t.player_name);
+            ret->tourns.push_back(t);
+        }
+
+        j.at(SESSION_CURRENT).get_to(ret->current);
+        if (ret->current < -1 || ret->current >= (int) ret->tourns.size()) {
+            ret->current = -1;
+        }
+    } catch (std::exception &e) {
+        lprintf(LOG_WARNING, "Cannot parse the session - %s\n", e.what());
+        ret->tourns.clear();
+        ret->current = -1;
+        r = false;
+    }
+
+    unmap_file(&view);
+    return r;
+}
+
+bool write_session(session_t *s, FILE *f)
+{
+    nlohmann::json arr = nlohmann::json::array();
+    for (session_tourn_t &t : s->tourns) {
+        nlohmann::json entry;
+        entry[SESSION_PATH] = t.file_path;
+        entry[SESSION_ROUND] = t.round_number;
+        entry[SESSION_PLAYER] = t.player_name;
+        arr.push_back(entry);
+    }
+
+    nlohmann::json ret;
+    ret[CONFIG_VERSION] = std::string(VERSION);
+    ret[SESSION_TOURNS] = arr;
+    ret[SESSION_CURRENT] = s->current;
+
+    std::string output = ret.dump();
+    int num = fprintf(f, "%s", output.c_str());
+    int flush_status = fflush(f);
+
+    return ((size_t) num) == output.size() && flush_status == 0;
+}
+
+bool save_session(session_t *s, const char *path)
+{
+    atomic_file_t af;
+    if (!atomic_file_open(&af, path)) {
+        return false;
+    }
+
+    if (!write_session(s, af.f)) {
+        lprintf(LOG_ERROR, "Cannot write session to %s\n", af.tmp_path);
+        atomic_file_abort(&af);
+        return false;
+    }
+    return atomic_file_commit(&af);
+}
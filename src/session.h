@@ -0,0 +1,36 @@
+#pragma once
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/*
+ * The tournaments that were open when the app was closed, they are opened
+ * again at the next start. Rounds are kept by match number and, players by
+ * name as the ids are not worth writing out.
+ * */
+
+#define SESSION_FILE "session.json"
+
+typedef struct session_tourn_t {
+    std::string file_path;
+    int round_number; // -1 when no round was selected
+    std::string player_name; // Empty when no player was selected
+} session_tourn_t;
+
+typedef struct session_t {
+    std::vector<session_tourn_t> tourns; // In tab order
+    int current; // Index of the tab in front, -1 for a tab that is not a tournament
+} session_t;
+
+// Json tags
+#define SESSION_TOURNS "tournaments"
+#define SESSION_CURRENT "current"
+#define SESSION_PATH "path"
+#define SESSION_ROUND "round"
+#define SESSION_PLAYER "player"
+
+// An empty session is returned if it cannot be read
+bool read_session(FILE *f, session_t *ret);
+bool write_session(session_t *s, FILE *f);
+// Writes the session to a temporary file then, renames it over path
+bool save_session(session_t *s, const char *path);
@@ -0,0 +1,267 @@
+#include "./stall_watchdog.h"
+#include "./async_log.h"
+#include "./trace.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#ifdef USE_BACKTRACE
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+
+#define STALL_SAMPLE_SIGNAL SIGUSR2
+#define STALL_SAMPLE_WAIT_MS 50
+#endif
+
+static std::mutex watchdog_lock;
+static std::condition_variable watchdog_cond;
+static std::thread watchdog;
+static bool running = false;
+static stall_post_t post_ping;
+static int threshold = STALL_THRESHOLD_MS;
+static uint64_t ping_seq = 0;
+static uint64_t pong_seq = 0;
+static int ping_interval = STALL_PING_INTERVAL_MS;
+static bool activity = false;
+static std::atomic<bool> backed_off(false);
+static std::atomic<const char *> *watched_span = NULL;
+static std::atomic<int64_t> *watched_span_start = NULL;
+static std::chrono::steady_clock::time_point last_pong;
+
+static std::mutex stats_lock;
+static std::map<std::string, stall_stats_t> stats;
+
+#ifdef USE_BACKTRACE
+static pthread_t watched_thread;
+static void *sample_frames[STALL_BACKTRACE_FRAMES];
+static int sample_size = 0;
+static int sample_ready = 0;
+
+static void sample_handler(int sig)
+{
+    (void) sig;
+    int size = backtrace(sample_frames, STALL_BACKTRACE_FRAMES);
+    __atomic_store_n(&sample_size, size, __ATOMIC_RELAXED);
+    __atomic_store_n(&sample_ready, 1, __ATOMIC_RELEASE);
+}
+
+static void init_sampling()
+{
+    watched_thread = pthread_self();
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = &sample_handler;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(STALL_SAMPLE_SIGNAL, &sa, NULL);
+
+    // The first call to backtrace loads libgcc, that cannot happen in the handler
+    void *frame;
+    backtrace(&frame, 1);
+}
+
+// The watched thread takes its own backtrace in a signal handler, the symbols are
+// looked up here
+static void log_backtrace()
+{
+    __atomic_store_n(&sample_ready, 0, __ATOMIC_RELAXED);
+    if (pthread_kill(watched_thread, STALL_SAMPLE_SIGNAL) != 0) {
+        lprintf(LOG_WARNING, "Cannot signal the stalled thread\n");
+        return;
+    }
+
+    for (int i = 0; i < STALL_SAMPLE_WAIT_MS && !__atomic_load_n(&sample_ready, __ATOMIC_ACQUIRE); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    if (!__atomic_load_n(&sample_ready, __ATOMIC_ACQUIRE)) {
+        lprintf(LOG_WARNING, "The stalled thread did not take a backtrace\n");
+        return;
+    }
+
+    int size = __atomic_load_n(&sample_size, __ATOMIC_RELAXED);
+    char **symbols = backtrace_symbols(sample_frames, size);
+    if (symbols == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < size; i++) {
+        lprintf(LOG_WARNING, "  %s\n", symbols[i]);
+    }
+    free(symbols);
+}
+#else
+static void init_sampling()
+{
+
+}
+
+static void log_backtrace()
+{
+    lprintf(LOG_WARNING, "Backtraces are not supported in this build\n");
+}
+#endif
+
+static void record_stall(const char *cause, uint64_t ms)
+{
+    std::lock_guard<std::mutex> l(stats_lock);
+    stall_stats_t &s = stats[cause];
+    if (s.count == 0) {
+        s.cause = cause;
+    }
+
+    s.count++;
+    s.total_ms += ms;
+    s.max_ms = std::max(s.max_ms, ms);
+}
+
+static void watchdog_main()
+{
+    std::unique_lock<std::mutex> l(watchdog_lock);
+    while (running) {
+        uint64_t seq = ++ping_seq;
+        std::chrono::steady_clock::time_point sent = std::chrono::steady_clock::now();
+        l.unlock();
+        post_ping(seq);
+        l.lock();
+
+        auto answered = [seq]() {
+            return !running || pong_seq >= seq;
+        };
+
+        if (!watchdog_cond.wait_until(l, sent + std::chrono::milliseconds(threshold), answered)) {
+            // The span is read while the loop is still stuck in it, the loop
+            // was last known to be running at the last pong
+            const char *cause = watched_span->load(std::memory_order_relaxed);
+            std::chrono::steady_clock::time_point start = last_pong;
+            if (cause == NULL) {
+                cause = STALL_UNKNOWN_CAUSE;
+            } else {
+                std::chrono::nanoseconds ns(watched_span_start->load(std::memory_order_relaxed));
+                std::chrono::steady_clock::time_point entered(std::chrono::duration_cast<std::chrono::steady_clock::duration>(ns));
+                start = std::max(start, std::min(sent, entered));
+            }
+
+            lprintf(LOG_WARNING, "The event loop has been stalled for over %dms in %s, backtrace:\n", threshold, cause);
+            l.unlock();
+            log_backtrace();
+            l.lock();
+
+            watchdog_cond.wait(l, answered);
+            if (pong_seq >= seq) {
+                std::chrono::milliseconds ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+                lprintf(LOG_WARNING, "The event loop was stalled for %lldms in %s\n", (long long) ms.count(), cause);
+                record_stall(cause, ms.count());
+            }
+            ping_interval = STALL_PING_INTERVAL_MS;
+        } else if (std::chrono::steady_clock::now() - sent <= std::chrono::milliseconds(STALL_QUIET_MS)) {
+            ping_interval = std::min(ping_interval * 2, std::min(STALL_PING_IDLE_MS, threshold));
+            ping_interval = std::max(ping_interval, STALL_PING_INTERVAL_MS);
+        } else {
+            ping_interval = STALL_PING_INTERVAL_MS;
+        }
+
+        activity = false;
+        backed_off.store(ping_interval > STALL_PING_INTERVAL_MS, std::memory_order_relaxed);
+        watchdog_cond.wait_for(l, std::chrono::milliseconds(ping_interval), []() {
+            return !running || activity;
+        });
+    }
+}
+
+bool stall_watchdog_start(stall_post_t post, int threshold_ms)
+{
+    std::lock_guard<std::mutex> l(watchdog_lock);
+    if (running) {
+        lprintf(LOG_ERROR, "The stall watchdog is already running\n");
+        return false;
+    }
+
+    init_sampling();
+    watched_span = &trace_current_span;
+    watched_span_start = &trace_outer_span_start;
+    last_pong = std::chrono::steady_clock::now();
+    post_ping = post;
+    threshold = threshold_ms;
+    ping_interval = STALL_PING_INTERVAL_MS;
+    activity = false;
+    backed_off.store(false);
+    running = true;
+    watchdog = std::thread(&watchdog_main);
+
+    lprintf(LOG_INFO, "Started the stall watchdog, threshold %dms\n", threshold_ms);
+    return true;
+}
+
+void stall_watchdog_stop()
+{
+    {
+        std::lock_guard<std::mutex> l(watchdog_lock);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+
+    watchdog_cond.notify_all();
+    watchdog.join();
+    post_ping = nullptr;
+}
+
+void stall_watchdog_pong(uint64_t seq)
+{
+    {
+        std::lock_guard<std::mutex> l(watchdog_lock);
+        pong_seq = std::max(pong_seq, seq);
+        last_pong = std::chrono::steady_clock::now();
+    }
+    watchdog_cond.notify_all();
+}
+
+void stall_watchdog_activity()
+{
+    if (!backed_off.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> l(watchdog_lock);
+        backed_off.store(false, std::memory_order_relaxed);
+        ping_interval = STALL_PING_INTERVAL_MS;
+        activity = true;
+    }
+    watchdog_cond.notify_all();
+}
+
+int stall_watchdog_ping_interval()
+{
+    std::lock_guard<std::mutex> l(watchdog_lock);
+    return ping_interval;
+}
+
+std::vector<stall_stats_t> stall_watchdog_stats()
+{
+    std::vector<stall_stats_t> ret;
+    std::lock_guard<std::mutex> l(stats_lock);
+    for (auto &s : stats) {
+        ret.push_back(s.second);
+    }
+
+    std::sort(ret.begin(), ret.end(), [](const stall_stats_t &a, const stall_stats_t &b) {
+        return a.count > b.count;
+    });
+    return ret;
+}
+
+void stall_watchdog_reset()
+{
+    std::lock_guard<std::mutex> l(stats_lock);
+    stats.clear();
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+ * Watches an event loop from its own thread. A ping is posted to the loop every
+ * STALL_PING_INTERVAL_MS, when it is not answered within the threshold the span
+ * that the loop's thread is in (see trace.h) and, a sampled backtrace of it are
+ * logged. The stall is counted against that span once the loop answers again,
+ * it is timed from when the loop's outermost span was entered or, from the last
+ * answered ping if that is later.
+ * While the loop is idle (pings are answered straight away) the interval doubles
+ * up to STALL_PING_IDLE_MS or the threshold, whichever is less, so that work
+ * started by timers is still watched. stall_watchdog_activity() brings it back
+ * down when the loop is given work.
+ * */
+
+#define STALL_THRESHOLD_MS 100
+#define STALL_PING_INTERVAL_MS 50
+#define STALL_PING_IDLE_MS STALL_THRESHOLD_MS
+#define STALL_QUIET_MS 5 // A ping answered this fast means that the loop is idle
+#define STALL_BACKTRACE_FRAMES 32
+#define STALL_UNKNOWN_CAUSE "(not instrumented)"
+
+typedef struct stall_stats_t {
+    std::string cause;
+    uint64_t count;
+    uint64_t total_ms;
+    uint64_t max_ms;
+} stall_stats_t;
+
+// Queues a call to stall_watchdog_pong(seq) on the watched event loop
+typedef std::function<void(uint64_t seq)> stall_post_t;
+
+// Must be called from the thread that runs the event loop
+bool stall_watchdog_start(stall_post_t post, int threshold_ms);
+void stall_watchdog_stop();
+void stall_watchdog_pong(uint64_t seq);
+
+// Called on the watched loop when it is given work (user input), cheap while
+// the watchdog is not backed off
+void stall_watchdog_activity();
+int stall_watchdog_ping_interval();
+
+std::vector<stall_stats_t> stall_watchdog_stats(); // The most stalls first
+void stall_watchdog_reset();
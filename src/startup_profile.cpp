@@ -0,0 +1,56 @@
+#include "./startup_profile.h"
+#include "./async_log.h"
+#include <chrono>
+
+static std::chrono::steady_clock::time_point profile_start = std::chrono::steady_clock::now();
+static std::chrono::steady_clock::time_point last_phase = profile_start;
+static startup_phase_t phases[STARTUP_PROFILE_MAX_PHASES];
+static size_t phase_count = 0;
+
+void startup_profile_start()
+{
+    profile_start = last_phase = std::chrono::steady_clock::now();
+    phase_count = 0;
+}
+
+void startup_phase(const char *name)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (phase_count >= STARTUP_PROFILE_MAX_PHASES) {
+        return;
+    }
+
+    std::chrono::nanoseconds ns = now - last_phase;
+    phases[phase_count].name = name;
+    phases[phase_count].ns = ns.count();
+    phase_count++;
+    last_phase = now;
+}
+
+size_t startup_profile_phases(startup_phase_t *ret, size_t max)
+{
+    size_t i;
+    for (i = 0; i < max && i < phase_count; i++) {
+        ret[i] = phases[i];
+    }
+    return i;
+}
+
+uint64_t startup_profile_total_ns()
+{
+    std::chrono::nanoseconds ns = last_phase - profile_start;
+    return ns.count();
+}
+
+void startup_profile_log()
+{
+    uint64_t total = startup_profile_total_ns();
+    lprintf(LOG_INFO, "Startup profile:\n");
+    for (size_t i = 0; i < phase_count; i++) {
+        lprintf(LOG_INFO, "  %-24s %10.3fms %5.1f%%\n",
+                phases[i].name,
+                phases[i].ns / 1e6,
+                total > 0 ? 100.0 * phases[i].ns / total : 0.0);
+    }
+    lprintf(LOG_INFO, "  %-24s %10.3fms\n", "total", total / 1e6);
+}
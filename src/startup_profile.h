@@ -0,0 +1,25 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Times the phases of start up, from main() until the window has been painted.
+ * Each call to startup_phase ends the phase that started at the previous call
+ * (or, at startup_profile_start) and names it. The phases are only logged with
+ * --startup-profile.
+ * */
+
+#define STARTUP_PROFILE_ARG "--startup-profile"
+#define STARTUP_PROFILE_MAX_PHASES 32
+
+typedef struct startup_phase_t {
+    const char *name;
+    uint64_t ns;
+} startup_phase_t;
+
+void startup_profile_start();
+void startup_phase(const char *name); // name must be a string literal
+
+size_t startup_profile_phases(startup_phase_t *ret, size_t max); // Returns the number of phases copied
+uint64_t startup_profile_total_ns();
+void startup_profile_log();
@@ -1,7 +1,7 @@
 #include <stdlib.h>
 #include <time.h>
 #include "./timers.h"
-#include "../testing_h/logger.h"
+#include "./async_log.h"
 
 void init_timer(sq_timer_t *t, long duration, bool start_now)
 {
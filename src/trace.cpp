@@ -0,0 +1,147 @@
+#include "./trace.h"
+#include "./async_log.h"
+#include "./utils.h"
+#include <inttypes.h>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+typedef struct trace_event_t {
+    const char *name;
+    const char *cat;
+    uint64_t start_ns;
+    uint64_t dur_ns;
+} trace_event_t;
+
+// The lock is only contended while the trace is written
+typedef struct trace_buffer_t {
+    std::mutex lock;
+    std::vector<trace_event_t> events;
+    const char *thread_name;
+    size_t dropped;
+    int tid;
+} trace_buffer_t;
+
+std::atomic<bool> trace_enabled(false);
+thread_local std::atomic<const char *> trace_current_span(NULL);
+thread_local std::atomic<int64_t> trace_outer_span_start(0);
+
+static std::mutex buffers_lock;
+static std::vector<std::unique_ptr<trace_buffer_t>> buffers;
+static std::string trace_path;
+static std::chrono::steady_clock::time_point trace_start = std::chrono::steady_clock::now();
+static thread_local trace_buffer_t *local_buffer = NULL;
+
+static trace_buffer_t *get_buffer()
+{
+    if (local_buffer == NULL) {
+        std::unique_ptr<trace_buffer_t> b(new trace_buffer_t);
+        b->thread_name = NULL;
+        b->dropped = 0;
+
+        std::lock_guard<std::mutex> l(buffers_lock);
+        b->tid = buffers.size() + 1;
+        local_buffer = b.get();
+        buffers.push_back(std::move(b));
+    }
+    return local_buffer;
+}
+
+uint64_t trace_now_ns()
+{
+    std::chrono::nanoseconds ns = std::chrono::steady_clock::now() - trace_start;
+    return ns.count();
+}
+
+bool trace_init(const char *path)
+{
+    std::lock_guard<std::mutex> l(buffers_lock);
+    for (std::unique_ptr<trace_buffer_t> &b : buffers) {
+        std::lock_guard<std::mutex> bl(b->lock);
+        b->events.clear();
+        b->dropped = 0;
+    }
+
+    trace_path = path;
+    trace_start = std::chrono::steady_clock::now();
+    trace_enabled.store(true);
+    lprintf(LOG_INFO, "Tracing to %s\n", path);
+    return true;
+}
+
+void trace_set_thread_name(const char *name)
+{
+    trace_buffer_t *b = get_buffer();
+    std::lock_guard<std::mutex> l(b->lock);
+    b->thread_name = name;
+}
+
+void trace_record(const char *name, const char *cat, uint64_t start_ns, uint64_t end_ns)
+{
+    trace_buffer_t *b = get_buffer();
+    std::lock_guard<std::mutex> l(b->lock);
+    if (b->events.size() >= TRACE_MAX_EVENTS) {
+        b->dropped++;
+        return;
+    }
+
+    trace_event_t e = {name, cat, start_ns, end_ns - start_ns};
+    b->events.push_back(e);
+}
+
+// ts and, dur are in microseconds
+static bool write_events(FILE *f)
+{
+    bool first = true;
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    std::lock_guard<std::mutex> l(buffers_lock);
+    for (std::unique_ptr<trace_buffer_t> &b : buffers) {
+        std::lock_guard<std::mutex> bl(b->lock);
+        if (b->thread_name != NULL) {
+            fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                    first ? "" : ",", b->tid, b->thread_name);
+            first = false;
+        }
+
+        for (trace_event_t &e : b->events) {
+            fprintf(f, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%" PRIu64 ".%03d,\"dur\":%" PRIu64 ".%03d}",
+                    first ? "" : ",", e.name, e.cat, b->tid,
+                    e.start_ns / 1000, (int) (e.start_ns % 1000),
+                    e.dur_ns / 1000, (int) (e.dur_ns % 1000));
+            first = false;
+        }
+
+        if (b->dropped > 0) {
+            lprintf(LOG_WARNING, "Dropped %lu trace events on thread %d\n", (unsigned long) b->dropped, b->tid);
+        }
+    }
+
+    fprintf(f, "]}\n");
+    return ferror(f) == 0;
+}
+
+bool trace_write()
+{
+    if (!trace_enabled.exchange(false)) {
+        return false;
+    }
+
+    atomic_file_t af;
+    if (!atomic_file_open(&af, trace_path.c_str())) {
+        return false;
+    }
+
+    if (!write_events(af.f)) {
+        lprintf(LOG_ERROR, "Cannot write trace to %s\n", af.tmp_path);
+        atomic_file_abort(&af);
+        return false;
+    }
+
+    bool r = atomic_file_commit(&af);
+    if (r) {
+        lprintf(LOG_INFO, "Wrote trace to %s\n", trace_path.c_str());
+    }
+    return r;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+
+/*
+ * Chrome trace event recorder for --trace=out.json, the output loads in
+ * Perfetto or, chrome://tracing. Each span is one complete ("X") event kept in
+ * a buffer per thread, nothing is written until trace_write is called at exit.
+ * When tracing is off a span costs one relaxed load and, it still sets
+ * trace_current_span so that the stall watchdog can name what is running. The
+ * outermost span on a thread also reads the clock so that the watchdog can tell
+ * when a stall started.
+ *
+ * Span, category and, thread names are not copied or escaped so they must be
+ * string literals.
+ * */
+
+#define TRACE_ARG "--trace="
+#define TRACE_MAX_EVENTS (1 << 20) // Per thread, later spans are dropped
+
+#define TRACE_CAT_UI "ui"
+#define TRACE_CAT_MODEL "model"
+#define TRACE_CAT_IO "io"
+
+extern std::atomic<bool> trace_enabled;
+
+// The innermost open span on this thread, NULL if there is none
+extern thread_local std::atomic<const char *> trace_current_span;
+// When the outermost open span on this thread was entered, in steady_clock ns
+extern thread_local std::atomic<int64_t> trace_outer_span_start;
+
+bool trace_init(const char *path); // Starts tracing, clearing earlier spans
+bool trace_write(); // Stops tracing then, writes every thread's spans to the path
+void trace_set_thread_name(const char *name);
+uint64_t trace_now_ns();
+void trace_record(const char *name, const char *cat, uint64_t start_ns, uint64_t end_ns);
+
+typedef struct trace_span_t {
+    const char *name;
+    const char *cat;
+    const char *parent;
+    uint64_t start;
+    bool active;
+
+    trace_span_t(const char *n, const char *c) : name(n), cat(c), start(0)
+    {
+        parent = trace_current_span.load(std::memory_order_relaxed);
+        if (parent == NULL) {
+            std::chrono::nanoseconds now = std::chrono::steady_clock::now().time_since_epoch();
+            trace_outer_span_start.store(now.count(), std::memory_order_relaxed);
+        }
+        trace_current_span.store(n, std::memory_order_relaxed);
+        active = trace_enabled.load(std::memory_order_relaxed);
+        if (active) {
+            start = trace_now_ns();
+        }
+    }
+
+    ~trace_span_t()
+    {
+        if (active) {
+            trace_record(name, cat, start, trace_now_ns());
+        }
+        trace_current_span.store(parent, std::memory_order_relaxed);
+    }
+} trace_span_t;
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+// Records a span from here to the end of the scope
+#define TRACE_SPAN(name, cat) trace_span_t TRACE_CONCAT(trace_span_, __LINE__)(name, cat)
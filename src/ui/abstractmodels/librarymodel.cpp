@@ -0,0 +1,83 @@
+#include "./librarymodel.h"
+#include <QDateTime>
+#define COLS 5
+
+LibraryModel::LibraryModel(std::vector<LibraryEntry> entries) :
+    TableModel<LibraryEntry>(entries)
+{
+
+}
+
+LibraryModel::~LibraryModel()
+{
+
+}
+
+int LibraryModel::columnCount(const QModelIndex &parent) const
+{
+    return COLS;
+}
+
+QVariant LibraryModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    if (orientation == Qt::Orientation::Vertical) {
+        return QVariant(section + 1);
+    }
+
+    // The same order as LibraryEntry::getDefaultAlgs()
+    switch (section) {
+    case 0:
+        return QVariant(tr("Last Modified"));
+    case 1:
+        return QVariant(tr("Name"));
+    case 2:
+        return QVariant(tr("Format"));
+    case 3:
+        return QVariant(tr("Pairing System"));
+    case 4:
+        return QVariant(tr("Players"));
+    }
+    return QVariant();
+}
+
+// The view only asks for the rows on screen, so the strings are made here
+QVariant LibraryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    if (index.row() >= (int) this->mdldata.size() || index.column() >= COLS) {
+        return QVariant();
+    }
+
+    const LibraryEntry &entry = this->mdldata[index.row()];
+    if (role == Qt::ToolTipRole) {
+        return QVariant(QString::fromStdString(entry.path));
+    }
+
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    switch (index.column()) {
+    case 0:
+        return QVariant(QDateTime::fromSecsSinceEpoch(entry.meta.mtime).toString(Qt::ISODate).replace("T", " "));
+    case 1:
+        return QVariant(QString::fromStdString(entry.meta.name));
+    case 2:
+        return QVariant(QString::fromStdString(entry.meta.format));
+    case 3:
+        return QVariant(QString::fromStdString(entry.meta.pairing_sys));
+    case 4:
+        if (entry.meta.player_count < 0) {
+            return QVariant(tr("Unknown"));
+        }
+        return QVariant(entry.meta.player_count);
+    }
+    return QVariant();
+}
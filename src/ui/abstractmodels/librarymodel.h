@@ -0,0 +1,15 @@
+#pragma once
+#include <QVariant>
+#include "../../library.h"
+#include "../widgets/tablemodel.hpp"
+
+class LibraryModel : public TableModel<LibraryEntry>
+{
+    Q_OBJECT
+public:
+    LibraryModel(std::vector<LibraryEntry> entries);
+    ~LibraryModel();
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+};
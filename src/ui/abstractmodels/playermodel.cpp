@@ -1,23 +1,8 @@
 #include "./playermodel.h"
-#include <QPixmap>
+#include "../assetcache.h"
 #include <QIcon>
-#include "assets.h"
 #define COLS 3
 
-static QIcon *DROPPED_STATUS_ICON;
-static QIcon *REGISTERED_STATUS_ICON;
-
-void player_model_init_icons()
-{
-    QPixmap tmp;
-    tmp.loadFromData(PLAYER_DROPPED_PNG, sizeof(PLAYER_DROPPED_PNG));
-    DROPPED_STATUS_ICON = new QIcon(tmp);
-
-    QPixmap tmp2;
-    tmp2.loadFromData(PLAYER_REGISTERED_PNG, sizeof(PLAYER_DROPPED_PNG));
-    REGISTERED_STATUS_ICON = new QIcon(tmp2);
-}
-
 PlayerModel::PlayerModel(std::vector<Player> players) :
     TableModel<Player>(players)
 {
@@ -70,9 +55,9 @@ QVariant PlayerModel::data(const QModelIndex &index, int role) const
     case 0:
         switch (player.status()) {
         case squire_core::sc_PlayerStatus::Dropped:
-            return QVariant(*DROPPED_STATUS_ICON);
+            return QVariant(asset_icon(ASSET_PLAYER_DROPPED));
         case squire_core::sc_PlayerStatus::Registered:
-            return QVariant(*REGISTERED_STATUS_ICON);
+            return QVariant(asset_icon(ASSET_PLAYER_REGISTERED));
         }
         return QVariant(tr("Error"));
     case 1:
@@ -3,10 +3,18 @@
 // Name, match points, game points, mwp, gwp, opp_mwp, opp_gwp
 #define COLS 7
 
+static std::string player_score_key(const PlayerScore &score)
+{
+    PlayerScore s = score;
+    squire_core::sc_PlayerId id = s.player().id();
+    return std::string((const char *) id._0, sizeof(id._0));
+}
+
 PlayerScoreModel::PlayerScoreModel(std::vector<PlayerScore> playerScores) :
     TableModel<PlayerScore>(playerScores)
 {
-
+    // Standings are reordered in place so the board does not jump
+    this->setKey(&player_score_key);
 }
 
 PlayerScoreModel::~PlayerScoreModel()
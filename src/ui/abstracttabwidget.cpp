@@ -1,10 +1,11 @@
 #include "./abstracttabwidget.h"
-#include "../../testing_h/logger.h"
+#include "../async_log.h"
 
 AbstractTabWidget::AbstractTabWidget(QWidget *parent)
     : QWidget(parent)
 {
     this->menus = std::vector<QMenu *>();
+    this->suspended = true; // Until it is first shown
 }
 
 AbstractTabWidget::~AbstractTabWidget()
@@ -31,3 +32,36 @@ QMenu *AbstractTabWidget::addMenu(QString name)
     return ret;
 }
 
+
+void AbstractTabWidget::onTabShown()
+{
+
+}
+
+void AbstractTabWidget::onTabHidden()
+{
+
+}
+
+bool AbstractTabWidget::isSuspended()
+{
+    return this->suspended;
+}
+
+void AbstractTabWidget::showEvent(QShowEvent *e)
+{
+    QWidget::showEvent(e);
+    if (this->suspended) {
+        this->suspended = false;
+        this->onTabShown();
+    }
+}
+
+void AbstractTabWidget::hideEvent(QHideEvent *e)
+{
+    QWidget::hideEvent(e);
+    if (!this->suspended) {
+        this->suspended = true;
+        this->onTabHidden();
+    }
+}
@@ -2,6 +2,8 @@
 #include <vector>
 #include <QWidget>
 #include <QMenu>
+#include <QShowEvent>
+#include <QHideEvent>
 
 class AbstractTabWidget : public QWidget
 {
@@ -27,5 +29,18 @@ public slots:
 protected:
     std::vector<QMenu *> menus;
     QMenu *addMenu(QString name);
+
+    /*
+     * Tabs that are not in front are suspended, they should stop their timers
+     * and, can drop any caches. onTabShown is called when the tab is brought
+     * back to the front so that it can resync.
+     * */
+    virtual void onTabShown();
+    virtual void onTabHidden();
+    bool isSuspended();
+    void showEvent(QShowEvent *e) override;
+    void hideEvent(QHideEvent *e) override;
+private:
+    bool suspended;
 };
 
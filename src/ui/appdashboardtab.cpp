@@ -1,28 +1,41 @@
 #include "./appdashboardtab.h"
 #include "./ui_appdashboardtab.h"
 #include "./widgets/recenttournamentwidget.h"
-#include <assets.h>
+#include "../async_log.h"
+#include "../trace.h"
+#include <string.h>
+#include <stdlib.h>
 
-AppDashboardTab::AppDashboardTab(config_t t, QWidget *parent) :
+AppDashboardTab::AppDashboardTab(config_t *t, QWidget *parent) :
     AbstractTabWidget(parent),
     ui(new Ui::AppDashboardTab)
 {
+    this->config = t;
     ui->setupUi(this);
 
-    // Set recent tournaments
+    // Set recent tournaments, these come from the cache so the files are
+    // checked in the background afterwards
     this->layout = new QVBoxLayout(ui->recentTournaments);
     this->layout->setAlignment(Qt::AlignTop);
-    for (int i = 0; i < t.recent_tournament_count; i++) {
-        RecentTournamentWidget *w = new RecentTournamentWidget(t.recent_tournaments[i], this);
-        this->layout->insertWidget(0, w);
-        connect(w, &RecentTournamentWidget::loadTournament, this, &AppDashboardTab::openTournament);
-    }
+    this->revalidated = NULL;
+    this->revalidatedCount = 0;
+    this->renderRecentTournaments();
+    this->revalidateRecentTournaments();
 
-    // Banner stuff
-    pixmap.loadFromData(BANNER_PNG, sizeof(BANNER_PNG));
+    // The library is only indexed once its tab is first opened
+    this->libraryIndexing = false;
+    this->libraryStale = false;
+    this->libraryLayout = new QVBoxLayout(ui->libraryTab);
+    this->library = new SearchSortTableWidget<LibraryModel, LibraryEntry>(std::vector<LibraryEntry>());
+    this->libraryLayout->addWidget(this->library);
+    connect(this->library->view(), &QTableView::doubleClicked, this, &AppDashboardTab::libraryActivated);
+    this->library->view()->setMouseTracking(true);
+    connect(this->library->view(), &QTableView::entered, this, &AppDashboardTab::libraryHovered);
+    connect(ui->tournamentTabs, &QTabWidget::currentChanged, this, &AppDashboardTab::dashboardTabChanged);
 
+    // Banner stuff
     this->banner = new LabelImage();
-    this->banner->setPixmap(pixmap);
+    this->banner->setAsset(ASSET_BANNER);
 
     this->bannerLayout = new QVBoxLayout(ui->bannerView);
     this->bannerLayout->setAlignment(Qt::AlignTop);
@@ -31,15 +44,209 @@ AppDashboardTab::AppDashboardTab(config_t t, QWidget *parent) :
 
 AppDashboardTab::~AppDashboardTab()
 {
+    if (this->revalidateThread.joinable()) {
+        this->revalidateThread.join();
+    }
+    this->freeRevalidated(); // The queued call is dropped with this
+
+    if (this->libraryThread.joinable()) {
+        this->libraryThread.join();
+    }
+    delete this->library;
+    delete this->libraryLayout;
+
     delete ui;
     delete this->bannerLayout;
 }
 
+// The entry may have moved rather than been appended so, the list is redrawn
 void AppDashboardTab::onTournamentAdded(recent_tournament_t t)
+{
+    this->renderRecentTournaments();
+    if (this->libraryThread.joinable()) {
+        this->indexLibrary(); // Only once it has been opened
+    }
+}
+
+void AppDashboardTab::addRecentTournament(recent_tournament_t t)
 {
     RecentTournamentWidget *w = new RecentTournamentWidget(t, this);
     this->layout->insertWidget(0, w);
     connect(w, &RecentTournamentWidget::loadTournament, this, &AppDashboardTab::openTournament);
+    connect(w, &RecentTournamentWidget::preloadTournament, this, &AppDashboardTab::preloadTournament);
+}
+
+void AppDashboardTab::renderRecentTournaments()
+{
+    QLayoutItem *item;
+    while ((item = this->layout->takeAt(0)) != nullptr) {
+        delete item->widget();
+        delete item;
+    }
+
+    for (int i = 0; i < this->config->recent_tournament_count; i++) {
+        this->addRecentTournament(*recent_tourn_at(this->config, i));
+    }
+}
+
+// Stats the recent tournaments on a copy of the list in a worker thread, the
+// cache is rewritten there and, changed entries are swapped in on the GUI thread.
+void AppDashboardTab::revalidateRecentTournaments()
+{
+    int count = this->config->recent_tournament_count;
+    if (count == 0) {
+        return;
+    }
+
+    recent_tournament_t *tourns = (recent_tournament_t *) malloc(sizeof * tourns * count);
+    if (tourns == NULL) {
+        lprintf(LOG_ERROR, "Cannot allocate the recent tournaments to revalidate\n");
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        tourns[i] = clone_recent_tourn(*recent_tourn_at(this->config, i));
+    }
+
+    this->revalidateThread = std::thread([this, tourns, count]() {
+        bool changed = revalidate_recent_tourns(tourns, count);
+
+        atomic_file_t af;
+        if (atomic_file_open(&af, RECENT_CACHE_FILE)) {
+            if (write_recent_cache(tourns, count, af.f)) {
+                atomic_file_commit(&af);
+            } else {
+                lprintf(LOG_ERROR, "Cannot write the recent tournament cache\n");
+                atomic_file_abort(&af);
+            }
+        }
+
+        if (changed) {
+            lprintf(LOG_INFO, "Recent tournaments have changed since they were cached\n");
+            this->revalidated = tourns;
+            this->revalidatedCount = count;
+            QMetaObject::invokeMethod(this, [this]() {
+                this->onRecentTournamentsRevalidated();
+            }, Qt::QueuedConnection);
+        } else {
+            for (int i = 0; i < count; i++) {
+                free_recent_tourn(&tourns[i]);
+            }
+            free(tourns);
+        }
+    });
+}
+
+void AppDashboardTab::freeRevalidated()
+{
+    if (this->revalidated == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < this->revalidatedCount; i++) {
+        free_recent_tourn(&this->revalidated[i]);
+    }
+    free(this->revalidated);
+    this->revalidated = NULL;
+    this->revalidatedCount = 0;
+}
+
+void AppDashboardTab::onRecentTournamentsRevalidated()
+{
+    recent_tournament_t *tourns = this->revalidated;
+    int count = this->revalidatedCount;
+    this->revalidated = NULL;
+    this->revalidatedCount = 0;
+
+    // A tournament may have been opened since, its entry is newer than the result
+    if (merge_recent_tourns(this->config, tourns, count) > 0) {
+        this->renderRecentTournaments();
+    }
+    free(tourns);
+}
+
+void AppDashboardTab::dashboardTabChanged(int index)
+{
+    if (ui->tournamentTabs->widget(index) == ui->libraryTab && !this->libraryThread.joinable()) {
+        this->indexLibrary();
+    }
+}
+
+// Lists the save folder and, reads the files that are not in the library cache
+// in a worker thread. The recent tournaments are included as they may have been
+// saved elsewhere.
+void AppDashboardTab::indexLibrary()
+{
+    if (this->libraryIndexing) {
+        this->libraryStale = true;
+        return;
+    }
+
+    // The last index has finished
+    if (this->libraryThread.joinable()) {
+        this->libraryThread.join();
+    }
+
+    std::string dir = this->config->tourn_save_path;
+    std::vector<std::string> recent;
+    for (int i = 0; i < this->config->recent_tournament_count; i++) {
+        recent.push_back(recent_tourn_at(this->config, i)->file_path);
+    }
+
+    this->libraryIndexing = true;
+    this->libraryThread = std::thread([this, dir, recent]() {
+        std::vector<std::string> files = library_find_files(dir.c_str());
+        files.insert(files.end(), recent.begin(), recent.end());
+
+        FILE *cache = fopen(LIBRARY_CACHE_FILE, "r");
+        std::vector<LibraryEntry> entries = library_index(files, cache);
+        if (cache != NULL) {
+            fclose(cache);
+        }
+
+        atomic_file_t af;
+        if (atomic_file_open(&af, LIBRARY_CACHE_FILE)) {
+            if (library_write_cache(entries, af.f)) {
+                atomic_file_commit(&af);
+            } else {
+                lprintf(LOG_ERROR, "Cannot write the library cache\n");
+                atomic_file_abort(&af);
+            }
+        }
+
+        // Owned by the queued call so that it is freed if the tab goes first
+        QMetaObject::invokeMethod(this, [this, entries = std::move(entries)]() {
+            this->onLibraryIndexed(entries);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void AppDashboardTab::onLibraryIndexed(const std::vector<LibraryEntry> &entries)
+{
+    TRACE_SPAN("AppDashboardTab::onLibraryIndexed", TRACE_CAT_UI);
+    this->library->setData(entries);
+
+    this->libraryIndexing = false;
+    if (this->libraryStale) {
+        this->libraryStale = false;
+        this->indexLibrary();
+    }
+}
+
+void AppDashboardTab::libraryActivated(const QModelIndex &index)
+{
+    const LibraryEntry *entry = this->library->dataAt(index.row());
+    if (entry != NULL && entry->path != "") {
+        this->openTournament(QString::fromStdString(entry->path));
+    }
+}
+
+void AppDashboardTab::libraryHovered(const QModelIndex &index)
+{
+    const LibraryEntry *entry = this->library->dataAt(index.row());
+    if (entry != NULL && entry->path != "") {
+        emit this->preloadTournament(QString::fromStdString(entry->path));
+    }
 }
 
 void AppDashboardTab::changeEvent(QEvent *e)
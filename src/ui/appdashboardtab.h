@@ -1,9 +1,13 @@
 #pragma once
+#include <thread>
 #include <QWidget>
 #include <QVBoxLayout>
 #include "../config.h"
 #include "./widgets/labelimage.h"
 #include "./abstracttabwidget.h"
+#include "./widgets/searchsorttablewidget.h"
+#include "./abstractmodels/librarymodel.h"
+#include "../library.h"
 
 namespace Ui
 {
@@ -15,23 +19,43 @@ class AppDashboardTab : public AbstractTabWidget
     Q_OBJECT
 
 public:
-    explicit AppDashboardTab(config_t t, QWidget *parent = nullptr);
+    explicit AppDashboardTab(config_t *t, QWidget *parent = nullptr);
     ~AppDashboardTab();
     Ui::AppDashboardTab *ui; // Sorry OOP fans
 
     void onTournamentAdded(recent_tournament_t t);
 signals:
     void loadTournament(QString name);
+    void preloadTournament(QString name);
 public slots:
     bool canExit() override;
 protected:
     void changeEvent(QEvent *e);
 private:
+    config_t *config;
+    std::thread revalidateThread;
+    // Set by revalidateThread, owned here until the GUI thread takes them
+    recent_tournament_t *revalidated;
+    int revalidatedCount;
+    std::thread libraryThread;
+    SearchSortTableWidget<LibraryModel, LibraryEntry> *library;
+    QVBoxLayout *libraryLayout;
+    bool libraryIndexing;
+    bool libraryStale; // Something was saved while it was being indexed
     LabelImage *banner;
     QVBoxLayout *layout;
     QVBoxLayout *bannerLayout;
-    QPixmap pixmap;
+    void addRecentTournament(recent_tournament_t t);
+    void renderRecentTournaments();
+    void revalidateRecentTournaments();
+    void onRecentTournamentsRevalidated();
+    void freeRevalidated();
+    void indexLibrary();
+    void onLibraryIndexed(const std::vector<LibraryEntry> &entries);
 private slots:
     void openTournament(QString name);
+    void dashboardTabChanged(int index);
+    void libraryActivated(const QModelIndex &index);
+    void libraryHovered(const QModelIndex &index);
 };
 
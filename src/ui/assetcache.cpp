@@ -0,0 +1,91 @@
+#include "./assetcache.h"
+#include "../async_log.h"
+#include "../trace.h"
+#include <assets.h>
+#include <QPixmapCache>
+#include <QString>
+
+typedef struct asset_data_t {
+    const unsigned char *data;
+    size_t size;
+    const char *name;
+} asset_data_t;
+
+#define ASSET(name) {name, sizeof(name), #name}
+
+// In the order of asset_id_t
+static const asset_data_t asset_data[ASSET_COUNT] = {
+    ASSET(ICON_PNG),
+    ASSET(BANNER_PNG),
+    ASSET(WARNING_PNG),
+    ASSET(FLUID_PNG),
+    ASSET(SWISS_PNG),
+    ASSET(PLAYER_DROPPED_PNG),
+    ASSET(PLAYER_REGISTERED_PNG)
+};
+
+static QIcon *icons[ASSET_COUNT];
+
+static QString cache_key(asset_id_t id, QSize size)
+{
+    return QString(ASSET_CACHE_KEY "-%1-%2x%3").arg((int) id).arg(size.width()).arg(size.height());
+}
+
+// The cache can evict anything so, the image is decoded again when it is missed
+static QPixmap asset_original(asset_id_t id)
+{
+    QString key = cache_key(id, QSize());
+    QPixmap ret;
+    if (QPixmapCache::find(key, &ret)) {
+        return ret;
+    }
+
+    TRACE_SPAN("asset_decode", TRACE_CAT_UI);
+    const asset_data_t &a = asset_data[id];
+    if (!ret.loadFromData(a.data, a.size)) {
+        lprintf(LOG_ERROR, "Cannot decode asset %s\n", a.name);
+        return ret;
+    }
+
+    QPixmapCache::insert(key, ret);
+    return ret;
+}
+
+QPixmap asset_pixmap(asset_id_t id, QSize size)
+{
+    if (id < 0 || id >= ASSET_COUNT) {
+        return QPixmap();
+    }
+
+    if (!size.isValid() || size.isEmpty()) {
+        return asset_original(id);
+    }
+
+    QString key = cache_key(id, size);
+    QPixmap ret;
+    if (QPixmapCache::find(key, &ret)) {
+        return ret;
+    }
+
+    QPixmap original = asset_original(id);
+    if (original.isNull()) {
+        return original;
+    }
+
+    ret = original.scaled(size, Qt::KeepAspectRatio);
+    QPixmapCache::insert(key, ret);
+    return ret;
+}
+
+const QIcon &asset_icon(asset_id_t id)
+{
+    static QIcon empty;
+    if (id < 0 || id >= ASSET_COUNT) {
+        return empty;
+    }
+
+    if (icons[id] == NULL) {
+        icons[id] = new QIcon(asset_original(id));
+    }
+    return *icons[id];
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <QIcon>
+#include <QPixmap>
+#include <QSize>
+
+/*
+ * The embedded images, each one is decoded on its first use and, kept in the
+ * QPixmapCache along with its scaled copies so widgets of the same size share
+ * one pixmap. Icons are made once and, shared by every model and widget. These
+ * must only be called from the GUI thread.
+ * */
+
+#define ASSET_CACHE_KEY "squire-asset"
+
+typedef enum asset_id_t {
+    ASSET_ICON = 0,
+    ASSET_BANNER,
+    ASSET_WARNING,
+    ASSET_FLUID,
+    ASSET_SWISS,
+    ASSET_PLAYER_DROPPED,
+    ASSET_PLAYER_REGISTERED,
+    ASSET_COUNT
+} asset_id_t;
+
+// An empty size is the image's own size, scaled copies keep the aspect ratio
+QPixmap asset_pixmap(asset_id_t id, QSize size = QSize());
+const QIcon &asset_icon(asset_id_t id);
@@ -0,0 +1,48 @@
+#include "./configwriter.h"
+#include "../async_log.h"
+#include <QCoreApplication>
+
+ConfigWriter::ConfigWriter(config_t *config, QObject *parent)
+    : QObject(parent)
+{
+    this->config = config;
+
+    // The config has just been read or, written so it matches the file
+    this->lastWritten = serialise_config(config);
+
+    this->timer.setSingleShot(true);
+    this->timer.setInterval(CONFIG_SAVE_DELAY_MS);
+    connect(&this->timer, &QTimer::timeout, this, &ConfigWriter::flush);
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &ConfigWriter::flush);
+}
+
+ConfigWriter::~ConfigWriter()
+{
+    this->flush();
+}
+
+void ConfigWriter::requestSave()
+{
+    if (!this->timer.isActive()) {
+        this->timer.start();
+    }
+}
+
+bool ConfigWriter::flush()
+{
+    this->timer.stop();
+
+    std::string output = serialise_config(this->config);
+    if (output == this->lastWritten) {
+        return true;
+    }
+
+    if (!save_config(this->config, CONFIG_FILE)) {
+        lprintf(LOG_ERROR, "Cannot save config file %s\n", CONFIG_FILE);
+        return false;
+    }
+
+    this->lastWritten = output;
+    lprintf(LOG_INFO, "Saved config file %s\n", CONFIG_FILE);
+    return true;
+}
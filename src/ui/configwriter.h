@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <QObject>
+#include <QTimer>
+#include "../config.h"
+
+#define CONFIG_SAVE_DELAY_MS 500
+
+/*
+ * All writes of the config file go through here. Save requests within
+ * CONFIG_SAVE_DELAY_MS of each other are coalesced into one write and, a
+ * config that has not changed since the last write is not written again.
+ * */
+class ConfigWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ConfigWriter(config_t *config, QObject *parent = nullptr);
+    ~ConfigWriter();
+public slots:
+    void requestSave();
+    /*
+     * Writes any pending changes now, returns false if the write failed.
+     * */
+    bool flush();
+private:
+    config_t *config;
+    QTimer timer;
+    std::string lastWritten;
+};
@@ -1,16 +1,20 @@
-#include <assets.h>
 #include "./mainwindow.h"
 #include "./ui_mainwindow.h"
+#include "./assetcache.h"
 #include "./menubar/rng/coinsflipdialogue.h"
 #include "./menubar/rng/dicerolldialogue.h"
 #include "./menubar/file/settingtab.h"
 #include "./menubar/file/createtournamentdialogue.h"
-#include "../../testing_h/logger.h"
+#include "./menubar/help/diagnosticsdialogue.h"
+#include "../async_log.h"
+#include "../ffi_stats.h"
+#include "../ffi_utils.h"
 #include "../discord_game_sdk.h"
 #include "./ui_appdashboardtab.h" // Hack to attach dashboard to menubar
 #include "./abstracttabwidget.h"
 #include "./tournamenttab.h"
 #include <squire_core/squire_core.h>
+#include <algorithm>
 #include <chrono>
 #include <string.h>
 #include <QIcon>
@@ -27,20 +31,36 @@ MainWindow::MainWindow(config_t *t, QWidget *parent)
     , ui(new Ui::MainWindow)
 {
     this->config = t;
+    this->configWriter = new ConfigWriter(t, this);
+
+    // Unused preloads are closed in squire_core
+    preload_queue_init(&this->preloadQueue, [](const std::string &path) -> void * {
+        squire_core::sc_TournamentId *tid = new squire_core::sc_TournamentId;
+        if (!load_tournament_id(path, tid)) {
+            delete tid;
+            return NULL;
+        }
+        return tid;
+    }, [](void *r) {
+        squire_core::sc_TournamentId *tid = (squire_core::sc_TournamentId *) r;
+        {
+            std::lock_guard<std::mutex> l(ffi_tourns_lock());
+            SQ_CALL(close_tourn, *tid);
+        }
+        delete tid;
+    }, PRELOAD_MAX_READY);
     ui->setupUi(this);
     this->setWindowTitle(QString(PROJECT_NAME) + " - " + PROJECT_VERSION);
 
-    QPixmap pixmap;
-    pixmap.loadFromData(ICON_PNG, sizeof(ICON_PNG));
-    QIcon icon = QIcon(pixmap);
-    this->setWindowIcon(icon);
+    this->setWindowIcon(asset_icon(ASSET_ICON));
 
     // Application dashboard
-    this->dashboard = new AppDashboardTab(*t, ui->tabWidget);
+    this->dashboard = new AppDashboardTab(t, ui->tabWidget);
     this->addTab(this->dashboard, tr("Dashboard"));
     ui->tabWidget->tabBar()->setTabButton(0, QTabBar::RightSide, nullptr);
 
     connect(this->dashboard, &AppDashboardTab::loadTournament, this, &MainWindow::loadTournamentFromName);
+    connect(this->dashboard, &AppDashboardTab::preloadTournament, this, &MainWindow::preloadTournament);
 
     this->addDefaultmenu();
     connect(dashboard->ui->openTournament, &QPushButton::clicked, this, &MainWindow::loadTournament);
@@ -72,22 +92,20 @@ MainWindow::MainWindow(config_t *t, QWidget *parent)
     QCoreApplication::setApplicationName("SquireDesktop");
     QCoreApplication::setApplicationVersion(VERSION);
 
-    this->dc_info = (dc_info_t *) malloc(sizeof * this->dc_info);
-    if (this->dc_info != NULL) {
-        this->discord_thread_txt = NULL;
-        this->dc_info->txt = NULL;
-        this->dc_info->running = true;
-        this->dc_info->lock = new std::mutex();
-        this->setDiscordText((QString::fromStdString(PROJECT_NAME " - ") + tr("Dashboard")).toStdString());
-
-        this->discord_thread = std::thread(&dc_thread, this->dc_info);
-    } else {
-        lprintf(LOG_ERROR, "Malloc error\n");
-    }
+    this->setDiscordText((QString::fromStdString(PROJECT_NAME " - ") + tr("Dashboard")).toStdString());
 
     lprintf(LOG_INFO, "Application started fully.\n");
 }
 
+// Not needed for the first paint so, it is started afterwards
+void MainWindow::startDiscord()
+{
+    if (this->discord_thread.joinable()) {
+        return;
+    }
+    this->discord_thread = std::thread(&dc_thread, &this->discord_queue);
+}
+
 void MainWindow::addDefaultmenu()
 {
     ui->menubar->clear();
@@ -124,22 +142,28 @@ void MainWindow::addDefaultmenu()
 
     QAction *discordAction = helpMenu->addAction(tr("Join Our Discord"));
     connect(discordAction, &QAction::triggered, this, &MainWindow::joinDiscord);
+
+    QAction *diagnosticsAction = helpMenu->addAction(tr("&Diagnostics"));
+    connect(diagnosticsAction, &QAction::triggered, this, &MainWindow::diagnostics);
+
+#ifdef FFI_STATS
+    QMenu *debugMenu = ui->menubar->addMenu(tr("Debug"));
+    QAction *dumpFfiStatsAction = debugMenu->addAction(tr("Dump FFI Stats"));
+    connect(dumpFfiStatsAction, &QAction::triggered, this, []() {
+        ffi_stats_log();
+        ffi_stats_write(FFI_STATS_FILE);
+    });
+
+    QAction *resetFfiStatsAction = debugMenu->addAction(tr("Reset FFI Stats"));
+    connect(resetFfiStatsAction, &QAction::triggered, this, []() {
+        ffi_stats_reset();
+    });
+#endif
 }
 
 void MainWindow::setDiscordText(std::string txt)
 {
-    if (this->dc_info == NULL) {
-        return;
-    }
-
-    this->dc_info->lock->lock();
-    if (this->discord_thread_txt != NULL) {
-        free(this->discord_thread_txt);
-    }
-
-    this->discord_thread_txt = clone_std_string(txt);
-    this->dc_info->txt = &this->discord_thread_txt;
-    this->dc_info->lock->unlock();
+    presence_queue_push(&this->discord_queue, txt);
 }
 
 struct Application {
@@ -147,7 +171,26 @@ struct Application {
     struct IDiscordUsers* users;
 };
 
-void dc_thread(dc_info_t *info)
+static void dc_set_activity(struct Application *app, std::string txt, size_t start_time)
+{
+    lprintf(LOG_INFO, "Set Discord state to %s\n", txt.c_str());
+
+    DiscordActivity activity;
+    memset(&activity, 0, sizeof(activity));
+    activity.type = DiscordActivityType_Playing;
+    strncpy(activity.name, PROJECT_NAME, sizeof(activity.name));
+    strncpy(activity.state, "Running a Tournament", sizeof(activity.state));
+    strncpy(activity.details, txt.c_str(), sizeof(activity.details));
+    strncpy(activity.assets.large_image, DISCORD_LARGE_IMG, sizeof(activity.assets.large_image));
+    activity.timestamps.start = start_time;
+
+    IDiscordActivityManager *act = app->core->get_activity_manager(app->core);
+    act->update_activity(act, &activity, NULL, NULL);
+}
+
+// Sleeps on the queue between connection attempts and, between callback pumps so
+// the thread does not wake up when there is nothing to do
+void dc_thread(presence_queue_t *queue)
 {
     lprintf(LOG_INFO, "Discord RPC thread started.\n");
     struct Application app;
@@ -161,64 +204,64 @@ void dc_thread(dc_info_t *info)
     params.flags = DiscordCreateFlags_NoRequireDiscord;
     params.events = &events;
     params.event_data = &app;
-    while (DiscordCreate(DISCORD_VERSION, &params, &app.core) != DiscordResult_Ok && info->running)
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
     size_t dc_start_time = time(NULL);
-
-    while (info->running) {
-        EDiscordResult r = app.core->run_callbacks(app.core);
-        if (r != DiscordResult_Ok) {
+    std::string txt;
+    bool has_txt = false;
+    int failures = 0;
+
+    while (presence_queue_running(queue)) {
+        if (DiscordCreate(DISCORD_VERSION, &params, &app.core) != DiscordResult_Ok) {
+            app.core = NULL;
+            failures++;
+
+            // Keep the newest text for when it connects
+            if (presence_queue_wait(queue, &txt, presence_backoff_ms(failures))) {
+                has_txt = true;
+            }
             continue;
         }
 
-        // Copy txt safely
-        char *txt = NULL;
-        info->lock->lock();
-        if (info->txt != NULL) {
-            txt = *info->txt;
-            *info->txt = NULL;
+        lprintf(LOG_INFO, "Connected to Discord after %d failed attempts\n", failures);
+        failures = 0;
+        int interval = PRESENCE_PUMP_MIN_MS;
+        bool active = has_txt;
+
+        while (presence_queue_running(queue)) {
+            if (app.core->run_callbacks(app.core) != DiscordResult_Ok) {
+                lprintf(LOG_WARNING, "Lost connection to Discord\n");
+                has_txt = true; // Set it again once reconnected
+                break;
+            }
+
+            if (has_txt) {
+                dc_set_activity(&app, txt, dc_start_time);
+                has_txt = false;
+            }
+
+            interval = presence_pump_interval_ms(interval, active);
+            active = has_txt = presence_queue_wait(queue, &txt, interval);
         }
-        info->lock->unlock();
-
-        // If txt was set, set the status
-        if (txt != NULL) {
-            lprintf(LOG_INFO, "Set Discord state to %s\n", txt);
-
-            DiscordActivity activity;
-            memset(&activity, 0, sizeof(activity));
-            activity.type = DiscordActivityType_Playing;
-            strncpy(activity.name, PROJECT_NAME, sizeof(activity.name));
-            strncpy(activity.state, "Running a Tournament", sizeof(activity.state));
-            strncpy(activity.details, txt, sizeof(activity.details));
-            strncpy(activity.assets.large_image, DISCORD_LARGE_IMG, sizeof(activity.assets.large_image));
-            activity.timestamps.start = dc_start_time;
-
-            IDiscordActivityManager *act = app.core->get_activity_manager(app.core);
-            act->update_activity(act, &activity, NULL, NULL);
-            free(txt);
+
+        app.core->destroy(app.core);
+        app.core = NULL;
+
+        failures++;
+        if (presence_queue_wait(queue, &txt, presence_backoff_ms(failures))) {
+            has_txt = true;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
+    lprintf(LOG_INFO, "Discord RPC thread stopped.\n");
 }
 
 MainWindow::~MainWindow()
 {
     lprintf(LOG_INFO, "Exiting app\n");
+    preload_queue_free(&this->preloadQueue);
 
-    if (this->dc_info != NULL) {
-        this->dc_info->lock->lock();
-        if (*this->dc_info->txt != NULL) {
-            free(*this->dc_info->txt);
-            *this->dc_info->txt = NULL;
-            this->dc_info->txt = NULL;
-        }
-        this->dc_info->lock->unlock();
-
-        this->dc_info->running = 0;
+    presence_queue_stop(&this->discord_queue);
+    if (this->discord_thread.joinable()) {
         this->discord_thread.join();
-        delete this->dc_info->lock;
-        free(this->dc_info);
     }
 
     delete this->versionLabel;
@@ -237,6 +280,12 @@ void MainWindow::diceRollUtility()
     dlg->show();
 }
 
+void MainWindow::diagnostics()
+{
+    DiagnosticsDialogue *dlg = new DiagnosticsDialogue(this);
+    dlg->show();
+}
+
 void MainWindow::tabChanged(int index)
 {
     if (index == -1) {
@@ -248,6 +297,10 @@ void MainWindow::tabChanged(int index)
     QWidget *widget = ui->tabWidget->widget(index);
     AbstractTabWidget *w = dynamic_cast<AbstractTabWidget *>(widget);
 
+    // Hidden tabs are suspended so, squire_core is only used by the preload
+    // worker while no tournament is shown
+    preload_queue_pause(&this->preloadQueue, dynamic_cast<TournamentTab *>(widget) != nullptr);
+
     for (QMenu *menu : w->getMenus()) {
         ui->menubar->addMenu(menu);
     }
@@ -266,6 +319,12 @@ void MainWindow::closeTab(int index)
     bool canClose = w->canExit();
 
     if (canClose) {
+        // A copy preloaded while it was open may predate its last save
+        TournamentTab *tab = dynamic_cast<TournamentTab *>(widget);
+        if (tab != nullptr) {
+            preload_invalidate(&this->preloadQueue, tab->filePath());
+        }
+
         ui->tabWidget->removeTab(index);
         delete widget;
     } else {
@@ -274,10 +333,12 @@ void MainWindow::closeTab(int index)
     }
 }
 
-void MainWindow::addTab(AbstractTabWidget *w, QString name)
+void MainWindow::addTab(AbstractTabWidget *w, QString name, bool focus)
 {
     ui->tabWidget->addTab(w, name);
-    ui->tabWidget->setCurrentIndex(ui->tabWidget->count() - 1);
+    if (focus) {
+        ui->tabWidget->setCurrentIndex(ui->tabWidget->count() - 1);
+    }
     connect(w, &AbstractTabWidget::close, [this, w]() {
         for (int i = 0; i < ui->tabWidget->count(); i++) {
             QWidget *wid = ui->tabWidget->widget(i);
@@ -288,7 +349,7 @@ void MainWindow::addTab(AbstractTabWidget *w, QString name)
 
 void MainWindow::settings()
 {
-    SettingTab *st = new SettingTab(this->config, ui->tabWidget);
+    SettingTab *st = new SettingTab(this->config, this->configWriter, ui->tabWidget);
     this->addTab(st, tr("Settings"));
 }
 
@@ -319,9 +380,10 @@ void MainWindow::loadTournament()
         QString file = dlg.selectedFiles().at(0);
 
         lprintf(LOG_INFO, "Opening tournament %s\n", file.toStdString().c_str());
-        Tournament *t = load_tournament(file.toStdString());
+        Tournament *t = this->takeTournament(file.toStdString());
         good = t != nullptr;
         if (good) {
+            this->addRecentTournament(t);
             TournamentTab *tourn_tab = new TournamentTab(t, this);
             this->addTab(tourn_tab, getTournamentTabName(t));
         }
@@ -333,12 +395,166 @@ void MainWindow::loadTournament()
     }
 }
 
+// Gets the tournament from the preload queue, it is only loaded now if it was
+// not preloaded.
+Tournament *MainWindow::takeTournament(std::string file)
+{
+    squire_core::sc_TournamentId *tid = (squire_core::sc_TournamentId *) preload_take(&this->preloadQueue, file);
+    if (tid == NULL) {
+        return nullptr;
+    }
+
+    Tournament *ret = tournament_from_id(file, *tid);
+    delete tid;
+    return ret;
+}
+
+// Open tournaments are not preloaded as the tab may save over the copy
+void MainWindow::preloadTournament(QString name)
+{
+    std::string path = name.toStdString();
+    if (this->findTournamentTab(path) != -1) {
+        return;
+    }
+    preload_request(&this->preloadQueue, path);
+}
+
+void MainWindow::preloadRecent()
+{
+    int count = this->config->recent_tournament_count;
+    if (count > 0) {
+        preload_request(&this->preloadQueue, recent_tourn_at(this->config, count - 1)->file_path);
+    }
+}
+
+static std::vector<session_tourn_t>::iterator find_restoring(std::vector<session_tourn_t> &restoring, const std::string &path)
+{
+    return std::find_if(restoring.begin(), restoring.end(), [&path](const session_tourn_t &r) {
+        return r.file_path == path;
+    });
+}
+
+// Every tournament is queued at once and, a tab is added as each one is loaded
+// so the window never waits on the whole session. The loads go through the
+// preload worker so, one file is read at a time and they wait while a
+// tournament tab is shown.
+void MainWindow::restoreSession()
+{
+    FILE *f = fopen(SESSION_FILE, "r");
+    if (f == NULL) {
+        return;
+    }
+
+    session_t s;
+    read_session(f, &s);
+    fclose(f);
+
+    if (s.current != -1) {
+        this->restoreCurrent = s.tourns[s.current].file_path;
+    }
+
+    lprintf(LOG_INFO, "Restoring %lu tournaments from the last session\n", (unsigned long) s.tourns.size());
+    for (session_tourn_t &t : s.tourns) {
+        if (this->findTournamentTab(t.file_path) != -1
+            || find_restoring(this->restoring, t.file_path) != this->restoring.end()) {
+            continue;
+        }
+
+        this->restoring.push_back(t);
+        preload_request_notify(&this->preloadQueue, t.file_path, [this](const std::string &path) {
+            QString file = QString::fromStdString(path);
+            QMetaObject::invokeMethod(this, [this, file]() {
+                this->onSessionTournLoaded(file);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void MainWindow::onSessionTournLoaded(QString file)
+{
+    std::string path = file.toStdString();
+    auto it = find_restoring(this->restoring, path);
+    if (it == this->restoring.end()) {
+        return;
+    }
+
+    session_tourn_t s = *it;
+    this->restoring.erase(it);
+
+    // It was opened by hand while it was loading
+    if (this->findTournamentTab(path) == -1) {
+        Tournament *t = this->takeTournament(path);
+        if (t == nullptr) {
+            lprintf(LOG_ERROR, "Cannot restore tournament %s\n", path.c_str());
+        } else {
+            TournamentTab *tourn_tab = new TournamentTab(t, this);
+            this->addTab(tourn_tab, getTournamentTabName(t), false);
+            tourn_tab->restoreSession(s);
+        }
+    }
+
+    // Showing a tournament pauses the preload worker so, the current one is
+    // only brought to the front once the rest have loaded
+    if (this->restoring.empty() && ui->tabWidget->currentWidget() == this->dashboard) {
+        int index = this->findTournamentTab(this->restoreCurrent);
+        if (index != -1) {
+            ui->tabWidget->setCurrentIndex(index);
+        }
+    }
+}
+
+int MainWindow::findTournamentTab(std::string file)
+{
+    for (int i = 0; i < ui->tabWidget->count(); i++) {
+        TournamentTab *tab = dynamic_cast<TournamentTab *>(ui->tabWidget->widget(i));
+        if (tab != nullptr && tab->filePath() == file) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void MainWindow::saveSession()
+{
+    session_t s;
+    s.current = -1;
+    for (int i = 0; i < ui->tabWidget->count(); i++) {
+        TournamentTab *tab = dynamic_cast<TournamentTab *>(ui->tabWidget->widget(i));
+        if (tab == nullptr) {
+            continue;
+        }
+
+        if (i == ui->tabWidget->currentIndex()) {
+            s.current = s.tourns.size();
+        }
+        s.tourns.push_back(tab->sessionState());
+    }
+
+    // Not loaded yet so, they are kept for the next start
+    for (session_tourn_t &t : this->restoring) {
+        s.tourns.push_back(t);
+    }
+
+    if (save_session(&s, SESSION_FILE)) {
+        lprintf(LOG_INFO, "Saved %lu tournaments to the session\n", (unsigned long) s.tourns.size());
+    } else {
+        lprintf(LOG_ERROR, "Cannot save the session\n");
+    }
+}
+
+void MainWindow::closeEvent(QCloseEvent *event)
+{
+    this->saveSession();
+    QMainWindow::closeEvent(event);
+}
+
 void MainWindow::loadTournamentFromName(QString name)
 {
     bool good;
-    Tournament *t = load_tournament(name.toStdString());
+    Tournament *t = this->takeTournament(name.toStdString());
     good = t != nullptr;
     if (good) {
+        this->addRecentTournament(t);
         TournamentTab *tourn_tab = new TournamentTab(t, this);
         this->addTab(tourn_tab, getTournamentTabName(t));
     } else {
@@ -347,11 +563,12 @@ void MainWindow::loadTournamentFromName(QString name)
     }
 }
 
-void MainWindow::onTournamentAdded(Tournament *t)
+// Opening a tournament that is already in the list only moves it to the top
+void MainWindow::addRecentTournament(Tournament *t)
 {
-    FILE *f = fopen(CONFIG_FILE, "w");
-
     recent_tournament_t recent_t;
+    memset(&recent_t, 0, sizeof(recent_t));
+    recent_t.player_count = -1;
     recent_t.file_path = clone_std_string(t->save_location());
     recent_t.name = clone_std_string(t->name());
     switch(t->pairing_type()) {
@@ -367,14 +584,19 @@ void MainWindow::onTournamentAdded(Tournament *t)
     struct tm *info = localtime(&tim);
     memcpy(&recent_t.last_opened, info, sizeof * info);
 
-    if (f != NULL) {
-        add_recent_tourn(this->config, recent_t, f);
-        fclose(f);
+    if (add_recent_tourn(this->config, recent_t, NULL)) {
+        this->configWriter->requestSave();
     } else {
         lprintf(LOG_ERROR, "Cannot update recently opened list\n");
     }
 
     this->dashboard->onTournamentAdded(recent_t);
+    free_recent_tourn(&recent_t);
+}
+
+void MainWindow::onTournamentAdded(Tournament *t)
+{
+    this->addRecentTournament(t);
 
     TournamentTab *tourn_tab = new TournamentTab(t, this);
     this->addTab(tourn_tab, getTournamentTabName(t));
@@ -1,23 +1,23 @@
 #pragma once
 #include <QMainWindow>
+#include <QCloseEvent>
 #include <QString>
 #include <string>
-#include <mutex>
 #include <thread>
+#include <vector>
 #include "./appdashboardtab.h"
+#include "./configwriter.h"
 #include "../config.h"
+#include "../presence_queue.h"
+#include "../preload_queue.h"
+#include "../session.h"
 #include "../model/abstract_tournament.h"
 
 // Discord stuff
 #define CLIENT_ID 869668721264853022
 #define DISCORD_LARGE_IMG "icon"
 
-typedef struct dc_info_t {
-    char **txt;
-    std::mutex *lock;
-    bool running;
-} dc_info_t;
-void dc_thread(dc_info_t *info);
+void dc_thread(presence_queue_t *queue);
 
 QT_BEGIN_NAMESPACE
 namespace Ui
@@ -33,20 +33,36 @@ class MainWindow : public QMainWindow
 public:
     MainWindow(config_t *t, QWidget *parent = nullptr);
     ~MainWindow();
+    void startDiscord();
+    void preloadRecent(); // Preloads the most recently opened tournament
+    void restoreSession(); // Opens the tournaments from the last session
+protected:
+    void closeEvent(QCloseEvent *event) override;
 
 private:
     Ui::MainWindow *ui;
     config_t *config;
+    ConfigWriter *configWriter;
     AppDashboardTab *dashboard;
 
     // Discord status
-    dc_info_t *dc_info;
+    presence_queue_t discord_queue;
     std::thread discord_thread;
-    char *discord_thread_txt; // free if not-null on set.
+
+    // Tournaments are loaded on a worker, ahead of time if they are hovered
+    preload_queue_t preloadQueue;
+    Tournament *takeTournament(std::string file);
+
+    // Tournaments from the last session that are still loading
+    std::vector<session_tourn_t> restoring;
+    std::string restoreCurrent; // Brought to the front once the session is loaded
+    void saveSession();
+    int findTournamentTab(std::string file); // -1 if it is not open
 
     void addDefaultmenu();
-    void addTab(AbstractTabWidget *w, QString name);
+    void addTab(AbstractTabWidget *w, QString name, bool focus = true);
     QString getTournamentTabName(Tournament *t);
+    void addRecentTournament(Tournament *t);
     QLabel *versionLabel;
 private slots:
     void coinFlipUtility();
@@ -56,6 +72,8 @@ private slots:
     void newTournament();
     void loadTournament();
     void loadTournamentFromName(QString name);
+    void preloadTournament(QString name);
+    void onSessionTournLoaded(QString file);
 
     void tabChanged(int index);
     void closeTab(int index);
@@ -68,4 +86,5 @@ private slots:
     void reportIssue();
     void viewGithub();
     void joinDiscord();
+    void diagnostics();
 };
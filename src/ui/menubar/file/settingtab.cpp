@@ -9,7 +9,7 @@
 
 #define QSPINBOX_INT QOverload<int>::of(&QSpinBox::valueChanged)
 
-SettingTab::SettingTab(config_t *c, QWidget *parent) :
+SettingTab::SettingTab(config_t *c, ConfigWriter *writer, QWidget *parent) :
     AbstractTabWidget(parent),
     ui(new Ui::SettingTab)
 {
@@ -17,6 +17,7 @@ SettingTab::SettingTab(config_t *c, QWidget *parent) :
 
     // Init state
     this->c = c;
+    this->writer = writer;
     this->uiSetSettings();
     this->changed = false;
 
@@ -155,31 +156,28 @@ void SettingTab::onSave()
         tmp_config.default_settings.type = FLUID_TOURN;
     }
 
-    // Free old config then copy new config in
-    free_config(this->c);
-    memcpy(this->c, &tmp_config, sizeof(tmp_config));
+    // Copy the settings in, the user and, recent tournaments are kept
+    free(this->c->tourn_save_path);
+    this->c->tourn_save_path = tmp_config.tourn_save_path;
+    this->c->default_settings = tmp_config.default_settings;
+    this->c->report_crashes = tmp_config.report_crashes;
 
-    FILE *f = fopen(CONFIG_FILE, "w");
-    if (f == NULL) {
-        this->onError(tr("Cannot open file"));
-        return;
-    }
-
-    bool v = write_config(this->c, f);
+    bool v = this->writer->flush();
     if (!v) {
-        this->onError(tr("Cannot encode settings"));
+        this->onError(tr("Cannot save settings"));
     } else {
         this->changed = false;
         lprintf(LOG_INFO, "Saved settings\n");
     }
-    fclose(f);
 }
 
 void SettingTab::onReset()
 {
     config_t tmp_config = DEFAULT_CONFIG;
-    free_config(this->c);
-    memcpy(this->c, &tmp_config, sizeof(tmp_config));
+    free(this->c->tourn_save_path);
+    this->c->tourn_save_path = tmp_config.tourn_save_path;
+    this->c->default_settings = tmp_config.default_settings;
+    this->c->report_crashes = tmp_config.report_crashes;
 
     this->uiSetSettings();
     this->onChange();
@@ -3,6 +3,7 @@
 #include <QAbstractButton>
 #include "../../../config.h"
 #include "../../abstracttabwidget.h"
+#include "../../configwriter.h"
 
 namespace Ui
 {
@@ -14,7 +15,7 @@ class SettingTab : public AbstractTabWidget
     Q_OBJECT
 
 public:
-    explicit SettingTab(config_t *c, QWidget *parent = nullptr);
+    explicit SettingTab(config_t *c, ConfigWriter *writer, QWidget *parent = nullptr);
     ~SettingTab();
 protected:
     void changeEvent(QEvent *e);
@@ -24,6 +25,7 @@ private:
     Ui::SettingTab *ui;
     bool changed;
     config_t *c;
+    ConfigWriter *writer;
     void uiSetSettings();
 private slots:
     void onSave();
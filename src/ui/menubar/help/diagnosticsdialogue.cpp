@@ -0,0 +1,69 @@
+#include "./diagnosticsdialogue.h"
+#include "./ui_diagnosticsdialogue.h"
+#include "../../../stall_watchdog.h"
+#include "../../../ffi_ledger.h"
+#include <QTableWidgetItem>
+
+DiagnosticsDialogue::DiagnosticsDialogue(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::DiagnosticsDialogue)
+{
+    ui->setupUi(this);
+    this->setWindowTitle(tr("Diagnostics"));
+
+    connect(ui->refreshButton, &QPushButton::clicked, this, &DiagnosticsDialogue::refresh);
+    connect(ui->resetButton, &QPushButton::clicked, this, &DiagnosticsDialogue::reset);
+    this->refresh();
+}
+
+DiagnosticsDialogue::~DiagnosticsDialogue()
+{
+    delete ui;
+}
+
+void DiagnosticsDialogue::refresh()
+{
+    std::vector<stall_stats_t> stats = stall_watchdog_stats();
+    ui->thresholdLabel->setText(tr("Event loop stalls of over ")
+                                + QString::number(STALL_THRESHOLD_MS)
+                                + tr("ms by the operation that was running, see the log for backtraces."));
+
+    ui->stallTable->setRowCount(stats.size());
+    for (size_t i = 0; i < stats.size(); i++) {
+        ui->stallTable->setItem(i, 0, new QTableWidgetItem(QString::fromStdString(stats[i].cause)));
+        ui->stallTable->setItem(i, 1, new QTableWidgetItem(QString::number(stats[i].count)));
+        ui->stallTable->setItem(i, 2, new QTableWidgetItem(QString::number(stats[i].total_ms)));
+        ui->stallTable->setItem(i, 3, new QTableWidgetItem(QString::number(stats[i].max_ms)));
+    }
+    ui->stallTable->resizeColumnsToContents();
+
+#ifdef FFI_LEDGER
+    ffi_ledger_stats_t ffi = ffi_ledger_stats();
+    double seconds = ffi.seconds > 0 ? ffi.seconds : 1;
+    ui->ffiLedgerLabel->setText(tr("FFI allocations: ")
+                                + QString::number(ffi.allocs / seconds, 'f', 1) + tr("/s, ")
+                                + QString::number(ffi.alloc_bytes / seconds, 'f', 1) + tr(" bytes/s, ")
+                                + QString::number(ffi.live_allocs) + tr(" live, ")
+                                + QString::number(ffi.bad_frees) + tr(" bad frees"));
+#else
+    ui->ffiLedgerLabel->hide();
+#endif
+}
+
+void DiagnosticsDialogue::reset()
+{
+    stall_watchdog_reset();
+    this->refresh();
+}
+
+void DiagnosticsDialogue::changeEvent(QEvent *e)
+{
+    QDialog::changeEvent(e);
+    switch (e->type()) {
+    case QEvent::LanguageChange:
+        ui->retranslateUi(this);
+        break;
+    default:
+        break;
+    }
+}
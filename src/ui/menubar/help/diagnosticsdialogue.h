@@ -0,0 +1,25 @@
+#pragma once
+#include <QDialog>
+
+namespace Ui
+{
+class DiagnosticsDialogue;
+}
+
+class DiagnosticsDialogue : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DiagnosticsDialogue(QWidget *parent = nullptr);
+    ~DiagnosticsDialogue();
+
+protected:
+    void changeEvent(QEvent *e);
+
+private:
+    Ui::DiagnosticsDialogue *ui;
+private slots:
+    void refresh();
+    void reset();
+};
@@ -1,4 +1,4 @@
-#include <QMessageBox>
+#include <QPushButton>
 #include "./coinsflipdialogue.h"
 #include "./ui_coinsflipdialogue.h"
 #include "../../../coins.h"
@@ -8,12 +8,16 @@ CoinsFlipDialogue::CoinsFlipDialogue(QWidget *parent) :
     ui(new Ui::CoinsFlipDialogue)
 {
     ui->setupUi(this);
+    rng_job_init(&this->job);
+    this->setAttribute(Qt::WA_DeleteOnClose);
     this->setWindowTitle("Flip coins.");
     connect(ui->buttonBox, &QDialogButtonBox::accepted, this, &CoinsFlipDialogue::onOkay);
+    connect(ui->buttonBox, &QDialogButtonBox::rejected, this, &CoinsFlipDialogue::onCancel);
 }
 
 CoinsFlipDialogue::~CoinsFlipDialogue()
 {
+    rng_job_cancel(&this->job);
     delete ui;
 }
 
@@ -29,23 +33,61 @@ void CoinsFlipDialogue::changeEvent(QEvent *e)
     }
 }
 
+void CoinsFlipDialogue::setRunning(bool running)
+{
+    ui->spinBox->setEnabled(!running);
+    ui->krarkBox->setEnabled(!running);
+    ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(!running);
+    ui->progress->setValue(0);
+}
+
 void CoinsFlipDialogue::onOkay()
 {
-    // Flip dice
-    int res;
-    int coins = ui->spinBox->value();
-    QString postfix;
-    if (ui->krarkBox->checkState() == Qt::Checked) {
-        res = flip_krark_coins(coins);
-        postfix = tr(" Krark coins.");
+    // Flip coins
+    long long coins = (long long) ui->spinBox->value();
+    bool krark = ui->krarkBox->checkState() == Qt::Checked;
+
+    // Reports are made on the worker
+    bool r = rng_job_flip_coins(&this->job, coins, krark, [this, krark](rng_progress_t p) {
+        QMetaObject::invokeMethod(this, [this, p, krark]() {
+            this->onProgress(p, krark);
+        }, Qt::QueuedConnection);
+    });
+
+    if (r) {
+        this->setRunning(true);
+        ui->result->setText(tr("Flipping..."));
+    } else {
+        ui->result->setText(tr("Cannot flip coins."));
+    }
+}
+
+void CoinsFlipDialogue::onCancel()
+{
+    if (rng_job_running(&this->job)) {
+        rng_job_cancel(&this->job);
     } else {
-        res = flip_coins(coins);
-        postfix = tr(" coins.");
+        this->reject();
+    }
+}
+
+void CoinsFlipDialogue::onProgress(rng_progress_t p, bool krark)
+{
+    if (!p.finished) {
+        ui->progress->setValue((int) ((1000.0 * p.done) / p.total));
+        ui->result->setText(tr("Flipped %1 of %2 coins, %3 heads so far").arg(p.done).arg(p.total).arg(p.heads));
+        return;
+    }
+
+    rng_job_wait(&this->job);
+    this->setRunning(false);
+    if (p.done < p.total) {
+        ui->result->setText(tr("Cancelled after %1 of %2 coins, %3 heads").arg(p.done).arg(p.total).arg(p.heads));
+        return;
     }
 
-    QString str = tr("You flipped ") + QString::number(res, 10) + postfix;
-    QMessageBox dlg(this);
-    dlg.setText(str);
-    dlg.setWindowTitle(tr("Coin Flip Results"));
-    dlg.exec();
+    QString postfix = krark ? tr(" Krark coins.") : tr(" coins.");
+    QString str = tr("You flipped ") + QString::number(p.heads, 10) + postfix;
+    ui->result->setText(str);
+    ui->progress->setValue(ui->progress->maximum());
 }
@@ -1,11 +1,14 @@
 #pragma once
 #include <QDialog>
+#include "../../../rng_job.h"
 
 namespace Ui
 {
 class CoinsFlipDialogue;
 }
 
+// The coins are flipped on a worker so the window stays usable, the dialogue
+// is deleted when it is closed
 class CoinsFlipDialogue : public QDialog
 {
     Q_OBJECT
@@ -19,7 +22,10 @@ protected:
 
 private:
     Ui::CoinsFlipDialogue *ui;
+    rng_job_t job;
+    void setRunning(bool running);
+    void onProgress(rng_progress_t p, bool krark);
 private slots:
     void onOkay();
+    void onCancel();
 };
-
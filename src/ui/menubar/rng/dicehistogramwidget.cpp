@@ -0,0 +1,98 @@
+#include "./dicehistogramwidget.h"
+#include "../../../trace.h"
+#include <QFontMetrics>
+#include <QPainter>
+#include <QScrollBar>
+#include <QtGlobal>
+#include <algorithm>
+
+static QString row_label(dice_roll_res_line_t line)
+{
+    return QString::number(line.side_number, 10) + " | " + QString::number(line.number_rolled, 10);
+}
+
+DiceHistogramWidget::DiceHistogramWidget(dice_roll_ret_t rolls, long long maxRolled, QWidget *parent) :
+    QAbstractScrollArea(parent)
+{
+    this->rolls = rolls;
+    this->maxRolled = maxRolled;
+
+    // The widest label has the most digits, the largest side is the last one
+    dice_roll_res_line_t widest = {rolls.sides, maxRolled};
+#if QT_VERSION >= 0x050b00
+    this->labelWidth = this->fontMetrics().horizontalAdvance(row_label(widest)) + 2 * DICE_HISTOGRAM_PADDING;
+#else
+    this->labelWidth = this->fontMetrics().width(row_label(widest)) + 2 * DICE_HISTOGRAM_PADDING;
+#endif
+
+    this->verticalScrollBar()->setSingleStep(1);
+    this->updateScrollBar();
+}
+
+DiceHistogramWidget::~DiceHistogramWidget()
+{
+
+}
+
+QSize DiceHistogramWidget::sizeHint() const
+{
+    return QSize(this->labelWidth * 4, this->rowHeight() * 20);
+}
+
+int DiceHistogramWidget::rowHeight() const
+{
+    return this->fontMetrics().height() + 2 * DICE_HISTOGRAM_PADDING;
+}
+
+// The scroll bar counts rows, not pixels
+void DiceHistogramWidget::updateScrollBar()
+{
+    int visible = std::max(1, this->viewport()->height() / this->rowHeight());
+    this->verticalScrollBar()->setPageStep(visible);
+    this->verticalScrollBar()->setRange(0, std::max(0, this->rolls.sides - visible));
+}
+
+void DiceHistogramWidget::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    this->updateScrollBar();
+}
+
+void DiceHistogramWidget::scrollContentsBy(int dx, int dy)
+{
+    this->viewport()->update();
+}
+
+void DiceHistogramWidget::paintEvent(QPaintEvent *event)
+{
+    TRACE_SPAN("dice_histogram_paint", TRACE_CAT_UI);
+    QPainter painter(this->viewport());
+    int height = this->rowHeight();
+    int width = this->viewport()->width();
+    int barWidth = width - this->labelWidth - DICE_HISTOGRAM_PADDING;
+
+    int first = this->verticalScrollBar()->value();
+    int last = std::min(this->rolls.sides, first + this->viewport()->height() / height + 1);
+    for (int i = first; i < last; i++) {
+        dice_roll_res_line_t line = this->rolls.results[i];
+        int y = (i - first) * height;
+
+        painter.setPen(this->palette().color(QPalette::Text));
+        painter.drawText(QRect(DICE_HISTOGRAM_PADDING, y, this->labelWidth, height),
+                         Qt::AlignLeft | Qt::AlignVCenter,
+                         row_label(line));
+
+        if (this->maxRolled <= 0 || barWidth <= 0) {
+            continue;
+        }
+
+        int w = (int) ((((double) line.number_rolled) / this->maxRolled) * barWidth);
+        painter.fillRect(QRect(this->labelWidth, y + DICE_HISTOGRAM_PADDING, w, height - 2 * DICE_HISTOGRAM_PADDING),
+                         this->palette().color(QPalette::Highlight));
+
+        QString percent = QString::number((100.0 * line.number_rolled) / this->rolls.dice_rolled, 'f', 2) + "%";
+        painter.drawText(QRect(this->labelWidth, y, barWidth, height),
+                         Qt::AlignRight | Qt::AlignVCenter,
+                         percent);
+    }
+}
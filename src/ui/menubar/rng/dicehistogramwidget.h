@@ -0,0 +1,32 @@
+#pragma once
+#include <QAbstractScrollArea>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include "../../../coins.h"
+
+#define DICE_HISTOGRAM_PADDING 4
+
+// Paints one row per side of the die, only the rows that are on screen are
+// drawn so any number of sides opens at once. The rolls must outlive it.
+class DiceHistogramWidget : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit DiceHistogramWidget(dice_roll_ret_t rolls, long long maxRolled, QWidget *parent = nullptr);
+    ~DiceHistogramWidget();
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    int rowHeight() const;
+    void updateScrollBar();
+
+    dice_roll_ret_t rolls;
+    long long maxRolled;
+    int labelWidth;
+};
@@ -1,4 +1,5 @@
 #include <QMessageBox>
+#include <QPushButton>
 #include "./dicerolldialogue.h"
 #include "./ui_dicerolldialogue.h"
 #include "./dicerollresultdialogue.h"
@@ -9,13 +10,17 @@ DiceRollDialogue::DiceRollDialogue(QWidget *parent) :
     ui(new Ui::DiceRollDialogue)
 {
     ui->setupUi(this);
+    rng_job_init(&this->job);
+    this->setAttribute(Qt::WA_DeleteOnClose);
     this->setWindowTitle(tr("Roll Dice"));
 
     connect(ui->buttonBox, &QDialogButtonBox::accepted, this, &DiceRollDialogue::onOkay);
+    connect(ui->buttonBox, &QDialogButtonBox::rejected, this, &DiceRollDialogue::onCancel);
 }
 
 DiceRollDialogue::~DiceRollDialogue()
 {
+    rng_job_cancel(&this->job);
     delete ui;
 }
 
@@ -31,25 +36,74 @@ void DiceRollDialogue::changeEvent(QEvent *e)
     }
 }
 
+void DiceRollDialogue::setRunning(bool running)
+{
+    ui->sidesSpinBox->setEnabled(!running);
+    ui->numberSpinBox->setEnabled(!running);
+    ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(!running);
+    ui->progress->setValue(0);
+}
+
 void DiceRollDialogue::onOkay()
 {
     // Roll dice
     int sides = ui->sidesSpinBox->value();
-    int number = ui->numberSpinBox->value();
+    long long number = (long long) ui->numberSpinBox->value();
 
-    int status;
-    dice_roll_ret_t ret = roll_dice(sides, number, &status);
+    // Reports are made on the worker
+    bool r = rng_job_roll_dice(&this->job, sides, number, [this](rng_progress_t p) {
+        QMetaObject::invokeMethod(this, [this, p]() {
+            this->onProgress(p);
+        }, Qt::QueuedConnection);
+    });
 
-    if (!status) {
+    if (!r) {
         QMessageBox dlg(this);
         dlg.setText(tr("Cannot roll dice."));
         dlg.setWindowTitle(tr("Error"));
-        dlg.show();
+        dlg.exec();
+        return;
+    }
+
+    this->setRunning(true);
+    ui->result->setText(tr("Rolling..."));
+}
+
+void DiceRollDialogue::onCancel()
+{
+    if (rng_job_running(&this->job)) {
+        rng_job_cancel(&this->job);
+    } else {
+        this->reject();
+    }
+}
+
+void DiceRollDialogue::onProgress(rng_progress_t p)
+{
+    if (!p.finished) {
+        // The mean of the dice so far is shown while it rolls
+        double sum = 0;
+        for (dice_roll_res_line_t &f : p.faces) {
+            sum += (double) f.side_number * f.number_rolled;
+        }
+
+        ui->progress->setValue((int) ((1000.0 * p.done) / p.total));
+        ui->result->setText(tr("Rolled %1 of %2 dice, mean %3").arg(p.done).arg(p.total).arg(p.done > 0 ? sum / p.done : 0, 0, 'f', 3));
         return;
     }
 
+    this->setRunning(false);
+    dice_roll_ret_t ret;
+    if (!rng_job_take_dice(&this->job, &ret)) {
+        ui->result->setText(tr("Cancelled after %1 of %2 dice").arg(p.done).arg(p.total));
+        return;
+    }
+
+    ui->result->setText("");
+    ui->progress->setValue(ui->progress->maximum());
+
     // Create the distribution model dialogue
-    if (number == 1) {
+    if (ret.dice_rolled == 1) {
         QMessageBox dlg(this);
         dlg.setWindowTitle(tr("Your Dice Results"));
 
@@ -70,4 +124,3 @@ void DiceRollDialogue::onOkay()
 
     free_dice_roll_ret(ret);
 }
-
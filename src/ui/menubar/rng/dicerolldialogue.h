@@ -1,11 +1,14 @@
 #pragma once
 #include <QDialog>
+#include "../../../rng_job.h"
 
 namespace Ui
 {
 class DiceRollDialogue;
 }
 
+// The dice are rolled on a worker so the window stays usable, the dialogue is
+// deleted when it is closed
 class DiceRollDialogue : public QDialog
 {
     Q_OBJECT
@@ -19,7 +22,10 @@ protected:
 
 private:
     Ui::DiceRollDialogue *ui;
+    rng_job_t job;
+    void setRunning(bool running);
+    void onProgress(rng_progress_t p);
 private slots:
     void onOkay();
+    void onCancel();
 };
-
@@ -1,6 +1,8 @@
 #include "./dicerollresultdialogue.h"
 #include "./ui_dicerollresultdialogue.h"
-#include "./dicerollresultwidget.h"
+#include "./dicehistogramwidget.h"
+#include "../../../rng_stats.h"
+#include <QVBoxLayout>
 
 DiceRollResultDialogue::DiceRollResultDialogue(dice_roll_ret_t rolls, QWidget *parent) :
     QDialog(parent),
@@ -12,15 +14,20 @@ DiceRollResultDialogue::DiceRollResultDialogue(dice_roll_ret_t rolls, QWidget *p
                          tr("D") +
                          QString::number(rolls.sides, 10));
 
+    dice_stats_t stats = dice_roll_stats(rolls);
+    QString p = stats.p_value == RNG_STATS_NOT_APPLICABLE ? tr("N/a") : QString::number(stats.p_value, 'g', 4);
+    ui->stats->setText(tr("Mean: %1 (fair: %2) | Variance: %3 (fair: %4) | Chi-square: %5, %6 degrees of freedom, p = %7")
+                       .arg(stats.mean, 0, 'f', 3)
+                       .arg(stats.expected_mean, 0, 'f', 3)
+                       .arg(stats.variance, 0, 'f', 3)
+                       .arg(stats.expected_variance, 0, 'f', 3)
+                       .arg(stats.chi_sq, 0, 'f', 3)
+                       .arg(stats.dof)
+                       .arg(p));
+
     QVBoxLayout *layout = new QVBoxLayout(ui->diceRollResults);
-    layout->setAlignment(Qt::AlignTop);
-    for (int i = 0; i < rolls.sides; i++) {
-        DiceRollResultWidget *w = new DiceRollResultWidget(rolls.results[i].side_number,
-                rolls.results[i].number_rolled,
-                rolls.dice_rolled,
-                this);
-        layout->addWidget(w);
-    }
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(new DiceHistogramWidget(rolls, stats.max_rolled, this));
 }
 
 DiceRollResultDialogue::~DiceRollResultDialogue()
@@ -11,6 +11,7 @@ PlayerViewWidget::PlayerViewWidget(Tournament *tourn, QWidget *parent) :
 
     this->tourn = tourn;
     this->playerSelected = false;
+    this->suspended = false;
     this->player = Player();
 
     // Init the tables
@@ -21,6 +22,12 @@ PlayerViewWidget::PlayerViewWidget(Tournament *tourn, QWidget *parent) :
     this->roundTable = new SearchSortTableWidget<RoundModel, Round>(rounds);
     this->roundTableLayout->addWidget(roundTable);
 
+    this->displayView = this->updates.addView([this]() {
+        if (!this->suspended) {
+            this->displayPlayer();
+        }
+    });
+
     connect(this->tourn, &Tournament::onPlayersChanged, this, &PlayerViewWidget::onPlayersChanged);
     connect(&this->timeLeftUpdater, &QTimer::timeout, this, &PlayerViewWidget::displayTime);
     connect(this->roundTable->selectionModel(), &QItemSelectionModel::selectionChanged, this, &PlayerViewWidget::onRoundSelected);
@@ -72,7 +79,9 @@ void PlayerViewWidget::displayPlayer()
 {
     QString status = tr("No Player Selected");
     if (this->playerSelected) {
-        this->timeLeftUpdater.start(100);
+        if (!this->suspended) {
+            this->timeLeftUpdater.start(100);
+        }
         status = this->getStatusString();
         this->roundTable->setData(this->tourn->playerRounds(this->player));
     } else {
@@ -83,6 +92,18 @@ void PlayerViewWidget::displayPlayer()
     ui->playerStatus->setText(status);
 }
 
+void PlayerViewWidget::suspend()
+{
+    this->suspended = true;
+    this->timeLeftUpdater.stop();
+}
+
+void PlayerViewWidget::resume()
+{
+    this->suspended = false;
+    this->displayPlayer();
+}
+
 void PlayerViewWidget::setPlayer(Player player)
 {
     this->player = player;
@@ -90,6 +111,14 @@ void PlayerViewWidget::setPlayer(Player player)
     this->displayPlayer();
 }
 
+bool PlayerViewWidget::currentPlayer(Player *ret)
+{
+    if (this->playerSelected) {
+        *ret = this->player;
+    }
+    return this->playerSelected;
+}
+
 void PlayerViewWidget::onRoundSelected(const QItemSelection &selected, const QItemSelection deselected)
 {
     QModelIndexList indexes = selected.indexes();
@@ -102,7 +131,10 @@ void PlayerViewWidget::onRoundSelected(const QItemSelection &selected, const QIt
 
 void PlayerViewWidget::onPlayersChanged(std::vector<Player> players)
 {
-    this->displayPlayer();
+    if (this->suspended) {
+        return; // Redisplayed on resume
+    }
+    this->updates.markDirty(this->displayView);
 }
 
 void PlayerViewWidget::dropPlayer()
@@ -8,6 +8,7 @@
 #include "../../model/round.h"
 #include "../abstractmodels/roundmodel.h"
 #include "../widgets/searchsorttablewidget.h"
+#include "../updatescheduler.h"
 
 namespace Ui
 {
@@ -21,6 +22,10 @@ class PlayerViewWidget : public QWidget
 public:
     explicit PlayerViewWidget(Tournament *tourn, QWidget *parent = nullptr);
     ~PlayerViewWidget();
+    // Stops the timer while the tab is hidden, resume redisplays the player
+    void suspend();
+    void resume();
+    bool currentPlayer(Player *ret); // False when no player is selected
 signals:
     void roundSelected(Round round);
 public slots:
@@ -42,5 +47,8 @@ private:
     Tournament *tourn;
     Player player;
     bool playerSelected;
+    bool suspended;
+    UpdateScheduler updates;
+    int displayView;
 };
 
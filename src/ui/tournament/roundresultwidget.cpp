@@ -6,7 +6,11 @@ RoundResultWidget::RoundResultWidget(RoundResults *results, Player player, QWidg
     ui(new Ui::RoundResultWidget)
 {
     ui->setupUi(this);
+    this->setResult(results, player);
+}
 
+void RoundResultWidget::setResult(RoundResults *results, Player player)
+{
     this->p = player;
     this->results = results;
 
@@ -14,6 +14,8 @@ class RoundResultWidget : public QWidget
 public:
     explicit RoundResultWidget(RoundResults *results, Player player, QWidget *parent = nullptr);
     ~RoundResultWidget();
+    // Rebinds the widget so that it can be reused for another player
+    void setResult(RoundResults *results, Player player);
     int newWins();
     bool confirmed();
     Player player();
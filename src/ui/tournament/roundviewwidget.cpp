@@ -1,5 +1,6 @@
 #include "./roundviewwidget.h"
 #include "./ui_roundviewwidget.h"
+#include "../../trace.h"
 #include <QMessageBox>
 
 RoundViewWidget::RoundViewWidget(Tournament *tourn, QWidget *parent) :
@@ -9,6 +10,8 @@ RoundViewWidget::RoundViewWidget(Tournament *tourn, QWidget *parent) :
     ui->setupUi(this);
     this->tourn = tourn;
     this->roundSelected = false;
+    this->activeResults = 0;
+    this->suspended = false;
 
     // Init the tables
     this->playerTableLayout = new QVBoxLayout(ui->playerInRoundTable);
@@ -22,10 +25,15 @@ RoundViewWidget::RoundViewWidget(Tournament *tourn, QWidget *parent) :
     this->resultsLayout = new QVBoxLayout(ui->resultEntryWidget);
     this->resultsLayout->setAlignment(Qt::AlignTop);
 
+    this->displayView = this->updates.addView([this]() {
+        if (!this->suspended) {
+            this->displayRound();
+        }
+    });
+
     connect(this->tourn, &Tournament::onPlayersChanged, this, &RoundViewWidget::onPlayersChanged);
     connect(&this->timeLeftUpdater, &QTimer::timeout, this, &RoundViewWidget::displayTime);
     connect(this->playerTable->selectionModel(), &QItemSelectionModel::selectionChanged, this, &RoundViewWidget::onPlayerSelected);
-    this->results = new RoundResults();
     this->displayRound();
 
     connect(ui->saveResults, &QPushButton::clicked, this, &RoundViewWidget::onResultsSave);
@@ -40,7 +48,6 @@ RoundViewWidget::~RoundViewWidget()
         this->resultsLayout->removeWidget(w);
         delete w;
     }
-    delete results;
 
     delete playerTable;
     delete playerTableLayout;
@@ -73,18 +80,37 @@ QString RoundViewWidget::matchNumberToStr(int number)
 
 void RoundViewWidget::rerender()
 {
+    this->updates.markDirty(this->displayView);
+}
+
+void RoundViewWidget::suspend()
+{
+    this->suspended = true;
+    this->timeLeftUpdater.stop();
+    this->results = RoundResults();
+}
+
+void RoundViewWidget::resume()
+{
+    this->suspended = false;
     this->displayRound();
 }
 
 void RoundViewWidget::displayRound()
 {
+    TRACE_SPAN("RoundViewWidget::displayRound", TRACE_CAT_UI);
     // Genereate state strings
     QString statusStr = tr("No Match Selected");
     QString numberStr = tr("Match #--");
 
+    std::vector<Player> players;
     if (this->roundSelected) {
-        this->timeLeftUpdater.start(100);
-        this->playerTable->setData(this->round.players());
+        if (!this->suspended) {
+            this->timeLeftUpdater.start(100);
+        }
+        this->results.refresh(this->round);
+        players = this->results.players();
+        this->playerTable->setData(players);
         numberStr = matchNumberToStr(this->round.match_number());
 
         // Status
@@ -103,7 +129,8 @@ void RoundViewWidget::displayRound()
             break;
         }
     } else {
-        this->playerTable->setData(std::vector<Player>());
+        this->results = RoundResults();
+        this->playerTable->setData(players);
     }
 
     this->displayTime();
@@ -112,23 +139,25 @@ void RoundViewWidget::displayRound()
     ui->matchNumber->setText(numberStr);
     ui->roundStatus->setText(statusStr);
 
-    // Results
-    for (RoundResultWidget *w : this->resultWidgets) {
-        this->resultsLayout->removeWidget(w);
-        delete w;
+    // Results, the pooled widgets are rebound rather than rebuilt and, the pool
+    // only grows when a round has more players than any before it
+    for (size_t i = 0; i < players.size(); i++) {
+        if (i < this->resultWidgets.size()) {
+            this->resultWidgets[i]->setResult(&this->results, players[i]);
+        } else {
+            RoundResultWidget *w = new RoundResultWidget(&this->results, players[i], this);
+            this->resultWidgets.push_back(w);
+            this->resultsLayout->addWidget(w);
+        }
+        this->resultWidgets[i]->show();
     }
-    delete this->results;
-
-    this->resultWidgets = std::vector<RoundResultWidget *>();
-    this->results = new RoundResults(this->round);
 
-    for (Player p : this->round.players()) {
-        RoundResultWidget *w = new RoundResultWidget(this->results, p, this);
-        this->resultWidgets.push_back(w);
-        this->resultsLayout->addWidget(w);
+    for (size_t i = players.size(); i < this->resultWidgets.size(); i++) {
+        this->resultWidgets[i]->hide();
     }
+    this->activeResults = players.size();
 
-    ui->drawsEdit->setValue(this->results->draws());
+    ui->drawsEdit->setValue(this->results.draws());
 }
 
 void RoundViewWidget::displayTime()
@@ -191,7 +220,10 @@ void RoundViewWidget::displayTime()
 
 void RoundViewWidget::onPlayersChanged(std::vector<Player>)
 {
-    this->displayRound();
+    if (this->suspended) {
+        return; // Redisplayed on resume
+    }
+    this->updates.markDirty(this->displayView);
 }
 
 void RoundViewWidget::setRound(Round round)
@@ -201,6 +233,14 @@ void RoundViewWidget::setRound(Round round)
     this->displayRound();
 }
 
+bool RoundViewWidget::currentRound(Round *ret)
+{
+    if (this->roundSelected) {
+        *ret = this->round;
+    }
+    return this->roundSelected;
+}
+
 void RoundViewWidget::onPlayerSelected(const QItemSelection &selected, const QItemSelection deselected)
 {
     QModelIndexList indexes = selected.indexes();
@@ -223,7 +263,7 @@ void RoundViewWidget::onResultsSave()
     std::vector<int> wins;
     std::vector<bool> confirms;
 
-    for (size_t i = 0; i < this->resultWidgets.size(); i++) {
+    for (size_t i = 0; i < this->activeResults; i++) {
         RoundResultWidget *w = this->resultWidgets[i];
         bool confirmed = w->confirmed();
         int winc = w->newWins();
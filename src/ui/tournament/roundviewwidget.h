@@ -8,6 +8,7 @@
 #include "../widgets/searchsorttablewidget.h"
 #include "../abstractmodels/playermodel.h"
 #include "./roundresultwidget.h"
+#include "../updatescheduler.h"
 
 namespace Ui
 {
@@ -22,6 +23,11 @@ public:
     explicit RoundViewWidget(Tournament *tourn, QWidget *parent = nullptr);
     ~RoundViewWidget();
     void rerender();
+    // Stops the timer and, drops the results while the tab is hidden, resume
+    // reads the round again
+    void suspend();
+    void resume();
+    bool currentRound(Round *ret); // False when no round is selected
 signals:
     void playerSelected(Player player);
 public slots:
@@ -48,7 +54,12 @@ private:
     Tournament *tourn;
     Round round;
     bool roundSelected;
-    RoundResults *results;
+    bool suspended;
+    UpdateScheduler updates;
+    int displayView;
+    RoundResults results;
+    // A pool of result widgets, only the first activeResults are shown
     std::vector<RoundResultWidget *> resultWidgets;
+    size_t activeResults;
 };
 
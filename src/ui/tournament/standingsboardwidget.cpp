@@ -1,5 +1,7 @@
 #include "./standingsboardwidget.h"
 #include "./ui_standingsboardwidget.h"
+#include "../../trace.h"
+#include <algorithm>
 
 StandingsBoardWidget::StandingsBoardWidget(Tournament *tourn, QWidget *parent) :
     QDialog(parent),
@@ -18,7 +20,10 @@ StandingsBoardWidget::StandingsBoardWidget(Tournament *tourn, QWidget *parent) :
     this->table = new SearchSortTableWidget<PlayerScoreModel, PlayerScore>(playerScores);
     this->tableLayout->addWidget(this->table);
 
-    this->redrawStandingsBoard();
+    // Redrawn when first shown
+    this->dirty = true;
+    this->redrawTimer.setSingleShot(true);
+    connect(&this->redrawTimer, &QTimer::timeout, this, &StandingsBoardWidget::redrawStandingsBoard);
     connect(this->tourn, &Tournament::onRoundsChanged, this, &StandingsBoardWidget::roundsChanged);
     connect(this->tourn, &Tournament::onPlayersChanged, this, &StandingsBoardWidget::playersChanged);
 }
@@ -40,17 +45,43 @@ void StandingsBoardWidget::changeEvent(QEvent *e)
     }
 }
 
+void StandingsBoardWidget::showEvent(QShowEvent *e)
+{
+    QDialog::showEvent(e);
+    if (this->dirty) {
+        this->scheduleRedraw();
+    }
+}
+
 void StandingsBoardWidget::redrawStandingsBoard()
 {
+    TRACE_SPAN("StandingsBoardWidget::redrawStandingsBoard", TRACE_CAT_UI);
+    this->dirty = false;
+    this->lastRedraw.restart();
     this->table->setData(this->tourn->standings());
 }
 
+void StandingsBoardWidget::scheduleRedraw()
+{
+    this->dirty = true;
+    // A hidden board is redrawn when it is shown again
+    if (!this->isVisible() || this->redrawTimer.isActive()) {
+        return;
+    }
+
+    qint64 wait = 0;
+    if (this->lastRedraw.isValid()) {
+        wait = std::max<qint64>(0, STANDINGS_MIN_INTERVAL_MS - this->lastRedraw.elapsed());
+    }
+    this->redrawTimer.start(wait);
+}
+
 void StandingsBoardWidget::roundsChanged(std::vector<Round>)
 {
-    this->redrawStandingsBoard();
+    this->scheduleRedraw();
 }
 
 void StandingsBoardWidget::playersChanged(std::vector<Player>)
 {
-    this->redrawStandingsBoard();
+    this->scheduleRedraw();
 }
@@ -1,11 +1,16 @@
 #pragma once
 #include <QDialog>
+#include <QTimer>
+#include <QElapsedTimer>
 #include "../../model/abstract_tournament.h"
 #include "../../model/round.h"
 #include "../../model/player.h"
 #include "../widgets/searchsorttablewidget.h"
 #include "../abstractmodels/playerscoremodel.h"
 
+// The standings are recomputed at most this often, changes in between are batched
+#define STANDINGS_MIN_INTERVAL_MS 1000
+
 namespace Ui
 {
 class StandingsBoardWidget;
@@ -23,12 +28,17 @@ public slots:
     void playersChanged(std::vector<Player>);
 protected:
     void changeEvent(QEvent *e);
+    void showEvent(QShowEvent *e) override;
 private:
     void redrawStandingsBoard();
+    void scheduleRedraw();
 
     QVBoxLayout *tableLayout;
     SearchSortTableWidget<PlayerScoreModel, PlayerScore> *table;
     Ui::StandingsBoardWidget *ui;
     Tournament *tourn;
+    QTimer redrawTimer;
+    QElapsedTimer lastRedraw;
+    bool dirty; // The tournament changed since the last redraw
 };
 
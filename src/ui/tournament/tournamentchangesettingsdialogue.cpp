@@ -1,6 +1,6 @@
 #include "tournamentchangesettingsdialogue.h"
 #include "ui_tournamentchangesettingsdialogue.h"
-#include "../../../testing_h/logger.h"
+#include "../../async_log.h"
 #include <QMessageBox>
 #include <squire_core/squire_core.h>
 
@@ -5,6 +5,7 @@
 #include "./tournament/tournamentunsavederrordialogue.h"
 #include "./tournament/standingsboardwidget.h"
 #include "../config.h"
+#include "../trace.h"
 #include <QDialogButtonBox>
 #include <QMessageBox>
 
@@ -14,6 +15,7 @@ TournamentTab::TournamentTab(Tournament *tourn, QWidget *parent) :
 {
     ui->setupUi(this);
     this->tourn = tourn;
+    this->stale = false;
     if (!this->tourn->isSaved()) {
         this->tourn->save();
     }
@@ -46,10 +48,28 @@ TournamentTab::TournamentTab(Tournament *tourn, QWidget *parent) :
 
     this->playerViewWidget = new PlayerViewWidget(this->tourn, this);
     ui->infoTabWidget->addTab(this->playerViewWidget, tr("Player Info"));
+    this->standingsBoard = nullptr;
 
     connect(this->roundViewWidget, &RoundViewWidget::playerSelected, this->playerViewWidget, &PlayerViewWidget::setPlayer);
     connect(this->playerViewWidget, &PlayerViewWidget::roundSelected, this->roundViewWidget, &RoundViewWidget::setRound);
 
+    // Changes are batched and, drawn at most once a frame
+    this->playerTableView = this->updates.addView([this]() {
+        this->flushView([this]() {
+            this->playerTable->setData(this->tourn->players());
+        });
+    });
+    this->roundTableView = this->updates.addView([this]() {
+        this->flushView([this]() {
+            this->roundTable->setData(this->tourn->rounds());
+        });
+    });
+    this->roundTimerView = this->updates.addView([this]() {
+        if (!this->isSuspended()) {
+            this->updateRoundTimer();
+        }
+    });
+
     // Connect all slots
     connect(this->tourn, &Tournament::onPlayerAdded, this, &TournamentTab::onPlayerAdded);
     connect(this->tourn, &Tournament::onPlayersChanged, this, &TournamentTab::onPlayersChanged);
@@ -95,9 +115,19 @@ TournamentTab::TournamentTab(Tournament *tourn, QWidget *parent) :
     QAction *showStandingsAction = tournamentsMenu->addAction(tr("Show Standings"));
     connect(showStandingsAction, &QAction::triggered, this, &TournamentTab::showStandings);
 
-    // Start timer
-    connect(&this->timeLeftUpdater, &QTimer::timeout, this, &TournamentTab::updateRoundTimer);
-    this->updateRoundTimer();
+    // The timer is started when the tab is shown
+    connect(&this->timeLeftUpdater, &QTimer::timeout, this, [this]() {
+        this->updates.markDirty(this->roundTimerView);
+    });
+}
+
+void TournamentTab::flushView(std::function<void()> flush)
+{
+    if (this->isSuspended()) {
+        this->stale = true;
+        return;
+    }
+    flush();
 }
 
 TournamentTab::~TournamentTab()
@@ -107,11 +137,57 @@ TournamentTab::~TournamentTab()
     delete playerTableLayout;
     delete roundTable;
     delete roundTableLayout;
+    delete standingsBoard;
     delete tourn;
     delete roundViewWidget;
     delete playerViewWidget;
 }
 
+std::string TournamentTab::filePath()
+{
+    return this->tourn->save_location();
+}
+
+session_tourn_t TournamentTab::sessionState()
+{
+    session_tourn_t ret;
+    ret.file_path = this->tourn->save_location();
+    ret.round_number = -1;
+
+    Round rnd;
+    if (this->roundViewWidget->currentRound(&rnd)) {
+        ret.round_number = rnd.match_number();
+    }
+
+    Player plyr;
+    if (this->playerViewWidget->currentPlayer(&plyr)) {
+        ret.player_name = plyr.name();
+    }
+    return ret;
+}
+
+// Rounds and, players that no longer exist are ignored
+void TournamentTab::restoreSession(session_tourn_t s)
+{
+    if (s.round_number != -1) {
+        for (Round &rnd : this->tourn->rounds()) {
+            if (rnd.match_number() == s.round_number) {
+                this->roundViewWidget->setRound(rnd);
+                break;
+            }
+        }
+    }
+
+    if (s.player_name != "") {
+        for (Player &plyr : this->tourn->players()) {
+            if (plyr.name() == s.player_name) {
+                this->playerViewWidget->setPlayer(plyr);
+                break;
+            }
+        }
+    }
+}
+
 void TournamentTab::changeEvent(QEvent *e)
 {
     QWidget::changeEvent(e);
@@ -124,6 +200,28 @@ void TournamentTab::changeEvent(QEvent *e)
     }
 }
 
+void TournamentTab::onTabShown()
+{
+    TRACE_SPAN("TournamentTab::onTabShown", TRACE_CAT_UI);
+    if (this->stale) {
+        this->updates.markDirty(this->playerTableView);
+        this->updates.markDirty(this->roundTableView);
+        this->stale = false;
+    }
+
+    this->roundViewWidget->resume();
+    this->playerViewWidget->resume();
+    this->updates.markDirty(this->roundTimerView);
+    this->timeLeftUpdater.start(TOURNAMENT_TAB_TIMER_MS);
+}
+
+void TournamentTab::onTabHidden()
+{
+    this->timeLeftUpdater.stop();
+    this->roundViewWidget->suspend();
+    this->playerViewWidget->suspend();
+}
+
 void TournamentTab::closeTab()
 {
     emit this->close();
@@ -155,25 +253,41 @@ bool TournamentTab::canExit()
 
 void TournamentTab::onPlayerAdded(Player p)
 {
-    this->playerTable->addDatum(p);
+    if (this->isSuspended()) {
+        this->stale = true;
+        return;
+    }
+    this->updates.markDirty(this->playerTableView);
 }
 
 void TournamentTab::onPlayersChanged(std::vector<Player> players)
 {
-    this->playerTable->setData(this->tourn->players());
+    if (this->isSuspended()) {
+        this->stale = true;
+        return;
+    }
+    this->updates.markDirty(this->playerTableView);
 }
 
 void TournamentTab::onRoundAdded(Round r)
 {
-    this->roundTable->addDatum(r);
-    updateRoundTimer();
+    if (this->isSuspended()) {
+        this->stale = true;
+        return;
+    }
+    this->updates.markDirty(this->roundTableView);
+    this->updates.markDirty(this->roundTimerView);
 }
 
 void TournamentTab::onRoundsChanged(std::vector<Round> rounds)
 {
-    this->roundTable->setData(rounds);
+    if (this->isSuspended()) {
+        this->stale = true;
+        return;
+    }
+    this->updates.markDirty(this->roundTableView);
+    this->updates.markDirty(this->roundTimerView);
     this->roundViewWidget->rerender();
-    updateRoundTimer();
 }
 
 void TournamentTab::onNameChanged(std::string str)
@@ -281,6 +395,7 @@ void TournamentTab::addPlayerClicked()
 
 void TournamentTab::updateRoundTimer()
 {
+    TRACE_SPAN("TournamentTab::updateRoundTimer", TRACE_CAT_UI);
     int roundCount = 0;
     long max = 0;
     long min = -1;
@@ -341,7 +456,6 @@ void TournamentTab::updateRoundTimer()
     } else {
         ui->progressBar->setValue((100 * min) / max);
     }
-    this->timeLeftUpdater.start(100);
 }
 
 void TournamentTab::pairRoundsClicked()
@@ -413,6 +527,11 @@ void TournamentTab::confirmAllMatches()
 
 void TournamentTab::showStandings()
 {
-    StandingsBoardWidget *w = new StandingsBoardWidget(this->tourn, this);
-    w->show();
+    if (this->standingsBoard == nullptr) {
+        this->standingsBoard = new StandingsBoardWidget(this->tourn, this);
+    }
+
+    this->standingsBoard->show();
+    this->standingsBoard->raise();
+    this->standingsBoard->activateWindow();
 }
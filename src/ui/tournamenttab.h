@@ -7,10 +7,17 @@
 #include "./abstractmodels/roundmodel.h"
 #include "./tournament/roundviewwidget.h"
 #include "./tournament/playerviewwidget.h"
+#include "./tournament/standingsboardwidget.h"
+#include "./updatescheduler.h"
+#include "../session.h"
 #include <squire_core/squire_core.h>
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QTimer>
+#include <functional>
+
+// The round timer shows seconds so, it does not need to tick faster
+#define TOURNAMENT_TAB_TIMER_MS 1000
 
 namespace Ui
 {
@@ -22,6 +29,10 @@ class TournamentTab : public AbstractTabWidget
 public:
     explicit TournamentTab(Tournament *tourn, QWidget *parent = nullptr);
     ~TournamentTab();
+    std::string filePath();
+    // The selected round and, player to open the tab with at the next start
+    session_tourn_t sessionState();
+    void restoreSession(session_tourn_t s);
 public slots:
     /**
      * Asks if the tab can be closed.
@@ -64,6 +75,8 @@ public slots:
     void showStandings();
 protected:
     void changeEvent(QEvent *e);
+    void onTabShown() override;
+    void onTabHidden() override;
 
 private:
     QVBoxLayout *roundTableLayout;
@@ -72,12 +85,19 @@ private:
     SearchSortTableWidget<RoundModel, Round> *roundTable;
     RoundViewWidget *roundViewWidget;
     PlayerViewWidget *playerViewWidget;
+    StandingsBoardWidget *standingsBoard; // Made when the standings are first shown
     Ui::TournamentTab *ui;
     Tournament *tourn;
     std::string t_name;
     std::string t_type;
     std::string t_format;
     QTimer timeLeftUpdater;
+    bool stale; // The tables missed changes while the tab was hidden
+    UpdateScheduler updates;
+    int playerTableView;
+    int roundTableView;
+    int roundTimerView;
     void setStatus();
+    void flushView(std::function<void()> flush); // Skipped and, marked stale when hidden
 };
 
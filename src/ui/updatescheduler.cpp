@@ -0,0 +1,29 @@
+#include "./updatescheduler.h"
+
+UpdateScheduler::UpdateScheduler()
+{
+    this->timer.setSingleShot(true);
+    this->timer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&this->timer, &QTimer::timeout, [this]() {
+        update_scheduler_flush(&this->scheduler);
+    });
+
+    update_scheduler_init(&this->scheduler, [this](int ms) {
+        this->timer.start(ms);
+    });
+}
+
+UpdateScheduler::~UpdateScheduler()
+{
+    this->timer.stop();
+}
+
+int UpdateScheduler::addView(std::function<void()> flush)
+{
+    return update_scheduler_add(&this->scheduler, flush);
+}
+
+void UpdateScheduler::markDirty(int view)
+{
+    update_scheduler_mark(&this->scheduler, view);
+}
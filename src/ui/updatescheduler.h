@@ -0,0 +1,17 @@
+#pragma once
+#include <functional>
+#include <QTimer>
+#include "../update_scheduler.h"
+
+// Runs an update_scheduler_t (see ../update_scheduler.h) on this thread's event loop
+class UpdateScheduler
+{
+public:
+    UpdateScheduler();
+    ~UpdateScheduler();
+    int addView(std::function<void()> flush);
+    void markDirty(int view);
+private:
+    QTimer timer;
+    update_scheduler_t scheduler;
+};
@@ -3,7 +3,8 @@
 LabelImage::LabelImage(QWidget *parent)
     : QLabel(parent)
 {
-
+    this->asset = ASSET_COUNT;
+    this->hasAsset = false;
 }
 
 LabelImage::~LabelImage()
@@ -14,7 +15,11 @@ LabelImage::~LabelImage()
 void LabelImage::resizeEvent(QResizeEvent *pQEvent)
 {
     QLabel::resizeEvent(pQEvent);
-    this->setPixmap(this->pixmap, pQEvent->size());
+    if (this->hasAsset) {
+        this->setAssetSize(pQEvent->size());
+    } else {
+        this->setPixmap(this->pixmap, pQEvent->size());
+    }
 }
 
 void LabelImage::setPixmap(const QPixmap &qPixmap, const QSize &size)
@@ -26,6 +31,20 @@ void LabelImage::setPixmap(const QPixmap &qPixmap, const QSize &size)
 
 void LabelImage::setPixmap(const QPixmap &qPixmap)
 {
+    this->hasAsset = false;
     this->setPixmap(qPixmap, this->size());
 }
 
+void LabelImage::setAssetSize(const QSize &size)
+{
+    this->pixmapScaled = asset_pixmap(this->asset, size);
+    QLabel::setPixmap(this->pixmapScaled);
+}
+
+void LabelImage::setAsset(asset_id_t id)
+{
+    this->asset = id;
+    this->hasAsset = true;
+    this->pixmap = QPixmap();
+    this->setAssetSize(this->size());
+}
@@ -5,6 +5,7 @@
 #include <QMainWindow>
 #include <QPixmap>
 #include <QTimer>
+#include "../assetcache.h"
 
 class LabelImage: public QLabel
 {
@@ -12,11 +13,16 @@ public:
     LabelImage(QWidget *parent = nullptr);
     ~LabelImage();
     void setPixmap(const QPixmap &qPixmap);
+    // The scaled asset comes from the asset cache so, it is shared with every
+    // other label of the same size
+    void setAsset(asset_id_t id);
 protected:
     void resizeEvent(QResizeEvent *pQEvent) override;
 private:
     QPixmap pixmap;
     QPixmap pixmapScaled;
+    asset_id_t asset;
+    bool hasAsset;
     void setPixmap(const QPixmap &qPixmap, const QSize &size);
+    void setAssetSize(const QSize &size);
 };
-
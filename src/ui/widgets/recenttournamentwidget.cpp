@@ -1,34 +1,23 @@
 #include <time.h>
 #include <string>
-#include <assets.h>
 #include <QStyle>
 #include "./recenttournamentwidget.h"
 #include "./ui_recenttournamentwidget.h"
-
-static QPixmap *WARNING_PIXMAP;
-static QPixmap *FLUID_PIXMAP;
-static QPixmap *SWISS_PIXMAP;
-
-void recent_tourn_widget_init_icons()
-{
-    WARNING_PIXMAP = new QPixmap();
-    WARNING_PIXMAP->loadFromData(WARNING_PNG, sizeof(WARNING_PNG));
-
-    FLUID_PIXMAP = new QPixmap();
-    FLUID_PIXMAP->loadFromData(FLUID_PNG, sizeof(FLUID_PNG));
-
-    SWISS_PIXMAP = new QPixmap();
-    SWISS_PIXMAP->loadFromData(SWISS_PNG, sizeof(SWISS_PNG));
-}
+#include "../assetcache.h"
 
 RecentTournamentWidget::RecentTournamentWidget(recent_tournament_t t, QWidget *parent) :
     QWidget(parent),
     ui(new Ui::RecentTournamentWidget)
 {
     ui->setupUi(this);
+    asset_id_t asset = ASSET_COUNT; // No image until it is read
 
-    this->t = t;
-    ui->name->setText(QString(t.name == NULL ? "Error Loading": t.name));
+    this->t = clone_recent_tourn(t);
+    if (t.pending) {
+        ui->name->setText(QString(t.file_path));
+    } else {
+        ui->name->setText(QString(t.name == NULL ? "Error Loading": t.name));
+    }
 
     if (t.pairing_sys == NULL) {
         ui->type->setText(tr("N/a"));
@@ -36,36 +25,66 @@ RecentTournamentWidget::RecentTournamentWidget(recent_tournament_t t, QWidget *p
         ui->type->setText(QString::fromStdString(std::string(t.pairing_sys)));
     }
 
-    if (t.name == NULL || t.pairing_sys == NULL) {
+    if (t.pending) {
+        ui->type->setText(tr("Loading..."));
+        ui->editTime->setText(tr("Loading..."));
+    } else if (t.name == NULL || t.pairing_sys == NULL) {
         ui->editTime->setText(tr("Error with: ") + QString(t.file_path));
-        pixmap = *WARNING_PIXMAP;
+        asset = ASSET_WARNING;
     } else {
         char timeString[50];
         strftime(timeString, sizeof(timeString), "%x - %H:%M:%S %Z", &t.last_opened);
-        ui->editTime->setText(QString(timeString));
+        QString details = QString(timeString);
+        if (t.player_count >= 0) {
+            details += " | " + tr("%1 players").arg(t.player_count);
+        }
+
+        if (t.status != TOURN_STATUS_UNKNOWN) {
+            details += " | " + statusText(t.status);
+        }
+        ui->editTime->setText(details);
 
         if (strcmp(t.pairing_sys, PAIRING_SWISS) == 0) {
-            pixmap = *SWISS_PIXMAP;
+            asset = ASSET_SWISS;
         } else if (strcmp(t.pairing_sys, PAIRING_FLUID) == 0) {
-            pixmap = *FLUID_PIXMAP;
+            asset = ASSET_FLUID;
         }
     }
 
     this->img = new LabelImage();
-    this->img->setPixmap(pixmap);
+    if (asset != ASSET_COUNT) {
+        this->img->setAsset(asset);
+    }
 
     this->layout = new QVBoxLayout(ui->frame);
     this->layout->setAlignment(Qt::AlignTop);
     this->layout->addWidget(this->img);
 }
 
+// tourn_status_str is for the cache so, each literal is passed to tr() here for lupdate
+QString RecentTournamentWidget::statusText(tourn_status_t s)
+{
+    switch (s) {
+    case TOURN_STATUS_PLANNED:
+        return tr("Planned");
+    case TOURN_STATUS_STARTED:
+        return tr("Started");
+    case TOURN_STATUS_FROZEN:
+        return tr("Frozen");
+    case TOURN_STATUS_ENDED:
+        return tr("Ended");
+    case TOURN_STATUS_CANCELLED:
+        return tr("Cancelled");
+    default:
+        return tr("Unknown");
+    }
+}
+
 RecentTournamentWidget::~RecentTournamentWidget()
 {
     delete ui;
     delete layout;
-    free(this->t.name);
-    free(this->t.file_path);
-    free(this->t.pairing_sys);
+    free_recent_tourn(&this->t);
 }
 
 void RecentTournamentWidget::changeEvent(QEvent *e)
@@ -94,6 +113,7 @@ void RecentTournamentWidget::enterEvent(QEvent *event)
 #endif
 {
     this->setBackgroundRole(QPalette::Highlight);
+    emit this->preloadTournament(QString(this->t.file_path));
 }
 
 void RecentTournamentWidget::leaveEvent(QEvent *event)
@@ -20,6 +20,7 @@ public:
     ~RecentTournamentWidget();
 signals:
     void loadTournament(QString name);
+    void preloadTournament(QString name); // The pointer is over it
 protected:
     void changeEvent(QEvent *e);
 #if QT_VERSION >= 0x060000
@@ -37,7 +38,5 @@ private:
     recent_tournament_t t;
     LabelImage *img;
     QVBoxLayout *layout;
-    QPixmap pixmap;
+    QString statusText(tourn_status_t s);
 };
-
-void recent_tourn_widget_init_icons();
@@ -1,5 +1,5 @@
 #include <QAbstractButton>
-#include "../../../testing_h/logger.h"
+#include "../../async_log.h"
 #include "./searchsorttablewidget.h"
 
 sstw_qobject::sstw_qobject(Ui::SearchSortTableWidget *ui, QWidget *parent) :
@@ -6,7 +6,8 @@
 #include <vector>
 #include <string>
 #include "./tablemodel.hpp"
-#include "../../../testing_h/logger.h"
+#include "../../async_log.h"
+#include "../../trace.h"
 #include "../../filerable_list.hpp"
 #include "./ui_searchsorttablewidget.h"
 
@@ -53,7 +54,9 @@ public:
     void filterSelected(int i) override;
     void sortChanged(int column, bool ascending) override;
     T_DATA getDataAt(int index);
+    const T_DATA *dataAt(int index); // The shown row, valid until the data changes
     QItemSelectionModel *selectionModel();
+    QTableView *view();
 private:
     std::vector<bool (*)(T_DATA a)> additionalFilters;
     std::vector<int (*)(const T_DATA &a, const T_DATA &b)> sortAlgs;
@@ -144,6 +147,7 @@ void SearchSortTableWidget<T_MDL, T_DATA>::filterSelected(int i)
 template <class T_MDL, class T_DATA>
 void SearchSortTableWidget<T_MDL, T_DATA>::filterList()
 {
+    TRACE_SPAN("SearchSortTableWidget::filterList", TRACE_CAT_UI);
     // Only add an item when it matches all filters
     std::vector<T_DATA> filtered;
     for (int j = 0; j < this->data.size(); j++) {
@@ -181,23 +185,39 @@ QItemSelectionModel *SearchSortTableWidget<T_MDL, T_DATA>::selectionModel()
     return this->itemMdl;
 }
 
+template <class T_MDL, class T_DATA>
+QTableView *SearchSortTableWidget<T_MDL, T_DATA>::view()
+{
+    return ui->table;
+}
+
 template <class T_MDL, class T_DATA>
 T_DATA SearchSortTableWidget<T_MDL, T_DATA>::getDataAt(int index)
 {
-    std::vector<T_DATA> tmp = this->flist.getFiltered();
-    if (index >= 0 && index < tmp.size()) {
-        return tmp[index];
-    } else {
+    const T_DATA *ret = this->dataAt(index);
+    if (ret == NULL) {
         return T_DATA();
     }
+    return *ret;
+}
+
+template <class T_MDL, class T_DATA>
+const T_DATA *SearchSortTableWidget<T_MDL, T_DATA>::dataAt(int index)
+{
+    // The model holds the filtered list in the order shown
+    return this->tableModel->rowAt(index);
 }
 
 template <class T_MDL, class T_DATA>
 void SearchSortTableWidget<T_MDL, T_DATA>::refreshTable()
 {
     QModelIndex topLeft = this->tableModel->index(0, 0);
-    QModelIndex botRight = this->tableModel->index(this->tableModel->rowCount(), this->tableModel->columnCount());
+    if (this->tableModel->rowCount() == 0) {
+        return;
+    }
 
+    // The last cell, index(rowCount(), ...) is not valid so nothing was redrawn
+    QModelIndex botRight = this->tableModel->index(this->tableModel->rowCount() - 1, this->tableModel->columnCount() - 1);
     this->tableModel->dataChanged(topLeft, botRight);
 }
 
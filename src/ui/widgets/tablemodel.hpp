@@ -1,10 +1,12 @@
 #pragma once
 #include <stddef.h>
+#include <string>
 #include <vector>
 #include <QObject>
 #include <QModelIndex>
 #include <QAbstractTableModel>
-#include "../../../testing_h/logger.h"
+#include "../../async_log.h"
+#include "../../list_diff.h"
 
 class tm_qobject: public QObject
 {
@@ -27,6 +29,9 @@ public:
    Override .cols() to return the amount of columns
    Override QAbstractTableModel as usual
    All sorting and, searching is done by searchsorttable.h|c(pp)?
+   Call setKey() with a unique key per row to have setData() move the rows that
+   changed place rather than resetting the model, which keeps the selection and,
+   scroll position
  */
 template <class T>
 class TableModel : public QAbstractTableModel
@@ -40,8 +45,12 @@ public:
     tm_qobject *getSortObject();
     void rerender();
     void setData(std::vector<T> data);
+    void setKey(std::string (*key)(const T &));
+    const T *rowAt(int row) const; // NULL if there is no such row
 private:
     tm_qobject *sortIntermediate;
+    std::string (*key)(const T &);
+    void updateRows(std::vector<T> &data);
 protected:
     std::vector<T> mdldata;
 };
@@ -49,6 +58,7 @@ protected:
 template <class T>
 TableModel<T>::TableModel(std::vector<T> data)
 {
+    this->key = NULL;
     this->mdldata = data;
     this->rerender();
     this->sortIntermediate = new tm_qobject();
@@ -73,8 +83,62 @@ void TableModel<T>::rerender()
 template <class T>
 void TableModel<T>::setData(std::vector<T> data)
 {
+    if (this->key == NULL) {
+        this->mdldata = data;
+        this->rerender();
+    } else {
+        this->updateRows(data);
+    }
+}
+
+template <class T>
+void TableModel<T>::setKey(std::string (*key)(const T &))
+{
+    this->key = key;
+}
+
+template <class T>
+void TableModel<T>::updateRows(std::vector<T> &data)
+{
+    std::vector<std::string> oldKeys, newKeys;
+    for (size_t i = 0; i < this->mdldata.size(); i++) {
+        oldKeys.push_back(this->key(this->mdldata[i]));
+    }
+    for (size_t i = 0; i < data.size(); i++) {
+        newKeys.push_back(this->key(data[i]));
+    }
+
+    std::vector<list_op_t> ops = list_diff(oldKeys, newKeys);
+    for (const list_op_t &op : ops) {
+        T row;
+        switch (op.type) {
+        case LIST_OP_REMOVE:
+            this->beginRemoveRows(QModelIndex(), op.from, op.from);
+            this->mdldata.erase(this->mdldata.begin() + op.from);
+            this->endRemoveRows();
+            break;
+        case LIST_OP_MOVE:
+            this->beginMoveRows(QModelIndex(), op.from, op.from, QModelIndex(), op.to);
+            row = this->mdldata[op.from];
+            this->mdldata.erase(this->mdldata.begin() + op.from);
+            this->mdldata.insert(this->mdldata.begin() + op.to, row);
+            this->endMoveRows();
+            break;
+        case LIST_OP_INSERT:
+            this->beginInsertRows(QModelIndex(), op.to, op.to);
+            this->mdldata.insert(this->mdldata.begin() + op.to, data[op.to]);
+            this->endInsertRows();
+            break;
+        }
+    }
+
+    // The rows are in place, their values may have changed still
     this->mdldata = data;
-    this->rerender();
+    if (this->mdldata.size() > 0) {
+        QModelIndex topLeft = this->index(0, 0);
+        QModelIndex bottomRight = this->index(this->rowCount() - 1, this->columnCount() - 1);
+        this->dataChanged(topLeft, bottomRight);
+    }
 }
 
 template <class T>
@@ -83,6 +147,15 @@ void TableModel<T>::sort(int column, Qt::SortOrder order)
     this->sortIntermediate->onSortChanged(column, order == Qt::AscendingOrder);
 }
 
+template <class T>
+const T *TableModel<T>::rowAt(int row) const
+{
+    if (row < 0 || (size_t) row >= this->mdldata.size()) {
+        return NULL;
+    }
+    return &this->mdldata[row];
+}
+
 template <class T>
 int TableModel<T>::rowCount(const QModelIndex &parent) const
 {
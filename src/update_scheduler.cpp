@@ -0,0 +1,78 @@
+#include "./update_scheduler.h"
+#include "./async_log.h"
+#include "./trace.h"
+#include <algorithm>
+
+void update_scheduler_init(update_scheduler_t *s, update_arm_t arm)
+{
+    s->arm = arm;
+}
+
+size_t update_scheduler_add(update_scheduler_t *s, update_flush_t flush)
+{
+    s->views.push_back(flush);
+    s->dirty.push_back(false);
+    return s->views.size() - 1;
+}
+
+static void arm(update_scheduler_t *s)
+{
+    if (s->armed) {
+        return;
+    }
+
+    int wait = 0;
+    if (s->flushed) {
+        std::chrono::milliseconds since = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - s->last_flush);
+        wait = std::max<int>(0, UPDATE_FRAME_MS - since.count());
+    }
+
+    s->armed = true;
+    s->arm(wait);
+}
+
+void update_scheduler_mark(update_scheduler_t *s, size_t view)
+{
+    if (view >= s->views.size()) {
+        lprintf(LOG_ERROR, "Cannot mark view %lu, there are only %lu views\n",
+                (unsigned long) view, (unsigned long) s->views.size());
+        return;
+    }
+
+    s->marks++;
+    if (s->dirty[view]) {
+        return;
+    }
+
+    s->dirty[view] = true;
+    s->pending.push_back(view);
+    arm(s);
+}
+
+void update_scheduler_flush(update_scheduler_t *s)
+{
+    TRACE_SPAN("update_scheduler_flush", TRACE_CAT_UI);
+    s->armed = false;
+    s->flushed = true;
+    s->last_flush = std::chrono::steady_clock::now();
+
+    std::vector<size_t> views;
+    views.swap(s->pending);
+    for (size_t view : views) {
+        s->dirty[view] = false;
+    }
+
+    if (views.size() > 0) {
+        s->flushes++;
+    }
+
+    for (size_t view : views) {
+        s->view_flushes++;
+        s->views[view]();
+    }
+}
+
+bool update_scheduler_pending(update_scheduler_t *s)
+{
+    return s->pending.size() > 0;
+}
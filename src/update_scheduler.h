@@ -0,0 +1,46 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+/*
+ * Batches view updates on the GUI thread. Signals mark views as dirty, the
+ * views are then flushed together at most once per UPDATE_FRAME_MS so that a
+ * burst of changes costs one flush per view rather than one per change.
+ * Marking a view that is already dirty does nothing. Not thread safe, it is
+ * only used from the thread that owns the views.
+ * */
+
+#define UPDATE_FRAME_MS 16
+
+typedef std::function<void()> update_flush_t;
+
+// Starts a one shot timer on the event loop that calls update_scheduler_flush
+typedef std::function<void(int ms)> update_arm_t;
+
+typedef struct update_scheduler_t {
+    std::vector<update_flush_t> views;
+    std::vector<bool> dirty;
+    std::vector<size_t> pending; // Dirty views in the order that they were marked
+    update_arm_t arm;
+    bool armed = false;
+    bool flushed = false; // last_flush is set
+    std::chrono::steady_clock::time_point last_flush;
+
+    uint64_t marks = 0;
+    uint64_t flushes = 0; // Batches
+    uint64_t view_flushes = 0;
+} update_scheduler_t;
+
+void update_scheduler_init(update_scheduler_t *s, update_arm_t arm);
+
+// Returns the id to mark the view with
+size_t update_scheduler_add(update_scheduler_t *s, update_flush_t flush);
+void update_scheduler_mark(update_scheduler_t *s, size_t view);
+
+// Flushes every dirty view, views that are marked during the flush are left
+// for the next frame
+void update_scheduler_flush(update_scheduler_t *s);
+bool update_scheduler_pending(update_scheduler_t *s);
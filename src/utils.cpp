@@ -1,6 +1,16 @@
 #include "./utils.h"
 #include <string.h>
 #include <stdlib.h>
+#include <sys/stat.h>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+#include <atomic>
+#include <vector>
+#ifdef UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 void toLowerCase(std::string &str)
 {
@@ -12,41 +22,239 @@ void toUpperCase(std::string &str)
     std::transform(str.begin(), str.end(), str.begin(), toupper);
 }
 
-char *read_all_f(FILE *f)
+// Reads the rest of f with as few freads as possible, the buffer grows
+// geometrically and, is always NUL terminated. len is set to the bytes read.
+static char *read_all_bulk(FILE *f, size_t *len)
 {
-    if (f == NULL) {
-        EXIT_MEM_ERROR(f);
+    size_t length = DEFAULT_BLOCK_SIZE, ptr = 0;
+
+    // When the size is known the whole file is read in one go
+    struct stat st;
+    long pos = ftell(f);
+    bool has_fd = fileno(f) >= 0;
+    if (has_fd && fstat(fileno(f), &st) == 0 && (st.st_mode & S_IFMT) == S_IFREG && pos >= 0 && st.st_size > pos) {
+        length = st.st_size - pos + 1;
     }
 
-    size_t length = DEFAULT_BLOCK_SIZE, ptr = 0;
     char *ret = (char *) malloc(sizeof(*ret) * length);
     if (ret == NULL) {
         EXIT_MEM_ERROR(ret);
     }
 
-    for (int c = 0; c = fgetc(f), c != EOF;) {
-        if (ptr + 1 >= length) {
-            ret = (char *) realloc(ret, length += DEFAULT_BLOCK_SIZE);
-
-            if (ret == NULL) {
-                EXIT_MEM_ERROR(ret);
-            }
+    // Streams with no descriptor (fmemopen) cannot be sized, the first byte is
+    // read on its own so that an empty one never reaches fread
+    if (!has_fd) {
+        int c = fgetc(f);
+        if (c == EOF) {
+            ret[0] = 0;
+            *len = 0;
+            return ret;
         }
         ret[ptr++] = c;
     }
 
-    if (ptr + 1 >= length) {
-        ret = (char *) realloc(ret, length += DEFAULT_BLOCK_SIZE);
+    for (;;) {
+        ptr += fread(ret + ptr, 1, length - ptr - 1, f);
+        if (ptr + 1 < length) {
+            break; // Short read, EOF or error
+        }
+
+        // The buffer is full, only grow it if there is more to read
+        int c = fgetc(f);
+        if (c == EOF) {
+            break;
+        }
 
-        if (ret == NULL) {
-            EXIT_MEM_ERROR(ret);
+        char *tmp = (char *) realloc(ret, length *= 2);
+        if (tmp == NULL) {
+            free(ret);
+            EXIT_MEM_ERROR(tmp);
         }
+        ret = tmp;
+        ret[ptr++] = c;
     }
-    ret[ptr++] = 0;
 
+    ret[ptr] = 0;
+    *len = ptr;
     return ret;
 }
 
+char *read_all_f(FILE *f)
+{
+    if (f == NULL) {
+        EXIT_MEM_ERROR(f);
+    }
+
+    size_t len;
+    return read_all_bulk(f, &len);
+}
+
+static bool view_file(FILE *f, file_view_t *ret, bool can_map)
+{
+    memset(ret, 0, sizeof(*ret));
+    if (f == NULL) {
+        lprintf(LOG_ERROR, "Cannot map a NULL file\n");
+        return false;
+    }
+
+#ifdef UNIX
+    struct stat st;
+    long pos = ftell(f);
+    if (can_map && fstat(fileno(f), &st) == 0 && S_ISREG(st.st_mode) && pos >= 0 && st.st_size > pos) {
+        void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+        if (data != MAP_FAILED) {
+            madvise(data, st.st_size, MADV_SEQUENTIAL);
+            ret->offset = pos;
+            ret->data = (const char *) data + pos;
+            ret->size = st.st_size - pos;
+            ret->mapped = true;
+
+            // The view consumes the stream like a read would
+            fseek(f, 0, SEEK_END);
+            return true;
+        }
+        lprintf(LOG_WARNING, "Cannot mmap file, reading it instead\n");
+    }
+#endif
+
+    char *data = read_all_bulk(f, &ret->size);
+    if (data == NULL) {
+        return false;
+    }
+
+    ret->data = data;
+    return true;
+}
+
+static bool view_file_path(const char *path, file_view_t *ret, bool can_map)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        memset(ret, 0, sizeof(*ret));
+        lprintf(LOG_ERROR, "Cannot open %s\n", path);
+        return false;
+    }
+
+    // The mapping outlives the stream
+    bool r = view_file(f, ret, can_map);
+    fclose(f);
+    return r;
+}
+
+bool map_file(FILE *f, file_view_t *ret)
+{
+    return view_file(f, ret, true);
+}
+
+bool map_file_path(const char *path, file_view_t *ret)
+{
+    return view_file_path(path, ret, true);
+}
+
+bool read_file(FILE *f, file_view_t *ret)
+{
+    return view_file(f, ret, false);
+}
+
+bool read_file_path(const char *path, file_view_t *ret)
+{
+    return view_file_path(path, ret, false);
+}
+
+void unmap_file(file_view_t *view)
+{
+    if (view->data == NULL) {
+        return;
+    }
+
+#ifdef UNIX
+    if (view->mapped) {
+        munmap((void *) (view->data - view->offset), view->size + view->offset);
+    } else {
+        free((void *) view->data);
+    }
+#else
+    free((void *) view->data);
+#endif
+
+    memset(view, 0, sizeof(*view));
+}
+
+bool atomic_file_open(atomic_file_t *ret, const char *path)
+{
+    memset(ret, 0, sizeof(*ret));
+    ret->path = clone_string(path);
+    if (ret->path == NULL) {
+        return false;
+    }
+
+    ret->tmp_path = clone_std_string(std::string(path) + ATOMIC_FILE_SUFFIX);
+    if (ret->tmp_path == NULL) {
+        free(ret->path);
+        return false;
+    }
+
+    ret->f = fopen(ret->tmp_path, "wb");
+    if (ret->f == NULL) {
+        lprintf(LOG_ERROR, "Cannot open %s\n", ret->tmp_path);
+        free(ret->path);
+        free(ret->tmp_path);
+        memset(ret, 0, sizeof(*ret));
+        return false;
+    }
+    return true;
+}
+
+static void atomic_file_free(atomic_file_t *af)
+{
+    free(af->path);
+    free(af->tmp_path);
+    memset(af, 0, sizeof(*af));
+}
+
+bool atomic_file_commit(atomic_file_t *af)
+{
+    if (af->f == NULL) {
+        return false;
+    }
+
+    // The data must be on disk before the rename makes it visible
+    bool status = fflush(af->f) == 0;
+#ifdef UNIX
+    status &= fsync(fileno(af->f)) == 0;
+#endif
+    status &= fclose(af->f) == 0;
+    af->f = NULL;
+
+    if (!status) {
+        lprintf(LOG_ERROR, "Cannot write %s\n", af->tmp_path);
+        remove(af->tmp_path);
+        atomic_file_free(af);
+        return false;
+    }
+
+    // std::filesystem::rename replaces the target on Windows too
+    std::error_code ec;
+    std::filesystem::rename(af->tmp_path, af->path, ec);
+    if (ec) {
+        lprintf(LOG_ERROR, "Cannot replace %s - %s\n", af->path, ec.message().c_str());
+        remove(af->tmp_path);
+        status = false;
+    }
+
+    atomic_file_free(af);
+    return status;
+}
+
+void atomic_file_abort(atomic_file_t *af)
+{
+    if (af->f != NULL) {
+        fclose(af->f);
+        remove(af->tmp_path);
+    }
+    atomic_file_free(af);
+}
+
 char *clone_std_string(std::string str)
 {
     size_t len = str.size() + 1;
@@ -70,3 +278,24 @@ char *clone_string(const char *str)
     strcpy(ret, str);
     return ret;
 }
+
+void parallel_for(size_t n, const std::function<void(size_t)> &fn)
+{
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i; i = next++, i < n;) {
+            fn(i);
+        }
+    };
+
+    size_t threads = std::min((size_t) std::max(1U, std::thread::hardware_concurrency()), n);
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < threads; i++) {
+        pool.push_back(std::thread(worker));
+    }
+
+    worker();
+    for (std::thread &t : pool) {
+        t.join();
+    }
+}
@@ -2,15 +2,54 @@
 #include <string>
 #include <algorithm>
 #include <stdio.h>
-#include "../testing_h/logger.h"
+#include <functional>
+#include "./async_log.h"
 
 #define EXIT_MEM_ERROR(mem) lprintf(LOG_ERROR, #mem " is NULL\n"); return NULL;
 #define DEFAULT_BLOCK_SIZE 4095
 
 char *read_all_f(FILE *f); // Reads a C string from a file. Binary files are not supported.
+
+// A read-only view of the rest of a file, data is not NUL terminated. Regular
+// files are mmapped on POSIX, anything else (pipes, Windows) is read in bulk.
+typedef struct file_view_t {
+    const char *data;
+    size_t size;
+    size_t offset; // Offset of data into the mapping
+    bool mapped;
+} file_view_t;
+
+bool map_file(FILE *f, file_view_t *ret);
+bool map_file_path(const char *path, file_view_t *ret);
+
+// As above but, the file is always read. Use these for files that another
+// process or, thread may truncate while they are read as touching a mapped page
+// past the new end of the file raises SIGBUS. Files that are only replaced by
+// rename (atomic_file_t) are safe to map.
+bool read_file(FILE *f, file_view_t *ret);
+bool read_file_path(const char *path, file_view_t *ret);
+void unmap_file(file_view_t *view);
+
+// Writes go to a temporary file next to path which replaces path on commit,
+// a crash mid-write leaves the old file untouched.
+typedef struct atomic_file_t {
+    FILE *f;
+    char *path;
+    char *tmp_path;
+} atomic_file_t;
+
+#define ATOMIC_FILE_SUFFIX ".tmp"
+
+bool atomic_file_open(atomic_file_t *ret, const char *path);
+bool atomic_file_commit(atomic_file_t *af); // Closes the file
+void atomic_file_abort(atomic_file_t *af); // Closes and, removes the temporary file
 char *clone_string(const char *str);
 
 char *clone_std_string(std::string str);
 void toLowerCase(std::string &str);
 void toUpperCase(std::string &str);
 
+// Runs fn(i) for each i in [0, n) on a pool of threads, the calling thread
+// does its share too.
+void parallel_for(size_t n, const std::function<void(size_t)> &fn);
+
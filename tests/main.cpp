@@ -9,6 +9,22 @@
 #include "./test_utils.h"
 #include "./test_filter_list.h"
 #include "./test_timers.h"
+#include "./test_rng_stats.h"
+#include "./test_rng_job.h"
+#include "./test_async_log.h"
+#include "./test_crash_log.h"
+#include "./test_ffi_stats.h"
+#include "./test_ffi_ledger.h"
+#include "./test_trace.h"
+#include "./test_library.h"
+#include "./test_list_diff.h"
+#include "./test_preload_queue.h"
+#include "./test_presence_queue.h"
+#include "./test_session.h"
+#include "./test_spool.h"
+#include "./test_stall_watchdog.h"
+#include "./test_startup_profile.h"
+#include "./test_update_scheduler.h"
 #include "../testing_h/testing.h"
 
 int test_func()
@@ -43,6 +59,22 @@ int main(int argc, char *argv[])
         {&utils_cpp_test, "IO utils cpp test"},
         {&filter_list_tests, "Filter list cpp test"},
         {&test_timers, "Timers cpp test"},
+        {&rng_stats_cpp_test, "RNG stats cpp test"},
+        {&rng_job_cpp_test, "RNG job cpp test"},
+        {&async_log_cpp_test, "Async log cpp test"},
+        {&crash_log_cpp_test, "Crash log cpp test"},
+        {&ffi_stats_cpp_test, "FFI stats cpp test"},
+        {&ffi_ledger_cpp_test, "FFI ledger cpp test"},
+        {&trace_cpp_test, "Trace cpp test"},
+        {&library_cpp_test, "Library cpp test"},
+        {&list_diff_cpp_test, "List diff cpp test"},
+        {&preload_queue_cpp_test, "Preload queue cpp test"},
+        {&presence_queue_cpp_test, "Presence queue cpp test"},
+        {&session_cpp_test, "Session cpp test"},
+        {&spool_cpp_test, "Crash report spool test"},
+        {&stall_watchdog_cpp_test, "Stall watchdog cpp test"},
+        {&startup_profile_cpp_test, "Startup profile cpp test"},
+        {&update_scheduler_cpp_test, "Update scheduler cpp test"},
     };
 
     int failed_tests = run_tests(tests, sizeof(tests) / sizeof(*tests), "Squire Desktop Tests");
@@ -0,0 +1,175 @@
+#include "./test_async_log.h"
+#include "../src/async_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::atomic<int> records;
+static std::mutex last_lock;
+static std::string last;
+
+static void counting_sink(int level, const char *msg)
+{
+    records++;
+
+    std::lock_guard<std::mutex> l(last_lock);
+    last = msg;
+}
+
+// Without the drain thread records are written straight away
+static int test_sync()
+{
+    records = 0;
+    async_log_set_sink(&counting_sink);
+    lprintf(LOG_INFO, "test %d\n", 1);
+    async_log_set_sink(NULL);
+
+    ASSERT(records == 1);
+    ASSERT(last == "test 1\n");
+    return 1;
+}
+
+static int test_level_filter()
+{
+    int evaluated = 0;
+    records = 0;
+    async_log_set_sink(&counting_sink);
+    lprintf(LOG_MIN_LEVEL - 1, "%d\n", evaluated++);
+    async_log_set_sink(NULL);
+
+    ASSERT(records == 0);
+    ASSERT(evaluated == 0);
+    return 1;
+}
+
+#define THREADS 4
+#define RECORDS_PER_THREAD (ASYNC_LOG_RECORDS * 4)
+
+// More records than the ring holds, none may be lost
+static int test_async()
+{
+    records = 0;
+    async_log_set_sink(&counting_sink);
+    async_log_init();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREADS; i++) {
+        threads.push_back(std::thread([i]() {
+            for (int j = 0; j < RECORDS_PER_THREAD; j++) {
+                lprintf(LOG_INFO, "thread %d record %d\n", i, j);
+            }
+        }));
+    }
+
+    for (std::thread &t : threads) {
+        t.join();
+    }
+
+    async_log_flush();
+    ASSERT(records == THREADS * RECORDS_PER_THREAD);
+
+    lprintf(LOG_INFO, "last\n");
+    async_log_stop();
+    async_log_set_sink(NULL);
+
+    ASSERT(records == THREADS * RECORDS_PER_THREAD + 1);
+    ASSERT(last == "last\n");
+    return 1;
+}
+
+static int next_record[THREADS];
+static std::atomic<bool> in_order;
+
+static void ordered_sink(int level, const char *msg)
+{
+    int thread, record;
+    if (sscanf(msg, "thread %d record %d", &thread, &record) == 2) {
+        if (record != next_record[thread]) {
+            in_order = false;
+        }
+        next_record[thread] = record + 1;
+    }
+}
+
+// A full ring must not let records jump the queue
+static int test_order()
+{
+    memset(next_record, 0, sizeof(next_record));
+    in_order = true;
+    async_log_set_sink(&ordered_sink);
+    async_log_init();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREADS; i++) {
+        threads.push_back(std::thread([i]() {
+            for (int j = 0; j < RECORDS_PER_THREAD; j++) {
+                lprintf(LOG_INFO, "thread %d record %d\n", i, j);
+            }
+        }));
+    }
+
+    for (std::thread &t : threads) {
+        t.join();
+    }
+
+    async_log_stop();
+    async_log_set_sink(NULL);
+
+    ASSERT(in_order);
+    for (int i = 0; i < THREADS; i++) {
+        ASSERT(next_record[i] == RECORDS_PER_THREAD);
+    }
+    return 1;
+}
+
+// The idle drain thread has no timeout, it must be woken by the record
+static int test_wake()
+{
+    records = 0;
+    async_log_set_sink(&counting_sink);
+    async_log_init();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    lprintf(LOG_INFO, "wake\n");
+    for (int i = 0; i < 1000 && records == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    bool woken = records == 1;
+
+    async_log_stop();
+    async_log_set_sink(NULL);
+    ASSERT(woken);
+    return 1;
+}
+
+static int test_long_record()
+{
+    char msg[ASYNC_LOG_RECORD_SIZE * 3];
+    memset(msg, 'a', sizeof(msg) - 1);
+    msg[sizeof(msg) - 1] = 0;
+
+    records = 0;
+    async_log_set_sink(&counting_sink);
+    async_log_init();
+    lprintf(LOG_INFO, "%s", msg);
+    async_log_stop();
+    async_log_set_sink(NULL);
+
+    ASSERT(records == 1);
+    ASSERT(last == msg);
+    return 1;
+}
+
+SUB_TEST(async_log_cpp_test,
+{&test_sync, "Test sync logging"},
+{&test_level_filter, "Test compile time level filter"},
+{&test_async, "Test async logging"},
+{&test_order, "Test async logging keeps the order"},
+{&test_wake, "Test async logging wakes the drain thread"},
+{&test_long_record, "Test long record"}
+        )
@@ -0,0 +1,4 @@
+#pragma once
+#include "../testing_h/testing.h"
+
+int async_log_cpp_test();
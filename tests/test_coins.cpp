@@ -1,5 +1,6 @@
 #include <time.h>
 #include "../src/coins.h"
+#include "../src/rng_stats.h"
 #include "./test_coins.h"
 
 static int test_coins()
@@ -20,6 +21,38 @@ static int test_krark_coins()
     return 1;
 }
 
+// Sizes that are a multiple of the word size used to count a whole extra word
+static int test_coins_word_boundaries()
+{
+    for (int i = 64; i <= 64 * 1000; i += 64) {
+        int coins = flip_coins(i);
+        ASSERT(coins >= 0 && coins <= i);
+
+        coins = flip_krark_coins(i);
+        ASSERT(coins >= 0 && coins <= i);
+    }
+
+    ASSERT(flip_coins(0) == 0);
+    ASSERT(flip_krark_coins(0) == 0);
+    return 1;
+}
+
+#define FAIRNESS_FLIPS 100000
+#define FAIRNESS_ALPHA 0.00001
+
+// Consecutive calls used to reseed from the clock and, return the same result
+static int test_coins_fairness()
+{
+    double observed[2] = {0, 0};
+    for (int i = 0; i < FAIRNESS_FLIPS; i++) {
+        observed[flip_coins(1)]++;
+    }
+
+    double expected[2] = {FAIRNESS_FLIPS / 2.0, FAIRNESS_FLIPS / 2.0};
+    ASSERT(chi_square_p_value(chi_square_stat(observed, expected, 2), 1) > FAIRNESS_ALPHA);
+    return 1;
+}
+
 #define DICE_NUMBER 100
 #define DICE_SIDES 6
 
@@ -50,6 +83,20 @@ static int test_dice()
     return 1;
 }
 
+#define FAIRNESS_DICE 600000
+
+static int test_dice_fairness()
+{
+    int s, dof;
+    dice_roll_ret_t ret = roll_dice(DICE_SIDES, FAIRNESS_DICE, &s);
+    ASSERT(s);
+    double chi_sq = dice_chi_square(ret, &dof);
+    ASSERT(chi_square_p_value(chi_sq, dof) > FAIRNESS_ALPHA);
+    free_dice_roll_ret(ret);
+
+    return 1;
+}
+
 static int test_coins_perf()
 {
     long start = time(NULL);
@@ -73,7 +120,10 @@ static int test_dice_perf()
 SUB_TEST(coins_cpp_test,
 {&test_coins, "flip coins"},
 {&test_krark_coins, "flip krark coins"},
+{&test_coins_word_boundaries, "flip coins on word boundaries"},
+{&test_coins_fairness, "flip coins fairness"},
 {&test_dice, "dice rolling"},
+{&test_dice_fairness, "dice rolling fairness"},
 {&test_coins_perf, "coins perf test"},
 {&test_dice_perf, "dice perf test"}
         )
@@ -1,4 +1,5 @@
 #include <unistd.h>
+#include <sys/stat.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -219,12 +220,22 @@ static int test_add_recent_tourn_to_and_over_limit()
     ASSERT(r != NULL);
     ASSERT(w != NULL);
 
-    for (static int i = 0; i < 2 + MAXIMUM_RECENT_LIST_SIZE; i++) {
+    // Each path is distinct as duplicates are not added twice
+    char path[32];
+    t.file_path = path;
+    for (int i = 0; i < 2 + MAXIMUM_RECENT_LIST_SIZE; i++) {
+        snprintf(path, sizeof(path), "tourn%d.json", i);
         ASSERT(add_recent_tourn(&config, t, w));
     }
 
     fclose(w);
 
+    // The two oldest were dropped
+    for (int i = 0; i < config.recent_tournament_count; i++) {
+        snprintf(path, sizeof(path), "tourn%d.json", i + 2);
+        ASSERT(strcmp(recent_tourn_at(&config, i)->file_path, path) == 0);
+    }
+
     char *data =read_all_f(r);
     ASSERT(data != NULL);
     ASSERT(config.recent_tournament_count == MAXIMUM_RECENT_LIST_SIZE);
@@ -235,6 +246,136 @@ static int test_add_recent_tourn_to_and_over_limit()
     return 1;
 }
 
+// Re-adding a path moves it to the newest slot without growing the list
+static int test_add_recent_tourn_dedup()
+{
+    config_t config = DEFAULT_CONFIG;
+
+    recent_tournament_t t;
+    memset(&t, 0, sizeof(t));
+    t.name = (char *) "test name";
+    t.pairing_sys = (char *) "swiss";
+
+    // Fill the ring so that it has wrapped
+    char path[32];
+    t.file_path = path;
+    for (int i = 0; i < MAXIMUM_RECENT_LIST_SIZE + 5; i++) {
+        snprintf(path, sizeof(path), "tourn%d.json", i);
+        ASSERT(add_recent_tourn(&config, t, NULL));
+    }
+    ASSERT(config.recent_tournament_count == MAXIMUM_RECENT_LIST_SIZE);
+    ASSERT(config.recent_tournament_head != 0);
+
+    // The newest entry is not written again
+    FILE *f = tmpfile();
+    ASSERT(f != NULL);
+    ASSERT(add_recent_tourn(&config, t, f));
+    ASSERT(ftell(f) == 0);
+    ASSERT(config.recent_tournament_count == MAXIMUM_RECENT_LIST_SIZE);
+
+    // An older entry is moved to the end
+    snprintf(path, sizeof(path), "tourn%d.json", 10);
+    ASSERT(add_recent_tourn(&config, t, f));
+    ASSERT(ftell(f) > 0);
+    fclose(f);
+
+    ASSERT(config.recent_tournament_count == MAXIMUM_RECENT_LIST_SIZE);
+    ASSERT(strcmp(recent_tourn_at(&config, MAXIMUM_RECENT_LIST_SIZE - 1)->file_path, "tourn10.json") == 0);
+    ASSERT(strcmp(recent_tourn_at(&config, MAXIMUM_RECENT_LIST_SIZE - 2)->file_path, "tourn54.json") == 0);
+    ASSERT(strcmp(recent_tourn_at(&config, 0)->file_path, "tourn5.json") == 0);
+
+    // Still unique and, in order
+    for (int i = 0, j = 5; i < MAXIMUM_RECENT_LIST_SIZE - 1; i++, j++) {
+        if (j == 10) {
+            j++;
+        }
+        snprintf(path, sizeof(path), "tourn%d.json", j);
+        ASSERT(strcmp(recent_tourn_at(&config, i)->file_path, path) == 0);
+    }
+
+    free_config(&config);
+    return 1;
+}
+
+// Old configs may have duplicates which are dropped on read
+static int test_read_recent_tourns_dedup()
+{
+    int fid[2];
+    ASSERT(pipe(fid) == 0);
+    FILE *r = fdopen(fid[0], "r");
+    FILE *w = fdopen(fid[1], "w");
+
+    config_t config = DEFAULT_CONFIG;
+    std::string json = serialise_config(&config);
+    free_config(&config);
+
+    nlohmann::json j = nlohmann::json::parse(json);
+    j[CONFIG_RECENT_TOURNS] = {"a.tourn", "b.tourn", "a.tourn", "c.tourn", "b.tourn"};
+    fprintf(w, "%s", j.dump().c_str());
+    fclose(w);
+
+    ASSERT(init_config(&config, r));
+    fclose(r);
+
+    ASSERT(config.recent_tournament_count == 3);
+    ASSERT(strcmp(recent_tourn_at(&config, 0)->file_path, "a.tourn") == 0);
+    ASSERT(strcmp(recent_tourn_at(&config, 1)->file_path, "c.tourn") == 0);
+    ASSERT(strcmp(recent_tourn_at(&config, 2)->file_path, "b.tourn") == 0);
+
+    free_config(&config);
+    return 1;
+}
+
+#define TEST_SAVE_FILE "config_test_save.json"
+
+static int test_save_config()
+{
+    config_t config = DEFAULT_CONFIG;
+    ASSERT(save_config(&config, TEST_SAVE_FILE));
+
+    // The temporary file is renamed over the target
+    FILE *f = fopen(TEST_SAVE_FILE ATOMIC_FILE_SUFFIX, "r");
+    ASSERT(f == NULL);
+
+    f = fopen(TEST_SAVE_FILE, "r");
+    ASSERT(f != NULL);
+
+    config_t config_read;
+    ASSERT(init_config(&config_read, f));
+    fclose(f);
+    ASSERT(serialise_config(&config) == serialise_config(&config_read));
+
+    free_config(&config);
+    free_config(&config_read);
+    remove(TEST_SAVE_FILE);
+    return 1;
+}
+
+// The endpoint is optional and, kept when the config is rewritten
+static int test_crash_report_endpoint()
+{
+    config_t config = DEFAULT_CONFIG;
+    std::string output = serialise_config(&config);
+    ASSERT(output.find(CONFIG_CRASH_REPORT_ENDPOINT) == std::string::npos);
+
+    config.crash_report_endpoint = clone_string("http://localhost:8080/");
+    ASSERT(save_config(&config, TEST_SAVE_FILE));
+
+    FILE *f = fopen(TEST_SAVE_FILE, "r");
+    ASSERT(f != NULL);
+
+    config_t config_read;
+    ASSERT(init_config(&config_read, f));
+    fclose(f);
+    ASSERT(config_read.crash_report_endpoint != NULL);
+    ASSERT(strcmp(config_read.crash_report_endpoint, "http://localhost:8080/") == 0);
+
+    free_config(&config);
+    free_config(&config_read);
+    remove(TEST_SAVE_FILE);
+    return 1;
+}
+
 static int test_read_recent_tourns_no_file()
 {
     config_t config = DEFAULT_CONFIG;
@@ -253,7 +394,10 @@ static int test_read_recent_tourns_no_file()
     ASSERT(r != NULL);
     ASSERT(w != NULL);
 
-    for (static int i = 0; i < 2 + MAXIMUM_RECENT_LIST_SIZE; i++) {
+    char path[32];
+    t.file_path = path;
+    for (int i = 0; i < 2 + MAXIMUM_RECENT_LIST_SIZE; i++) {
+        snprintf(path, sizeof(path), "tourn%d.json", i);
         ASSERT(add_recent_tourn(&config, t, w));
     }
 
@@ -279,7 +423,8 @@ static int test_read_recent_tourns_no_file()
         ASSERT(config.recent_tournaments[i].name == NULL);
         ASSERT(config.recent_tournaments[i].pairing_sys == NULL);
         ASSERT(config.recent_tournaments[i].file_path != NULL);
-        ASSERT(strcmp(config.recent_tournaments[i].file_path, t.file_path) == 0);
+        snprintf(path, sizeof(path), "tourn%d.json", i + 2);
+        ASSERT(strcmp(config.recent_tournaments[i].file_path, path) == 0);
     }
 
     free_config(&config);
@@ -341,6 +486,248 @@ static int test_recent_tourn_with_file()
 
 }
 
+#define TEST_TRUNCATED_FILE "config_test_truncated.tourn"
+#define TEST_TRUNCATED_NAME "Truncated Tournament"
+
+// The reader should stop once it has the name and, pairing system so the rest
+// of the file is never parsed.
+static int test_recent_tourn_early_exit()
+{
+    FILE *f = fopen(TEST_TRUNCATED_FILE, "w");
+    ASSERT(f != NULL);
+    fprintf(f, "{\"pairing_sys\":{\"match_size\":4,\"style\":{\"Fluid\":{}}},"
+            "\"name\":\"" TEST_TRUNCATED_NAME "\",\"player_reg\":{{{{ not json");
+    fclose(f);
+
+    config_t config = DEFAULT_CONFIG;
+    recent_tournament_t t;
+    t.name = "test name"; // not used
+    t.pairing_sys = "swiss"; // not used
+    t.file_path = TEST_TRUNCATED_FILE;
+
+    int fid[2];
+    ASSERT(pipe(fid) == 0);
+    FILE *r = fdopen(fid[0], "r");
+    FILE *w = fdopen(fid[1], "w");
+
+    ASSERT(add_recent_tourn(&config, t, w));
+    fclose(w);
+    fclose(r);
+
+    ASSERT(pipe(fid) == 0);
+    r = fdopen(fid[0], "r");
+    w = fdopen(fid[1], "w");
+
+    write_config(&config, w);
+    fclose(w);
+    free_config(&config);
+    memset(&config, 0, sizeof(config));
+
+    init_config(&config, r);
+    fclose(r);
+    ASSERT(config.recent_tournament_count == 1);
+    ASSERT(config.recent_tournaments->name != NULL);
+    ASSERT(strcmp(config.recent_tournaments->name, TEST_TRUNCATED_NAME) == 0);
+    ASSERT(strcmp(config.recent_tournaments->pairing_sys, PAIRING_FLUID) == 0);
+
+    free_config(&config);
+    remove(TEST_TRUNCATED_FILE);
+    return 1;
+}
+
+// Writes a config with a single recent tournament to a pipe and, returns the
+// read end
+static FILE *recent_config_pipe(const char *path)
+{
+    config_t config = DEFAULT_CONFIG;
+    recent_tournament_t t;
+    memset(&t, 0, sizeof(t));
+    t.name = clone_string("test name"); // not used
+    t.pairing_sys = clone_string("swiss"); // not used
+    t.file_path = clone_string(path);
+
+    int fid[2];
+    if (pipe(fid) != 0) {
+        free_recent_tourn(&t);
+        return NULL;
+    }
+
+    FILE *r = fdopen(fid[0], "r");
+    FILE *w = fdopen(fid[1], "w");
+    add_recent_tourn(&config, t, w);
+    free_recent_tourn(&t);
+    fclose(w);
+    fclose(r);
+
+    if (pipe(fid) != 0) {
+        return NULL;
+    }
+
+    r = fdopen(fid[0], "r");
+    w = fdopen(fid[1], "w");
+    write_config(&config, w);
+    fclose(w);
+    free_config(&config);
+    return r;
+}
+
+static int test_recent_tourn_metadata()
+{
+    FILE *r = recent_config_pipe(TEST_FILE);
+    ASSERT(r != NULL);
+
+    config_t config;
+    ASSERT(init_config(&config, r));
+    fclose(r);
+
+    ASSERT(config.recent_tournament_count == 1);
+    ASSERT(config.recent_tournaments->player_count == 4);
+    ASSERT(config.recent_tournaments->status == TOURN_STATUS_STARTED);
+    ASSERT(config.recent_tournaments->file_size > 0);
+
+    free_config(&config);
+    return 1;
+}
+
+#define TEST_CACHED_FILE "config_test_cached.tourn"
+#define TEST_CACHED_NAME "Cached Tournament"
+
+// A cache hit must not touch the tournament file, which does not exist here
+static int test_recent_cache_hit()
+{
+    remove(TEST_CACHED_FILE);
+
+    FILE *cache = tmpfile();
+    ASSERT(cache != NULL);
+    fprintf(cache, "{\"" CACHE_ENTRIES "\":[{\"" CACHE_PATH "\":\"" TEST_CACHED_FILE "\","
+            "\"" CACHE_SIZE "\":10,\"" CACHE_MTIME "\":20,\"" CACHE_NAME "\":\"" TEST_CACHED_NAME "\","
+            "\"" CACHE_PAIRING_SYS "\":\"" PAIRING_FLUID "\",\"" CACHE_PLAYER_COUNT "\":32,"
+            "\"" CACHE_STATUS "\":\"Ended\"}]}");
+    rewind(cache);
+
+    FILE *r = recent_config_pipe(TEST_CACHED_FILE);
+    ASSERT(r != NULL);
+
+    config_t config;
+    ASSERT(init_config_cached(&config, r, cache));
+    fclose(r);
+    fclose(cache);
+
+    ASSERT(config.recent_tournament_count == 1);
+    recent_tournament_t *t = config.recent_tournaments;
+    ASSERT(t->name != NULL);
+    ASSERT(strcmp(t->name, TEST_CACHED_NAME) == 0);
+    ASSERT(strcmp(t->pairing_sys, PAIRING_FLUID) == 0);
+    ASSERT(t->player_count == 32);
+    ASSERT(t->status == TOURN_STATUS_ENDED);
+    ASSERT(t->file_size == 10);
+    ASSERT(t->mtime == 20);
+
+    // The file is gone so, revalidation drops the entry
+    ASSERT(revalidate_recent_tourns(config.recent_tournaments, config.recent_tournament_count));
+    ASSERT(t->name == NULL);
+    ASSERT(!revalidate_recent_tourns(config.recent_tournaments, config.recent_tournament_count));
+
+    free_config(&config);
+    return 1;
+}
+
+static int test_recent_cache_stale()
+{
+    struct stat st;
+    ASSERT(stat(TEST_FILE, &st) == 0);
+
+    // Right mtime, wrong size
+    FILE *cache = tmpfile();
+    ASSERT(cache != NULL);
+    fprintf(cache, "{\"" CACHE_ENTRIES "\":[{\"" CACHE_PATH "\":\"" TEST_FILE "\","
+            "\"" CACHE_SIZE "\":%lld,\"" CACHE_MTIME "\":%lld,\"" CACHE_NAME "\":\"Stale\","
+            "\"" CACHE_PAIRING_SYS "\":\"" PAIRING_FLUID "\",\"" CACHE_PLAYER_COUNT "\":1,"
+            "\"" CACHE_STATUS "\":\"Planned\"}]}",
+            (long long) st.st_size + 1, (long long) st.st_mtime);
+    rewind(cache);
+
+    FILE *r = recent_config_pipe(TEST_FILE);
+    ASSERT(r != NULL);
+
+    config_t config;
+    ASSERT(init_config_cached(&config, r, cache));
+    fclose(r);
+    fclose(cache);
+
+    ASSERT(config.recent_tournament_count == 1);
+    ASSERT(strcmp(config.recent_tournaments->name, "Stale") == 0);
+
+    ASSERT(revalidate_recent_tourns(config.recent_tournaments, config.recent_tournament_count));
+    ASSERT(strcmp(config.recent_tournaments->name, TEST_FILE_NAME) == 0);
+    ASSERT(strcmp(config.recent_tournaments->pairing_sys, TEST_FILE_PAIRING) == 0);
+    ASSERT(config.recent_tournaments->player_count == 4);
+    ASSERT(config.recent_tournaments->file_size == st.st_size);
+
+    // Now up to date
+    ASSERT(!revalidate_recent_tourns(config.recent_tournaments, config.recent_tournament_count));
+
+    // Round trip the cache
+    cache = tmpfile();
+    ASSERT(cache != NULL);
+    ASSERT(write_recent_cache(config.recent_tournaments, config.recent_tournament_count, cache));
+    rewind(cache);
+
+    free_config(&config);
+    r = recent_config_pipe(TEST_FILE);
+    ASSERT(r != NULL);
+    ASSERT(init_config_cached(&config, r, cache));
+    fclose(r);
+    fclose(cache);
+
+    ASSERT(strcmp(config.recent_tournaments->name, TEST_FILE_NAME) == 0);
+    ASSERT(config.recent_tournaments->status == TOURN_STATUS_STARTED);
+    ASSERT(!revalidate_recent_tourns(config.recent_tournaments, config.recent_tournament_count));
+
+    free_config(&config);
+    return 1;
+}
+
+// Cache misses are left to revalidation, a missing file stops being pending too
+static int test_recent_deferred()
+{
+    remove(TEST_CACHED_FILE);
+
+    FILE *r = recent_config_pipe(TEST_FILE);
+    ASSERT(r != NULL);
+
+    config_t config;
+    ASSERT(init_config_deferred(&config, r, NULL));
+    fclose(r);
+
+    ASSERT(config.recent_tournament_count == 1);
+    recent_tournament_t *t = config.recent_tournaments;
+    ASSERT(t->pending);
+    ASSERT(t->name == NULL);
+
+    ASSERT(revalidate_recent_tourns(config.recent_tournaments, config.recent_tournament_count));
+    ASSERT(!t->pending);
+    ASSERT(strcmp(t->name, TEST_FILE_NAME) == 0);
+    ASSERT(t->player_count == 4);
+    ASSERT(!revalidate_recent_tourns(config.recent_tournaments, config.recent_tournament_count));
+    free_config(&config);
+
+    r = recent_config_pipe(TEST_CACHED_FILE);
+    ASSERT(r != NULL);
+    ASSERT(init_config_deferred(&config, r, NULL));
+    fclose(r);
+
+    t = config.recent_tournaments;
+    ASSERT(t->pending);
+    ASSERT(revalidate_recent_tourns(config.recent_tournaments, config.recent_tournament_count));
+    ASSERT(!t->pending);
+    ASSERT(t->name == NULL);
+    ASSERT(!revalidate_recent_tourns(config.recent_tournaments, config.recent_tournament_count));
+
+    free_config(&config);
+    return 1;
+}
+
 static int test_pairing_types_str()
 {
     ASSERT(strcmp("Fluid Round", pairing_sys_str(FLUID_TOURN)) == 0);
@@ -348,6 +735,63 @@ static int test_pairing_types_str()
     return 1;
 }
 
+static recent_tournament_t *copy_recent_tourns(config_t *config, int player_count)
+{
+    int count = config->recent_tournament_count;
+    recent_tournament_t *ret = (recent_tournament_t *) malloc(sizeof * ret * count);
+    for (int i = 0; i < count; i++) {
+        ret[i] = clone_recent_tourn(*recent_tourn_at(config, i));
+        ret[i].player_count = player_count;
+        ret[i].pending = false;
+    }
+    return ret;
+}
+
+// Results from a revalidation that raced with opening a tournament are merged
+// by path, rather than dropped
+static int test_merge_recent_tourns()
+{
+    config_t config = DEFAULT_CONFIG;
+    recent_tournament_t t;
+    memset(&t, 0, sizeof(t));
+    char path[32];
+    t.file_path = path;
+    for (int i = 0; i < 3; i++) {
+        snprintf(path, sizeof(path), "merge%d.json", i);
+        ASSERT(add_recent_tourn(&config, t, NULL));
+    }
+    recent_tourn_at(&config, 1)->pending = true;
+
+    // Same list, all are replaced
+    recent_tournament_t *tourns = copy_recent_tourns(&config, 8);
+    ASSERT(merge_recent_tourns(&config, tourns, 3) == 3);
+    free(tourns);
+    for (int i = 0; i < 3; i++) {
+        ASSERT(recent_tourn_at(&config, i)->player_count == 8);
+        ASSERT(!recent_tourn_at(&config, i)->pending);
+    }
+
+    // A tournament was opened meanwhile, only the pending entry is replaced
+    recent_tourn_at(&config, 1)->pending = true;
+    tourns = copy_recent_tourns(&config, 16);
+    snprintf(path, sizeof(path), "merge%d.json", 0);
+    ASSERT(add_recent_tourn(&config, t, NULL));
+    snprintf(path, sizeof(path), "merge%d.json", 3);
+    ASSERT(add_recent_tourn(&config, t, NULL));
+    ASSERT(merge_recent_tourns(&config, tourns, 3) == 1);
+    free(tourns);
+
+    ASSERT(config.recent_tournament_count == 4);
+    ASSERT(strcmp(recent_tourn_at(&config, 0)->file_path, "merge1.json") == 0);
+    ASSERT(recent_tourn_at(&config, 0)->player_count == 16);
+    ASSERT(!recent_tourn_at(&config, 0)->pending);
+    ASSERT(recent_tourn_at(&config, 1)->player_count == 8);
+    ASSERT(recent_tourn_at(&config, 2)->player_count == 0);
+
+    free_config(&config);
+    return 1;
+}
+
 SUB_TEST(config_cpp_tests,
 {&test_default_tourn, "Test default tourn settings"},
 {&test_free_error, "Test free error case"},
@@ -359,8 +803,18 @@ SUB_TEST(config_cpp_tests,
 {&test_init_default_settings, "Test init with default settings"},
 {&test_add_recent_tourn_to_and_over_limit, "Adds MAXIMMUM_RECENT_LIST_SIZE + 1 recent tournaments"},
 {&test_add_recent_tourn, "Test add recent tourn"},
+{&test_add_recent_tourn_dedup, "Test add recent tourn dedup"},
+{&test_read_recent_tourns_dedup, "Test read recent tourns dedup"},
+{&test_save_config, "Test save config"},
+{&test_crash_report_endpoint, "Test crash report endpoint"},
 {&test_read_recent_tourns_no_file, "Test read config with recent tourns and no files"},
 {&test_recent_tourn_with_file, "Test read config with recent tourns and files"},
+{&test_recent_tourn_early_exit, "Test read recent tourn stops early"},
+{&test_recent_tourn_metadata, "Test read recent tourn player count and status"},
+{&test_recent_cache_hit, "Test recent tourn cache hit does not read the file"},
+{&test_recent_cache_stale, "Test stale recent tourn cache entries are re-read"},
+{&test_recent_deferred, "Test deferred recent tourns are read on revalidation"},
+{&test_merge_recent_tourns, "Test merge revalidated recent tourns"},
 {&test_pairing_types_str, "Test pairing_sys_str"}
         )
 
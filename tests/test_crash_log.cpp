@@ -0,0 +1,153 @@
+#include "./test_crash_log.h"
+#include "../src/crash_log.h"
+#include "../src/async_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define TEST_CRASH_LOG "test_crash_log.log"
+#define TEST_CAPACITY 64
+
+static std::string read_tail(size_t len)
+{
+    FILE *f = fopen(TEST_CRASH_LOG, "rb");
+    if (f == NULL) {
+        return "";
+    }
+
+    char *tail = crash_log_read_tail(f, len);
+    fclose(f);
+    if (tail == NULL) {
+        return "";
+    }
+
+    std::string ret = tail;
+    free(tail);
+    return ret;
+}
+
+static int test_append()
+{
+    ASSERT(crash_log_init(TEST_CRASH_LOG, TEST_CAPACITY));
+    ASSERT(read_tail(TEST_CAPACITY) == "");
+
+    crash_log_append("abc", 3);
+    crash_log_append("def", 3);
+    ASSERT(read_tail(TEST_CAPACITY) == "abcdef");
+    ASSERT(read_tail(2) == "ef");
+
+    crash_log_close();
+
+    // The file outlives the mapping
+    ASSERT(read_tail(TEST_CAPACITY) == "abcdef");
+    return 1;
+}
+
+// Only the last TEST_CAPACITY bytes are kept, oldest first
+static int test_wrap()
+{
+    ASSERT(crash_log_init(TEST_CRASH_LOG, TEST_CAPACITY));
+
+    std::string all;
+    for (int i = 0; i < 50; i++) {
+        char buffer[16];
+        int len = snprintf(buffer, sizeof(buffer), "%d,", i);
+        crash_log_append(buffer, len);
+        all += buffer;
+    }
+
+    ASSERT(read_tail(TEST_CAPACITY) == all.substr(all.size() - TEST_CAPACITY));
+    ASSERT(read_tail(10) == all.substr(all.size() - 10));
+
+    // A record longer than the ring keeps its end
+    std::string big(TEST_CAPACITY * 2 + 5, 'x');
+    big += "end";
+    crash_log_append(big.c_str(), big.size());
+    ASSERT(read_tail(TEST_CAPACITY) == big.substr(big.size() - TEST_CAPACITY));
+
+    crash_log_close();
+    return 1;
+}
+
+static int test_lprintf()
+{
+    ASSERT(crash_log_init(TEST_CRASH_LOG, TEST_CAPACITY));
+    lprintf(LOG_WARNING, "crash log %d\n", 123);
+    ASSERT(read_tail(TEST_CAPACITY) == "[WARNING] crash log 123\n");
+    crash_log_close();
+
+    // No-op once closed
+    crash_log_append("abc", 3);
+    return 1;
+}
+
+#define THREADS 4
+#define APPENDS 10000
+
+static int test_concurrent()
+{
+    ASSERT(crash_log_init(TEST_CRASH_LOG, 1024 * 1024));
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREADS; i++) {
+        threads.push_back(std::thread([]() {
+            for (int j = 0; j < APPENDS; j++) {
+                crash_log_append("0123456789\n", 11);
+            }
+        }));
+    }
+
+    for (std::thread &t : threads) {
+        t.join();
+    }
+
+    std::string tail = read_tail(1024 * 1024);
+    ASSERT(tail.size() == THREADS * APPENDS * 11);
+    for (size_t i = 0; i < tail.size(); i += 11) {
+        ASSERT(tail.compare(i, 11, "0123456789\n") == 0);
+    }
+
+    crash_log_close();
+    return 1;
+}
+
+static int test_signal_report()
+{
+    ASSERT(crash_log_init(TEST_CRASH_LOG, 64 * 1024));
+    crash_log_signal_report(11, "Context line\n");
+    crash_log_close();
+
+    std::string tail = read_tail(64 * 1024);
+    ASSERT(tail.find("Signal 11:\n") != std::string::npos);
+    ASSERT(tail.find("Context line\n") == tail.size() - strlen("Context line\n"));
+    return 1;
+}
+
+static int test_not_crash_log()
+{
+    FILE *f = fopen(TEST_CRASH_LOG, "wb");
+    ASSERT(f != NULL);
+    fprintf(f, "This is not a crash log, it is long enough to have a header though\n");
+    fclose(f);
+
+    ASSERT(read_tail(TEST_CAPACITY) == "");
+
+    f = fopen(TEST_CRASH_LOG, "wb");
+    ASSERT(f != NULL);
+    fclose(f);
+
+    ASSERT(read_tail(TEST_CAPACITY) == "");
+    return 1;
+}
+
+SUB_TEST(crash_log_cpp_test,
+{&test_append, "Test crash log append"},
+{&test_wrap, "Test crash log wrap around"},
+{&test_lprintf, "Test crash log gets log records"},
+{&test_concurrent, "Test crash log concurrent appends"},
+{&test_signal_report, "Test crash log signal report"},
+{&test_not_crash_log, "Test crash log read invalid file"}
+        )
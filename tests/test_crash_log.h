@@ -0,0 +1,4 @@
+#pragma once
+#include "../testing_h/testing.h"
+
+int crash_log_cpp_test();
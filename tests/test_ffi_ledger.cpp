@@ -0,0 +1,68 @@
+#include "./test_ffi_ledger.h"
+#include "../src/ffi_ledger.h"
+
+static int test_alloc_free()
+{
+    ffi_ledger_reset();
+    char a[8], b[32];
+    ffi_ledger_alloc(a, sizeof(a), "test_a");
+    ffi_ledger_alloc(b, sizeof(b), "test_b");
+
+    ffi_ledger_stats_t s = ffi_ledger_stats();
+    ASSERT(s.allocs == 2);
+    ASSERT(s.alloc_bytes == sizeof(a) + sizeof(b));
+    ASSERT(s.live_allocs == 2);
+    ASSERT(s.live_bytes == sizeof(a) + sizeof(b));
+
+    ASSERT(ffi_ledger_free(a, sizeof(a), "test_free") == sizeof(a));
+    ASSERT(ffi_ledger_free(b, sizeof(b), "test_free") == sizeof(b));
+
+    s = ffi_ledger_stats();
+    ASSERT(s.frees == 2);
+    ASSERT(s.free_bytes == sizeof(a) + sizeof(b));
+    ASSERT(s.bad_frees == 0);
+    ASSERT(s.live_allocs == 0);
+    ASSERT(s.live_bytes == 0);
+    ASSERT(ffi_ledger_report_leaks() == 0);
+    return 1;
+}
+
+// The recorded size is used when the caller has the wrong one
+static int test_bad_frees()
+{
+    ffi_ledger_reset();
+    char a[48];
+    ffi_ledger_alloc(a, sizeof(a), "test_bad_free");
+    ASSERT(ffi_ledger_free(a, 3, "test_bad_free") == sizeof(a));
+    ASSERT(ffi_ledger_stats().bad_frees == 1);
+
+    // Double free
+    ASSERT(ffi_ledger_free(a, sizeof(a), "test_bad_free") == sizeof(a));
+    ASSERT(ffi_ledger_stats().bad_frees == 2);
+    ASSERT(ffi_ledger_stats().live_allocs == 0);
+    return 1;
+}
+
+static int test_leaks()
+{
+    ffi_ledger_reset();
+    char a[4], b[4], c[4];
+    ffi_ledger_alloc(a, sizeof(a), "test_leak_a");
+    ffi_ledger_alloc(b, sizeof(b), "test_leak_a");
+    ffi_ledger_alloc(c, sizeof(c), "test_leak_b");
+    ffi_ledger_free(b, sizeof(b), "test_leaks");
+
+    ASSERT(ffi_ledger_report_leaks() == 2);
+    ffi_ledger_log();
+
+    ffi_ledger_reset();
+    ASSERT(ffi_ledger_report_leaks() == 0);
+    ASSERT(ffi_ledger_stats().allocs == 0);
+    return 1;
+}
+
+SUB_TEST(ffi_ledger_cpp_test,
+{&test_alloc_free, "Test FFI ledger alloc and, free"},
+{&test_bad_frees, "Test FFI ledger bad frees"},
+{&test_leaks, "Test FFI ledger leaks"}
+        )
@@ -0,0 +1,153 @@
+#include "./test_ffi_stats.h"
+#include "../src/ffi_stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#define TEST_FFI_STATS_FILE "test_ffi_stats.json"
+
+static const ffi_stat_totals_t *find_totals(const std::vector<ffi_stat_totals_t> &totals, const char *name)
+{
+    for (const ffi_stat_totals_t &t : totals) {
+        if (strcmp(t.name, name) == 0) {
+            return &t;
+        }
+    }
+    return NULL;
+}
+
+static int test_bucket()
+{
+    ASSERT(ffi_stats_bucket(0) == 0);
+    ASSERT(ffi_stats_bucket(1) == 1);
+    ASSERT(ffi_stats_bucket(2) == 2);
+    ASSERT(ffi_stats_bucket(3) == 2);
+    ASSERT(ffi_stats_bucket(4) == 3);
+    ASSERT(ffi_stats_bucket(1023) == 10);
+    ASSERT(ffi_stats_bucket(1024) == 11);
+    ASSERT(ffi_stats_bucket(UINT64_MAX) == FFI_STATS_BUCKETS - 1);
+    return 1;
+}
+
+static int test_register()
+{
+    ffi_stat_t *a = ffi_stats_register("test_register_a");
+    ffi_stat_t *b = ffi_stats_register("test_register_b");
+    ASSERT(a != NULL);
+    ASSERT(b != NULL);
+    ASSERT(a != b);
+    ASSERT(ffi_stats_register("test_register_a") == a);
+    return 1;
+}
+
+static int test_record()
+{
+    ffi_stats_reset();
+    ffi_stat_t *s = ffi_stats_register("test_record");
+    ffi_stats_record(s, 100);
+    ffi_stats_record(s, 300);
+    ffi_stats_record(s, 2000);
+    ffi_stats_record(NULL, 100);
+
+    std::vector<ffi_stat_totals_t> totals = ffi_stats_totals();
+    const ffi_stat_totals_t *t = find_totals(totals, "test_record");
+    ASSERT(t != NULL);
+    ASSERT(t->calls == 3);
+    ASSERT(t->total_ns == 2400);
+    ASSERT(t->max_ns == 2000);
+    ASSERT(t->buckets[ffi_stats_bucket(100)] == 1);
+    ASSERT(t->buckets[ffi_stats_bucket(300)] == 1);
+    ASSERT(t->buckets[ffi_stats_bucket(2000)] == 1);
+
+    ffi_stats_reset();
+    ASSERT(find_totals(ffi_stats_totals(), "test_record") == NULL);
+    return 1;
+}
+
+static int add(int a, int b)
+{
+    return a + b;
+}
+
+#define THREADS 4
+#define CALLS 10000
+
+// Each thread counts into its own counters, the totals are summed
+static int test_call_macro_threads()
+{
+    ffi_stats_reset();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREADS; i++) {
+        threads.push_back(std::thread([]() {
+            int sum = 0;
+            for (int j = 0; j < CALLS; j++) {
+                sum = FFI_STAT_CALL("test_add", add(sum, 1));
+            }
+            ASSERT(sum == CALLS);
+            return 1;
+        }));
+    }
+
+    for (std::thread &t : threads) {
+        t.join();
+    }
+
+    std::vector<ffi_stat_totals_t> totals = ffi_stats_totals();
+    const ffi_stat_totals_t *t = find_totals(totals, "test_add");
+    ASSERT(t != NULL);
+    ASSERT(t->calls == THREADS * CALLS);
+
+    uint64_t bucket_sum = 0;
+    for (size_t i = 0; i < FFI_STATS_BUCKETS; i++) {
+        bucket_sum += t->buckets[i];
+    }
+    ASSERT(bucket_sum == t->calls);
+    return 1;
+}
+
+static int test_json()
+{
+    ffi_stats_reset();
+    ffi_stat_t *slow = ffi_stats_register("test_json_slow");
+    ffi_stat_t *fast = ffi_stats_register("test_json_fast");
+    ffi_stats_record(fast, 10);
+    ffi_stats_record(fast, 10);
+    ffi_stats_record(slow, 5000);
+
+    ASSERT(ffi_stats_write(TEST_FFI_STATS_FILE));
+    FILE *f = fopen(TEST_FFI_STATS_FILE, "r");
+    ASSERT(f != NULL);
+
+    nlohmann::json j = nlohmann::json::parse(f);
+    fclose(f);
+    remove(TEST_FFI_STATS_FILE);
+
+    nlohmann::json functions = j.at(FFI_STATS_FUNCTIONS);
+    ASSERT(functions.size() == 2);
+
+    // The most total time first
+    ASSERT(functions[0].at(FFI_STATS_NAME) == "test_json_slow");
+    ASSERT(functions[1].at(FFI_STATS_NAME) == "test_json_fast");
+    ASSERT(functions[1].at(FFI_STATS_CALLS) == 2);
+    ASSERT(functions[1].at(FFI_STATS_TOTAL_NS) == 20);
+    ASSERT(functions[1].at(FFI_STATS_MEAN_NS) == 10);
+
+    nlohmann::json histogram = functions[1].at(FFI_STATS_HISTOGRAM);
+    ASSERT(histogram.size() == 1);
+    ASSERT(histogram[0][0] == 16);
+    ASSERT(histogram[0][1] == 2);
+
+    ffi_stats_log();
+    ffi_stats_reset();
+    return 1;
+}
+
+SUB_TEST(ffi_stats_cpp_test,
+{&test_bucket, "Test FFI stats histogram buckets"},
+{&test_register, "Test FFI stats register"},
+{&test_record, "Test FFI stats record and, reset"},
+{&test_call_macro_threads, "Test FFI stats call macro across threads"},
+{&test_json, "Test FFI stats json"}
+        )
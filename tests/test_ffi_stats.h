@@ -0,0 +1,4 @@
+#pragma once
+#include "../testing_h/testing.h"
+
+int ffi_stats_cpp_test();
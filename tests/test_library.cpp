@@ -0,0 +1,172 @@
+#include "./test_library.h"
+#include "../src/library.h"
+#include "../src/filerable_list.hpp"
+#include <string.h>
+#include <filesystem>
+
+#define TEST_LIBRARY_DIR "library_test/"
+#define TEST_LIBRARY_SUB_DIR TEST_LIBRARY_DIR "2022/"
+#define TEST_LIBRARY_COUNT 3
+
+static const char *test_names[TEST_LIBRARY_COUNT] = {"Alpha Open", "Beta Cup", "Gamma League"};
+static const char *test_formats[TEST_LIBRARY_COUNT] = {"cEDH", "Modern", "cEDH"};
+static const char *test_pairings[TEST_LIBRARY_COUNT] = {PAIRING_SWISS, PAIRING_FLUID, PAIRING_SWISS};
+
+static std::string test_path(int i)
+{
+    return std::string(i == 0 ? TEST_LIBRARY_SUB_DIR : TEST_LIBRARY_DIR) + "t" + std::to_string(i) + TOURNAMENT_EXTENTION;
+}
+
+static bool make_library()
+{
+    std::filesystem::remove_all(TEST_LIBRARY_DIR);
+    std::filesystem::create_directories(TEST_LIBRARY_SUB_DIR);
+
+    for (int i = 0; i < TEST_LIBRARY_COUNT; i++) {
+        FILE *f = fopen(test_path(i).c_str(), "w");
+        if (f == NULL) {
+            return false;
+        }
+
+        fprintf(f, "{\"name\":\"%s\",\"format\":\"%s\",\"pairing_sys\":{\"style\":{\"%s\":{}}},"
+                "\"player_reg\":{\"players\":{\"a\":{},\"b\":{}}},\"status\":\"Started\"}",
+                test_names[i], test_formats[i], test_pairings[i]);
+        fclose(f);
+    }
+
+    // Not a tournament
+    FILE *f = fopen(TEST_LIBRARY_DIR "notes.txt", "w");
+    if (f == NULL) {
+        return false;
+    }
+    fprintf(f, "not json");
+    fclose(f);
+    return true;
+}
+
+static int test_find_files()
+{
+    ASSERT(make_library());
+    std::vector<std::string> files = library_find_files(TEST_LIBRARY_DIR);
+    ASSERT(files.size() == TEST_LIBRARY_COUNT);
+
+    ASSERT(library_find_files(TEST_LIBRARY_DIR "missing/").size() == 0);
+    return 1;
+}
+
+static int test_index()
+{
+    ASSERT(make_library());
+    std::vector<std::string> files = library_find_files(TEST_LIBRARY_DIR);
+    files.push_back(files[0]); // Duplicates are dropped
+    files.push_back(TEST_LIBRARY_DIR "missing" TOURNAMENT_EXTENTION);
+
+    std::vector<LibraryEntry> entries = library_index(files, NULL);
+    ASSERT(entries.size() == TEST_LIBRARY_COUNT);
+
+    for (int i = 0; i < TEST_LIBRARY_COUNT; i++) {
+        bool found = false;
+        for (LibraryEntry &e : entries) {
+            if (e.path != test_path(i)) {
+                continue;
+            }
+
+            found = true;
+            ASSERT(e.meta.name == test_names[i]);
+            ASSERT(e.meta.format == test_formats[i]);
+            ASSERT(e.meta.pairing_sys == test_pairings[i]);
+            ASSERT(e.meta.player_count == 2);
+            ASSERT(e.meta.status == TOURN_STATUS_STARTED);
+            ASSERT(e.meta.file_size > 0);
+        }
+        ASSERT(found);
+    }
+    return 1;
+}
+
+static int test_index_cached()
+{
+    ASSERT(make_library());
+    std::vector<std::string> files = library_find_files(TEST_LIBRARY_DIR);
+    std::vector<LibraryEntry> entries = library_index(files, NULL);
+    ASSERT(entries.size() == TEST_LIBRARY_COUNT);
+
+    // Cached entries are not read again so, a changed name in the cache is kept
+    for (LibraryEntry &e : entries) {
+        e.meta.name = "Cached";
+    }
+
+    // Unless the file has changed
+    LibraryEntry &stale = entries[0];
+    stale.meta.file_size++;
+
+    FILE *cache = tmpfile();
+    ASSERT(cache != NULL);
+    ASSERT(library_write_cache(entries, cache));
+    rewind(cache);
+
+    std::vector<LibraryEntry> cached = library_index(files, cache);
+    fclose(cache);
+    ASSERT(cached.size() == TEST_LIBRARY_COUNT);
+
+    int hits = 0;
+    for (LibraryEntry &e : cached) {
+        if (e.path == stale.path) {
+            ASSERT(e.meta.name != "Cached");
+        } else {
+            ASSERT(e.meta.name == "Cached");
+            hits++;
+        }
+    }
+    ASSERT(hits == TEST_LIBRARY_COUNT - 1);
+
+    // A bad cache is ignored
+    cache = tmpfile();
+    ASSERT(cache != NULL);
+    fprintf(cache, "{{ not json");
+    rewind(cache);
+    ASSERT(library_index(files, cache).size() == TEST_LIBRARY_COUNT);
+    fclose(cache);
+    return 1;
+}
+
+static int test_search_sort()
+{
+    ASSERT(make_library());
+    std::vector<LibraryEntry> entries = library_index(library_find_files(TEST_LIBRARY_DIR), NULL);
+    ASSERT(entries.size() == TEST_LIBRARY_COUNT);
+
+    LibraryEntry e = entries[0];
+    ASSERT(e.matches(""));
+    ASSERT(e.matches(e.meta.name));
+    ASSERT(e.matches("CEDH") == (e.meta.format == "cEDH"));
+    ASSERT(!e.matches("not in the library"));
+
+    FilteredList<LibraryEntry> flist(entries, &cmpLibName);
+    ASSERT(flist.size() == TEST_LIBRARY_COUNT);
+    ASSERT(flist.at(0).meta.name == test_names[0]);
+    ASSERT(flist.at(2).meta.name == test_names[2]);
+
+    flist.filter("cedh");
+    ASSERT(flist.size() == 2);
+
+    flist.filter(PAIRING_FLUID);
+    ASSERT(flist.size() == 1);
+    ASSERT(flist.at(0).meta.name == test_names[1]);
+
+    flist.filter("");
+    flist.sort(&cmpLibFormat);
+    ASSERT(flist.at(0).meta.format == "Modern");
+    ASSERT(flist.at(2).meta.format == "cEDH");
+
+    ASSERT(e.getDefaultAlgs().size() == 5);
+    std::filesystem::remove_all(TEST_LIBRARY_DIR);
+    return 1;
+}
+
+SUB_TEST(library_cpp_test,
+{&test_find_files, "Test library find files"},
+{&test_index, "Test library index"},
+{&test_index_cached, "Test library index from the cache"},
+{&test_search_sort, "Test library search and sort"}
+        )
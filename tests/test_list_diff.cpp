@@ -0,0 +1,82 @@
+#include "./test_list_diff.h"
+#include "../src/list_diff.h"
+#include <algorithm>
+#include <random>
+
+static int check_diff(std::vector<std::string> a, std::vector<std::string> b)
+{
+    std::vector<list_op_t> ops = list_diff(a, b);
+    for (const list_op_t &op : ops) {
+        if (op.type == LIST_OP_MOVE) {
+            ASSERT(op.to < op.from);
+        }
+    }
+
+    list_diff_apply(a, ops, b);
+    ASSERT(a == b);
+    return 1;
+}
+
+static int test_same()
+{
+    std::vector<std::string> a = {"a", "b", "c"};
+    ASSERT(list_diff(a, a).size() == 0);
+    ASSERT(list_diff({}, {}).size() == 0);
+    return 1;
+}
+
+static int test_swap()
+{
+    std::vector<list_op_t> ops = list_diff({"a", "b", "c"}, {"b", "a", "c"});
+    ASSERT(ops.size() == 1);
+    ASSERT(ops[0].type == LIST_OP_MOVE);
+    ASSERT(ops[0].from == 1);
+    ASSERT(ops[0].to == 0);
+    ASSERT(check_diff({"a", "b", "c"}, {"b", "a", "c"}));
+    return 1;
+}
+
+static int test_insert_remove()
+{
+    std::vector<list_op_t> ops = list_diff({"a", "b"}, {"a", "c", "b"});
+    ASSERT(ops.size() == 1);
+    ASSERT(ops[0].type == LIST_OP_INSERT);
+    ASSERT(ops[0].to == 1);
+
+    ops = list_diff({"a", "b", "c"}, {"a", "c"});
+    ASSERT(ops.size() == 1);
+    ASSERT(ops[0].type == LIST_OP_REMOVE);
+    ASSERT(ops[0].from == 1);
+
+    ASSERT(check_diff({}, {"a", "b"}));
+    ASSERT(check_diff({"a", "b"}, {}));
+    ASSERT(check_diff({"a", "b", "c", "d"}, {"e", "d", "a"}));
+    return 1;
+}
+
+static int test_shuffles()
+{
+    std::mt19937 rng(1);
+    for (int i = 0; i < 200; i++) {
+        std::vector<std::string> a, b;
+        for (int j = 0; j < 20; j++) {
+            if (rng() % 4 != 0) {
+                a.push_back(std::to_string(j));
+            }
+            if (rng() % 4 != 0) {
+                b.push_back(std::to_string(j));
+            }
+        }
+        std::shuffle(a.begin(), a.end(), rng);
+        std::shuffle(b.begin(), b.end(), rng);
+        ASSERT(check_diff(a, b));
+    }
+    return 1;
+}
+
+SUB_TEST(list_diff_cpp_test,
+{&test_same, "Test list diff of the same list"},
+{&test_swap, "Test list diff of two swapped rows"},
+{&test_insert_remove, "Test list diff inserts and, removes"},
+{&test_shuffles, "Test list diff of random lists"}
+        )
@@ -0,0 +1,4 @@
+#pragma once
+#include "../testing_h/testing.h"
+
+int list_diff_cpp_test();
@@ -0,0 +1,287 @@
+#include "./test_preload_queue.h"
+#include "../src/preload_queue.h"
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static std::atomic<int> loads(0);
+static std::atomic<int> frees(0);
+static std::atomic<int> concurrent(0);
+static std::atomic<int> max_concurrent(0);
+
+#define TEST_PRELOAD_FILE "test_preload.json"
+
+// The result is a copy of the path, "bad" cannot be loaded
+static void *test_load(const std::string &path)
+{
+    int c = ++concurrent;
+    if (c > max_concurrent) {
+        max_concurrent = c;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    loads++;
+    concurrent--;
+    if (path == "bad") {
+        return NULL;
+    }
+    return new std::string(path);
+}
+
+static void test_free(void *r)
+{
+    frees++;
+    delete (std::string *) r;
+}
+
+static void reset()
+{
+    loads = 0;
+    frees = 0;
+    concurrent = 0;
+    max_concurrent = 0;
+}
+
+static bool take_is(preload_queue_t *q, std::string path)
+{
+    std::string *r = (std::string *) preload_take(q, path);
+    bool ret = r != NULL && *r == path;
+    delete r;
+    return ret;
+}
+
+static int test_take_without_request()
+{
+    reset();
+    preload_queue_t q;
+    preload_queue_init(&q, &test_load, &test_free, PRELOAD_MAX_READY);
+
+    ASSERT(take_is(&q, "a"));
+    ASSERT(loads == 1);
+    ASSERT(preload_take(&q, "bad") == NULL);
+
+    preload_queue_free(&q);
+    ASSERT(frees == 0);
+    return 1;
+}
+
+static int test_preloaded()
+{
+    reset();
+    preload_queue_t q;
+    preload_queue_init(&q, &test_load, &test_free, PRELOAD_MAX_READY);
+
+    preload_request(&q, "a");
+    preload_request(&q, "a"); // Queued once
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT(loads == 1);
+
+    // Already loaded
+    ASSERT(take_is(&q, "a"));
+    ASSERT(loads == 1);
+
+    // Taken results are not kept
+    ASSERT(take_is(&q, "a"));
+    ASSERT(loads == 2);
+
+    preload_queue_free(&q);
+    ASSERT(frees == 0);
+    return 1;
+}
+
+static int test_evict()
+{
+    reset();
+    preload_queue_t q;
+    preload_queue_init(&q, &test_load, &test_free, 1);
+
+    preload_request(&q, "a");
+    preload_request(&q, "b");
+    preload_request(&q, "c");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT(take_is(&q, "c"));
+
+    // a and b were loaded then evicted in turn
+    ASSERT(loads == 3);
+    ASSERT(frees == 2);
+
+    preload_request(&q, "d");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    preload_queue_free(&q);
+    ASSERT(frees == 3);
+    return 1;
+}
+
+static int test_serial_loads()
+{
+    reset();
+    preload_queue_t q;
+    preload_queue_init(&q, &test_load, &test_free, 8);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; i++) {
+        threads.push_back(std::thread([&q, i]() {
+            preload_request(&q, std::to_string(i + 8));
+            take_is(&q, std::to_string(i));
+        }));
+    }
+
+    for (std::thread &t : threads) {
+        t.join();
+    }
+
+    preload_queue_free(&q);
+    ASSERT(max_concurrent == 1);
+    ASSERT(loads + frees >= 8);
+    return 1;
+}
+
+static int test_notify()
+{
+    reset();
+    preload_queue_t q;
+    preload_queue_init(&q, &test_load, &test_free, 1);
+
+    std::mutex lock;
+    std::vector<std::string> done;
+    preload_done_t on_done = [&lock, &done](const std::string &path) {
+        std::lock_guard<std::mutex> l(lock);
+        done.push_back(path);
+    };
+
+    // More than max_ready are kept as they were asked for with a callback
+    preload_request_notify(&q, "a", on_done);
+    preload_request_notify(&q, "b", on_done);
+    preload_request_notify(&q, "c", on_done);
+    preload_request(&q, "d");
+    preload_request(&q, "e");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    {
+        std::lock_guard<std::mutex> l(lock);
+        ASSERT(done.size() == 3);
+        ASSERT(done[0] == "a");
+        ASSERT(done[2] == "c");
+    }
+    ASSERT(frees == 1);
+
+    ASSERT(take_is(&q, "b"));
+    ASSERT(take_is(&q, "a"));
+    ASSERT(take_is(&q, "c"));
+    ASSERT(loads == 5);
+
+    // Loaded already so, it is called at once
+    preload_request_notify(&q, "e", on_done);
+    {
+        std::lock_guard<std::mutex> l(lock);
+        ASSERT(done.size() == 4);
+    }
+    ASSERT(take_is(&q, "e"));
+    ASSERT(loads == 5);
+
+    preload_queue_free(&q);
+    ASSERT(frees == 1);
+    return 1;
+}
+
+static bool write_file(const char *txt)
+{
+    FILE *f = fopen(TEST_PRELOAD_FILE, "w");
+    if (f == NULL) {
+        return false;
+    }
+    fputs(txt, f);
+    fclose(f);
+    return true;
+}
+
+static int test_stale()
+{
+    reset();
+    ASSERT(write_file("{}"));
+    preload_queue_t q;
+    preload_queue_init(&q, &test_load, &test_free, PRELOAD_MAX_READY);
+
+    preload_request(&q, TEST_PRELOAD_FILE);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT(loads == 1);
+
+    // Saved after it was preloaded so, the copy is freed and it is loaded again
+    ASSERT(write_file("{\"saved\": true}"));
+    ASSERT(take_is(&q, TEST_PRELOAD_FILE));
+    ASSERT(loads == 2);
+    ASSERT(frees == 1);
+
+    // Unchanged since it was loaded
+    preload_request(&q, TEST_PRELOAD_FILE);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT(take_is(&q, TEST_PRELOAD_FILE));
+    ASSERT(loads == 3);
+    ASSERT(frees == 1);
+
+    preload_queue_free(&q);
+    remove(TEST_PRELOAD_FILE);
+    return 1;
+}
+
+static int test_invalidate()
+{
+    reset();
+    preload_queue_t q;
+    preload_queue_init(&q, &test_load, &test_free, PRELOAD_MAX_READY);
+
+    preload_request(&q, "a");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    preload_invalidate(&q, "a");
+    ASSERT(frees == 1);
+
+    ASSERT(take_is(&q, "a"));
+    ASSERT(loads == 2);
+
+    // Nothing to free
+    preload_invalidate(&q, "a");
+    ASSERT(frees == 1);
+
+    preload_queue_free(&q);
+    return 1;
+}
+
+static int test_pause()
+{
+    reset();
+    preload_queue_t q;
+    preload_queue_init(&q, &test_load, &test_free, PRELOAD_MAX_READY);
+
+    // Speculative loads wait
+    preload_queue_pause(&q, true);
+    preload_request(&q, "a");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT(loads == 0);
+
+    // Taken files jump the pause
+    ASSERT(take_is(&q, "b"));
+    ASSERT(loads == 1);
+
+    preload_queue_pause(&q, false);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT(loads == 2);
+    ASSERT(take_is(&q, "a"));
+    ASSERT(loads == 2);
+
+    preload_queue_free(&q);
+    ASSERT(frees == 0);
+    return 1;
+}
+
+SUB_TEST(preload_queue_cpp_test,
+{&test_take_without_request, "Test preload take without a request"},
+{&test_preloaded, "Test preload take after a request"},
+{&test_evict, "Test preload evicts unclaimed results"},
+{&test_serial_loads, "Test preload loads one file at a time"},
+{&test_notify, "Test preload keeps and, reports notified results"},
+{&test_stale, "Test preload reloads files that changed"},
+{&test_invalidate, "Test preload invalidate"},
+{&test_pause, "Test preload pause"}
+        )
@@ -0,0 +1,4 @@
+#pragma once
+#include "../testing_h/testing.h"
+
+int preload_queue_cpp_test();
@@ -0,0 +1,87 @@
+#include "./test_presence_queue.h"
+#include "../src/presence_queue.h"
+#include <chrono>
+#include <thread>
+
+static int test_latest_only()
+{
+    presence_queue_t q;
+    std::string txt;
+    ASSERT(!presence_queue_wait(&q, &txt, 0));
+
+    presence_queue_push(&q, "a");
+    presence_queue_push(&q, "b");
+    ASSERT(presence_queue_wait(&q, &txt, 0));
+    ASSERT(txt == "b");
+    ASSERT(!presence_queue_wait(&q, &txt, 0));
+    return 1;
+}
+
+static int test_wakes_on_push()
+{
+    presence_queue_t q;
+    std::string txt;
+    std::thread t([&q]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        presence_queue_push(&q, "test");
+    });
+
+    // Would take a minute without the push
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ASSERT(presence_queue_wait(&q, &txt, 60000));
+    t.join();
+    ASSERT(txt == "test");
+    ASSERT(std::chrono::steady_clock::now() - start < std::chrono::seconds(30));
+    return 1;
+}
+
+static int test_wakes_on_stop()
+{
+    presence_queue_t q;
+    std::string txt;
+    ASSERT(presence_queue_running(&q));
+
+    std::thread t([&q]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        presence_queue_stop(&q);
+    });
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ASSERT(!presence_queue_wait(&q, &txt, 60000));
+    t.join();
+    ASSERT(!presence_queue_running(&q));
+    ASSERT(std::chrono::steady_clock::now() - start < std::chrono::seconds(30));
+
+    // Text is not handed out once stopped
+    presence_queue_push(&q, "test");
+    ASSERT(!presence_queue_wait(&q, &txt, 0));
+    return 1;
+}
+
+static int test_backoff()
+{
+    ASSERT(presence_backoff_ms(0) == PRESENCE_BACKOFF_MIN_MS);
+    ASSERT(presence_backoff_ms(1) == PRESENCE_BACKOFF_MIN_MS);
+    ASSERT(presence_backoff_ms(2) == PRESENCE_BACKOFF_MIN_MS * 2);
+    ASSERT(presence_backoff_ms(3) == PRESENCE_BACKOFF_MIN_MS * 4);
+    ASSERT(presence_backoff_ms(100) == PRESENCE_BACKOFF_MAX_MS);
+    ASSERT(presence_backoff_ms(1 << 30) == PRESENCE_BACKOFF_MAX_MS);
+    return 1;
+}
+
+static int test_pump_interval()
+{
+    ASSERT(presence_pump_interval_ms(0, false) == PRESENCE_PUMP_MIN_MS);
+    ASSERT(presence_pump_interval_ms(PRESENCE_PUMP_MIN_MS, false) == PRESENCE_PUMP_MIN_MS * 2);
+    ASSERT(presence_pump_interval_ms(PRESENCE_PUMP_MAX_MS, false) == PRESENCE_PUMP_MAX_MS);
+    ASSERT(presence_pump_interval_ms(PRESENCE_PUMP_MAX_MS, true) == PRESENCE_PUMP_MIN_MS);
+    return 1;
+}
+
+SUB_TEST(presence_queue_cpp_test,
+{&test_latest_only, "Test presence queue keeps the latest text"},
+{&test_wakes_on_push, "Test presence queue wakes on push"},
+{&test_wakes_on_stop, "Test presence queue wakes on stop"},
+{&test_backoff, "Test presence connection backoff"},
+{&test_pump_interval, "Test presence pump interval"}
+        )
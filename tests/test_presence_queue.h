@@ -0,0 +1,4 @@
+#pragma once
+#include "../testing_h/testing.h"
+
+int presence_queue_cpp_test();
@@ -0,0 +1,130 @@
+#include "./test_rng_job.h"
+#include "../src/rng_job.h"
+#include <mutex>
+#include <vector>
+
+#define JOB_COINS (3LL * RNG_JOB_COIN_CHUNK + 17)
+#define JOB_DICE (2LL * RNG_JOB_DICE_CHUNK + 5)
+#define JOB_SIDES 6
+#define JOB_HUGE (1LL << 50)
+
+typedef struct reports_t {
+    std::mutex lock;
+    std::vector<rng_progress_t> list;
+} reports_t;
+
+static rng_report_t record(reports_t *r)
+{
+    return [r](rng_progress_t p) {
+        std::lock_guard<std::mutex> l(r->lock);
+        r->list.push_back(p);
+    };
+}
+
+static int test_coins_job()
+{
+    rng_job_t job;
+    rng_job_init(&job);
+    reports_t r;
+    ASSERT(rng_job_flip_coins(&job, JOB_COINS, false, record(&r)));
+    rng_job_wait(&job);
+    ASSERT(!rng_job_running(&job));
+
+    ASSERT(r.list.size() > 0);
+    rng_progress_t last = r.list.back();
+    ASSERT(last.finished);
+    ASSERT(last.done == JOB_COINS);
+    ASSERT(last.total == JOB_COINS);
+    ASSERT(last.heads > 0 && last.heads < JOB_COINS);
+
+    // Only the last one is finished and, they only go up
+    for (size_t i = 1; i < r.list.size(); i++) {
+        ASSERT(!r.list[i - 1].finished);
+        ASSERT(r.list[i - 1].done <= r.list[i].done);
+    }
+    return 1;
+}
+
+static int test_dice_job()
+{
+    rng_job_t job;
+    rng_job_init(&job);
+    reports_t r;
+    ASSERT(rng_job_roll_dice(&job, JOB_SIDES, JOB_DICE, record(&r)));
+    rng_job_wait(&job);
+
+    rng_progress_t last = r.list.back();
+    ASSERT(last.finished);
+    ASSERT(last.done == JOB_DICE);
+
+    dice_roll_ret_t dice;
+    ASSERT(rng_job_take_dice(&job, &dice));
+    ASSERT(dice.results != NULL);
+    ASSERT(dice.sides == JOB_SIDES);
+    ASSERT(dice.dice_rolled == JOB_DICE);
+
+    long long total = 0;
+    for (int i = 0; i < JOB_SIDES; i++) {
+        total += dice.results[i].number_rolled;
+    }
+    ASSERT(total == JOB_DICE);
+    free_dice_roll_ret(dice);
+
+    // Taken once
+    ASSERT(!rng_job_take_dice(&job, &dice));
+
+    // Every report has the distribution so far
+    for (rng_progress_t &p : r.list) {
+        ASSERT(p.faces.size() == JOB_SIDES);
+        long long rolled = 0;
+        for (dice_roll_res_line_t &f : p.faces) {
+            rolled += f.number_rolled;
+        }
+        ASSERT(rolled == p.done);
+    }
+
+    // A roll that is never taken is freed by the job
+    ASSERT(rng_job_roll_dice(&job, JOB_SIDES, JOB_DICE, record(&r)));
+    rng_job_wait(&job);
+    ASSERT(job.dice.results != NULL);
+    rng_job_cancel(&job);
+    ASSERT(job.dice.results == NULL);
+    return 1;
+}
+
+static int test_cancel()
+{
+    rng_job_t job;
+    rng_job_init(&job);
+    reports_t r;
+    ASSERT(rng_job_flip_coins(&job, JOB_HUGE, true, record(&r)));
+    ASSERT(rng_job_running(&job));
+
+    // Only one at a time
+    ASSERT(!rng_job_roll_dice(&job, JOB_SIDES, JOB_DICE, record(&r)));
+
+    rng_job_cancel(&job);
+    ASSERT(!rng_job_running(&job));
+    rng_progress_t last = r.list.back();
+    ASSERT(last.finished);
+    ASSERT(last.done < JOB_HUGE);
+
+    // The job can be reused
+    reports_t r2;
+    ASSERT(rng_job_roll_dice(&job, JOB_SIDES, JOB_HUGE, record(&r2)));
+    rng_job_cancel(&job);
+    last = r2.list.back();
+    ASSERT(last.finished);
+    ASSERT(last.done < JOB_HUGE);
+
+    // Cancelled rolls are freed on the worker
+    dice_roll_ret_t dice;
+    ASSERT(!rng_job_take_dice(&job, &dice));
+    return 1;
+}
+
+SUB_TEST(rng_job_cpp_test,
+{&test_coins_job, "Test RNG job flips coins"},
+{&test_dice_job, "Test RNG job rolls dice"},
+{&test_cancel, "Test RNG job cancel"}
+        )
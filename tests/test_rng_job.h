@@ -0,0 +1,4 @@
+#pragma once
+#include "../testing_h/testing.h"
+
+int rng_job_cpp_test();
@@ -0,0 +1,121 @@
+#include <math.h>
+#include <stdlib.h>
+#include "../src/rng_stats.h"
+#include "./test_rng_stats.h"
+
+#define CLOSE_TO(a, b) (fabs((a) - (b)) < 0.001)
+
+static int test_chi_square_stat()
+{
+    double observed[] = {10, 20, 30};
+    double expected[] = {20, 20, 20};
+    ASSERT(CLOSE_TO(chi_square_stat(observed, expected, 3), 10.0));
+    ASSERT(chi_square_stat(expected, expected, 3) == 0);
+    return 1;
+}
+
+static int test_chi_square_p_value()
+{
+    // Critical values from standard chi-square tables
+    ASSERT(CLOSE_TO(chi_square_p_value(3.841, 1), 0.05));
+    ASSERT(CLOSE_TO(chi_square_p_value(11.070, 5), 0.05));
+    ASSERT(CLOSE_TO(chi_square_p_value(30.144, 19), 0.05));
+    ASSERT(CLOSE_TO(chi_square_p_value(6.635, 1), 0.01));
+    ASSERT(chi_square_p_value(0, 5) == 1.0);
+    ASSERT(chi_square_p_value(1, 0) == RNG_STATS_NOT_APPLICABLE);
+    ASSERT(chi_square_p_value(-1, 5) == RNG_STATS_NOT_APPLICABLE);
+    return 1;
+}
+
+static int test_dice_chi_square()
+{
+    dice_roll_res_line_t lines[] = {{1, 10}, {2, 10}, {3, 10}, {4, 10}, {5, 10}, {6, 10}};
+    dice_roll_ret_t ret;
+    ret.dice_rolled = 60;
+    ret.sides = 6;
+    ret.results = lines;
+
+    int dof;
+    ASSERT(dice_chi_square(ret, &dof) == 0);
+    ASSERT(dof == 5);
+
+    lines[0].number_rolled = 60;
+    for (int i = 1; i < 6; i++) {
+        lines[i].number_rolled = 0;
+    }
+    double chi_sq = dice_chi_square(ret, &dof);
+    ASSERT(chi_square_p_value(chi_sq, dof) < 0.0001);
+    return 1;
+}
+
+static int test_dice_roll_stats()
+{
+    dice_roll_res_line_t lines[] = {{1, 10}, {2, 10}, {3, 10}, {4, 10}, {5, 10}, {6, 10}};
+    dice_roll_ret_t ret;
+    ret.dice_rolled = 60;
+    ret.sides = 6;
+    ret.results = lines;
+
+    dice_stats_t s = dice_roll_stats(ret);
+    ASSERT(CLOSE_TO(s.mean, 3.5));
+    ASSERT(CLOSE_TO(s.expected_mean, 3.5));
+    ASSERT(CLOSE_TO(s.variance, 35.0 / 12.0));
+    ASSERT(CLOSE_TO(s.expected_variance, 35.0 / 12.0));
+    ASSERT(s.chi_sq == 0);
+    ASSERT(s.dof == 5);
+    ASSERT(s.p_value == 1.0);
+    ASSERT(s.max_rolled == 10);
+
+    int dof;
+    lines[5].number_rolled = 60;
+    for (int i = 0; i < 5; i++) {
+        lines[i].number_rolled = 0;
+    }
+    s = dice_roll_stats(ret);
+    ASSERT(CLOSE_TO(s.mean, 6));
+    ASSERT(CLOSE_TO(s.variance, 0));
+    ASSERT(CLOSE_TO(s.chi_sq, dice_chi_square(ret, &dof)));
+    ASSERT(s.p_value < 0.0001);
+    ASSERT(s.max_rolled == 60);
+
+    ret.results = NULL;
+    s = dice_roll_stats(ret);
+    ASSERT(s.p_value == RNG_STATS_NOT_APPLICABLE);
+    return 1;
+}
+
+#define RUNS_LEN 1000
+
+static int test_runs_test()
+{
+    bool seq[RUNS_LEN];
+
+    // Alternating has far too many runs
+    for (int i = 0; i < RUNS_LEN; i++) {
+        seq[i] = i % 2;
+    }
+    ASSERT(runs_test_p_value(seq, RUNS_LEN) < 0.0001);
+
+    // Two blocks has far too few runs
+    for (int i = 0; i < RUNS_LEN; i++) {
+        seq[i] = i < RUNS_LEN / 2;
+    }
+    ASSERT(runs_test_p_value(seq, RUNS_LEN) < 0.0001);
+
+    // Too few of one value
+    for (int i = 0; i < RUNS_LEN; i++) {
+        seq[i] = i == 0;
+    }
+    ASSERT(runs_test_p_value(seq, RUNS_LEN) == RNG_STATS_NOT_APPLICABLE);
+    ASSERT(runs_test_p_value(NULL, 0) == RNG_STATS_NOT_APPLICABLE);
+    return 1;
+}
+
+SUB_TEST(rng_stats_cpp_test,
+{&test_chi_square_stat, "chi square stat"},
+{&test_chi_square_p_value, "chi square p value"},
+{&test_dice_chi_square, "dice chi square"},
+{&test_dice_roll_stats, "dice roll stats"},
+{&test_runs_test, "runs test"}
+        )
+
@@ -0,0 +1,5 @@
+#pragma once
+#include "../testing_h/testing.h"
+
+int rng_stats_cpp_test();
+
@@ -0,0 +1,73 @@
+#include "./test_session.h"
+#include "../src/session.h"
+#include "../src/config.h"
+#include <stdio.h>
+
+#define TEST_SESSION_FILE "session_test.json"
+
+static int test_write_read()
+{
+    session_t s;
+    s.tourns.push_back({"a" TOURNAMENT_EXTENTION, 3, "Alice"});
+    s.tourns.push_back({"b" TOURNAMENT_EXTENTION, -1, ""});
+    s.current = 1;
+    ASSERT(save_session(&s, TEST_SESSION_FILE));
+
+    FILE *f = fopen(TEST_SESSION_FILE, "r");
+    ASSERT(f != NULL);
+    session_t r;
+    ASSERT(read_session(f, &r));
+    fclose(f);
+
+    ASSERT(r.tourns.size() == 2);
+    ASSERT(r.tourns[0].file_path == "a" TOURNAMENT_EXTENTION);
+    ASSERT(r.tourns[0].round_number == 3);
+    ASSERT(r.tourns[0].player_name == "Alice");
+    ASSERT(r.tourns[1].round_number == -1);
+    ASSERT(r.tourns[1].player_name == "");
+    ASSERT(r.current == 1);
+    return 1;
+}
+
+static int test_bad_current()
+{
+    FILE *f = fopen(TEST_SESSION_FILE, "w");
+    ASSERT(f != NULL);
+    fprintf(f, "{\"" SESSION_TOURNS "\":[{\"" SESSION_PATH "\":\"a\",\"" SESSION_ROUND "\":1,\"" SESSION_PLAYER "\":\"\"}],"
+            "\"" SESSION_CURRENT "\":5}");
+    fclose(f);
+
+    f = fopen(TEST_SESSION_FILE, "r");
+    ASSERT(f != NULL);
+    session_t r;
+    ASSERT(read_session(f, &r));
+    fclose(f);
+
+    ASSERT(r.tourns.size() == 1);
+    ASSERT(r.current == -1);
+    return 1;
+}
+
+static int test_invalid()
+{
+    FILE *f = fopen(TEST_SESSION_FILE, "w");
+    ASSERT(f != NULL);
+    fprintf(f, "{\"" SESSION_TOURNS "\":[{\"" SESSION_PATH "\":\"a\"}]}");
+    fclose(f);
+
+    f = fopen(TEST_SESSION_FILE, "r");
+    ASSERT(f != NULL);
+    session_t r;
+    ASSERT(!read_session(f, &r));
+    fclose(f);
+
+    ASSERT(r.tourns.size() == 0);
+    ASSERT(r.current == -1);
+    return 1;
+}
+
+SUB_TEST(session_cpp_test,
+{&test_write_read, "Test session write then, read"},
+{&test_bad_current, "Test session with an out of range tab"},
+{&test_invalid, "Test invalid session"}
+        )
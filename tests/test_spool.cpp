@@ -0,0 +1,222 @@
+#include "./test_spool.h"
+#include "../crash_handler/spool.h"
+#include <stdio.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define TEST_SPOOL_DIR "spool_test"
+#define TEST_ENDPOINT "http://localhost:8080/"
+
+// The sender thread calls fake_send too
+static std::mutex sent_lock;
+static std::vector<std::vector<std::string>> sent;
+static int send_ok;
+
+static size_t sent_count()
+{
+    std::lock_guard<std::mutex> l(sent_lock);
+    return sent.size();
+}
+
+static int fake_send(const char *endpoint, spool_report_t *reports, size_t count)
+{
+    std::vector<std::string> batch;
+    for (size_t i = 0; i < count; i++) {
+        batch.push_back(std::string(reports[i].data, reports[i].len));
+    }
+
+    std::lock_guard<std::mutex> l(sent_lock);
+    sent.push_back(batch);
+    return send_ok;
+}
+
+static void clear_spool()
+{
+    spool_trim(TEST_SPOOL_DIR, 0, 0);
+    remove(TEST_SPOOL_DIR "/" SPOOL_STATE_FILE);
+    sent.clear();
+    send_ok = 1;
+}
+
+static int add_reports(int count, time_t now)
+{
+    for (int i = 0; i < count; i++) {
+        std::string report = std::to_string(i);
+        ASSERT(spool_add(TEST_SPOOL_DIR, report.c_str(), report.size(), now + i));
+    }
+    return 1;
+}
+
+static int test_add()
+{
+    clear_spool();
+    ASSERT(spool_count(TEST_SPOOL_DIR) == 0);
+
+    // The same second gets a suffix rather than replacing the report
+    ASSERT(spool_add(TEST_SPOOL_DIR, "a", 1, 100));
+    ASSERT(spool_add(TEST_SPOOL_DIR, "b", 1, 100));
+    ASSERT(spool_add(TEST_SPOOL_DIR, "", 0, 101));
+    ASSERT(spool_count(TEST_SPOOL_DIR) == 3);
+
+    ASSERT(spool_flush(TEST_SPOOL_DIR, TEST_ENDPOINT, &fake_send, 200, 0));
+    ASSERT(sent.size() == 1);
+    ASSERT(sent[0].size() == 3);
+    ASSERT(sent[0][0] == "a");
+    ASSERT(sent[0][1] == "b");
+    ASSERT(sent[0][2] == "");
+    ASSERT(spool_count(TEST_SPOOL_DIR) == 0);
+    return 1;
+}
+
+static int test_trim()
+{
+    clear_spool();
+    ASSERT(add_reports(5, 100));
+
+    // The oldest go first
+    spool_trim(TEST_SPOOL_DIR, 2, SPOOL_MAX_BYTES);
+    ASSERT(spool_count(TEST_SPOOL_DIR) == 2);
+    ASSERT(spool_flush(TEST_SPOOL_DIR, TEST_ENDPOINT, &fake_send, 200, 0));
+    ASSERT(sent.size() == 1);
+    ASSERT(sent[0].size() == 2);
+    ASSERT(sent[0][0] == "3");
+    ASSERT(sent[0][1] == "4");
+
+    // Then by size
+    ASSERT(add_reports(3, 300));
+    spool_trim(TEST_SPOOL_DIR, SPOOL_MAX_REPORTS, 1);
+    ASSERT(spool_count(TEST_SPOOL_DIR) == 0);
+    return 1;
+}
+
+static int test_backoff()
+{
+    ASSERT(spool_backoff(0) == SPOOL_BACKOFF_MIN);
+    ASSERT(spool_backoff(1) == SPOOL_BACKOFF_MIN);
+    ASSERT(spool_backoff(2) == SPOOL_BACKOFF_MIN * 2);
+    ASSERT(spool_backoff(3) == SPOOL_BACKOFF_MIN * 4);
+    ASSERT(spool_backoff(100) == SPOOL_BACKOFF_MAX);
+    for (int i = 1; i < 100; i++) {
+        ASSERT(spool_backoff(i) <= spool_backoff(i + 1));
+    }
+    return 1;
+}
+
+static int test_batches()
+{
+    clear_spool();
+    ASSERT(add_reports(SPOOL_BATCH_SIZE * 2 + 2, 100));
+    ASSERT(spool_flush(TEST_SPOOL_DIR, TEST_ENDPOINT, &fake_send, 200, 0));
+    ASSERT(sent.size() == 3);
+    ASSERT(sent[0].size() == SPOOL_BATCH_SIZE);
+    ASSERT(sent[1].size() == SPOOL_BATCH_SIZE);
+    ASSERT(sent[2].size() == 2);
+    ASSERT(sent[0][0] == "0");
+    ASSERT(sent[2][1] == std::to_string(SPOOL_BATCH_SIZE * 2 + 1));
+    ASSERT(spool_count(TEST_SPOOL_DIR) == 0);
+    return 1;
+}
+
+static int test_flush_failure()
+{
+    clear_spool();
+    ASSERT(add_reports(2, 100));
+
+    send_ok = 0;
+    ASSERT(!spool_flush(TEST_SPOOL_DIR, TEST_ENDPOINT, &fake_send, 200, 0));
+    ASSERT(sent.size() == 1);
+    ASSERT(spool_count(TEST_SPOOL_DIR) == 2);
+
+    spool_state_t state;
+    ASSERT(spool_read_state(TEST_SPOOL_DIR, &state));
+    ASSERT(state.failures == 1);
+    ASSERT(state.next_attempt == 200 + spool_backoff(1));
+
+    // Nothing is sent while backing off
+    ASSERT(!spool_flush(TEST_SPOOL_DIR, TEST_ENDPOINT, &fake_send, 201, 0));
+    ASSERT(sent.size() == 1);
+
+    // Unless a new crash asks for it
+    ASSERT(!spool_flush(TEST_SPOOL_DIR, TEST_ENDPOINT, &fake_send, 201, 1));
+    ASSERT(sent.size() == 2);
+    ASSERT(spool_read_state(TEST_SPOOL_DIR, &state));
+    ASSERT(state.failures == 2);
+    ASSERT(state.next_attempt == 201 + spool_backoff(2));
+
+    // A delivery resets the state
+    send_ok = 1;
+    ASSERT(spool_flush(TEST_SPOOL_DIR, TEST_ENDPOINT, &fake_send, state.next_attempt, 0));
+    ASSERT(sent.size() == 3);
+    ASSERT(spool_count(TEST_SPOOL_DIR) == 0);
+    ASSERT(spool_read_state(TEST_SPOOL_DIR, &state));
+    ASSERT(state.failures == 0);
+    ASSERT(state.next_attempt == 0);
+    return 1;
+}
+
+static int test_state()
+{
+    clear_spool();
+    spool_state_t state;
+    ASSERT(!spool_read_state(TEST_SPOOL_DIR, &state));
+    ASSERT(state.failures == 0);
+    ASSERT(state.next_attempt == 0);
+
+    state.failures = 3;
+    state.next_attempt = 12345;
+    ASSERT(spool_write_state(TEST_SPOOL_DIR, state));
+    state.failures = 0;
+    ASSERT(spool_read_state(TEST_SPOOL_DIR, &state));
+    ASSERT(state.failures == 3);
+    ASSERT(state.next_attempt == 12345);
+    clear_spool();
+    return 1;
+}
+
+static int test_sender()
+{
+    clear_spool();
+    ASSERT(add_reports(2, 100));
+    ASSERT(spool_sender_start(TEST_SPOOL_DIR, TEST_ENDPOINT, &fake_send));
+    for (int i = 0; i < 1000 && spool_count(TEST_SPOOL_DIR) > 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    spool_sender_stop();
+
+    ASSERT(spool_count(TEST_SPOOL_DIR) == 0);
+    ASSERT(sent.size() == 1);
+    return 1;
+}
+
+// A failed send waits for the backoff, stopping must not
+static int test_sender_stop()
+{
+    clear_spool();
+    ASSERT(add_reports(1, 100));
+    send_ok = 0;
+    ASSERT(spool_sender_start(TEST_SPOOL_DIR, TEST_ENDPOINT, &fake_send));
+    for (int i = 0; i < 1000 && sent_count() == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    spool_sender_stop();
+    ASSERT(std::chrono::steady_clock::now() - start < std::chrono::seconds(SPOOL_BACKOFF_MIN / 2));
+    ASSERT(spool_count(TEST_SPOOL_DIR) == 1);
+    clear_spool();
+    return 1;
+}
+
+SUB_TEST(spool_cpp_test,
+{&test_add, "Test spool add"},
+{&test_trim, "Test spool trim"},
+{&test_backoff, "Test spool backoff"},
+{&test_batches, "Test spool flush in batches"},
+{&test_flush_failure, "Test spool flush failure and, backoff"},
+{&test_state, "Test spool state"},
+{&test_sender, "Test spool sender"},
+{&test_sender_stop, "Test spool sender stops while backing off"}
+        )
@@ -0,0 +1,4 @@
+#pragma once
+#include "../testing_h/testing.h"
+
+int spool_cpp_test();
@@ -0,0 +1,191 @@
+#include "./test_stall_watchdog.h"
+#include "../src/stall_watchdog.h"
+#include "../src/trace.h"
+#include <unistd.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define TEST_THRESHOLD_MS STALL_THRESHOLD_MS
+#define TEST_STALL_MS 300
+
+// A minimal event loop on its own thread that runs the watchdog's pings between
+// the tasks it is given
+typedef struct test_loop_t {
+    std::mutex lock;
+    std::condition_variable cond;
+    std::deque<std::function<void()>> queue;
+    bool running;
+    std::thread thread;
+} test_loop_t;
+
+static void test_loop_post(test_loop_t *loop, std::function<void()> fn)
+{
+    {
+        std::lock_guard<std::mutex> l(loop->lock);
+        loop->queue.push_back(fn);
+    }
+    loop->cond.notify_all();
+}
+
+static void test_loop_main(test_loop_t *loop)
+{
+    stall_watchdog_start([loop](uint64_t seq) {
+        test_loop_post(loop, [seq]() {
+            stall_watchdog_pong(seq);
+        });
+    }, TEST_THRESHOLD_MS);
+
+    std::unique_lock<std::mutex> l(loop->lock);
+    while (loop->running || !loop->queue.empty()) {
+        loop->cond.wait(l, [loop]() {
+            return !loop->running || !loop->queue.empty();
+        });
+
+        while (!loop->queue.empty()) {
+            std::function<void()> fn = loop->queue.front();
+            loop->queue.pop_front();
+            l.unlock();
+            fn();
+            l.lock();
+        }
+    }
+    l.unlock();
+
+    stall_watchdog_stop();
+}
+
+static void test_loop_start(test_loop_t *loop)
+{
+    loop->running = true;
+    loop->thread = std::thread(&test_loop_main, loop);
+}
+
+// Lets the watchdog see the loop answer again before it is stopped
+static void test_loop_stop(test_loop_t *loop)
+{
+    usleep(4 * TEST_THRESHOLD_MS * 1000);
+    {
+        std::lock_guard<std::mutex> l(loop->lock);
+        loop->running = false;
+    }
+    loop->cond.notify_all();
+    loop->thread.join();
+}
+
+// Sleeps can be cut short by the backtrace signal so this waits for the deadline
+static void block_for(int ms)
+{
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+    while (std::chrono::steady_clock::now() < end) {
+        usleep(1000);
+    }
+}
+
+static const stall_stats_t *find_stats(const std::vector<stall_stats_t> &stats, const char *cause)
+{
+    for (const stall_stats_t &s : stats) {
+        if (s.cause == cause) {
+            return &s;
+        }
+    }
+    return NULL;
+}
+
+static int test_stall_in_span()
+{
+    stall_watchdog_reset();
+    test_loop_t loop;
+    test_loop_start(&loop);
+    test_loop_post(&loop, []() {
+        TRACE_SPAN("test_outer_span", TRACE_CAT_UI);
+        TRACE_SPAN("test_stall_span", TRACE_CAT_MODEL);
+        block_for(TEST_STALL_MS);
+    });
+    test_loop_stop(&loop);
+
+    // The stall is counted against the innermost span
+    std::vector<stall_stats_t> stats = stall_watchdog_stats();
+    const stall_stats_t *s = find_stats(stats, "test_stall_span");
+    ASSERT(s != NULL);
+    ASSERT(s->count == 1);
+    ASSERT(s->max_ms >= TEST_STALL_MS); // Timed from the span, not the ping
+    ASSERT(s->total_ms == s->max_ms);
+    ASSERT(find_stats(stats, "test_outer_span") == NULL);
+    return 1;
+}
+
+static int test_stall_uninstrumented()
+{
+    stall_watchdog_reset();
+    test_loop_t loop;
+    test_loop_start(&loop);
+    for (int i = 0; i < 2; i++) {
+        test_loop_post(&loop, []() {
+            block_for(TEST_STALL_MS);
+        });
+    }
+    test_loop_stop(&loop);
+
+    std::vector<stall_stats_t> stats = stall_watchdog_stats();
+    const stall_stats_t *s = find_stats(stats, STALL_UNKNOWN_CAUSE);
+    ASSERT(s != NULL);
+    ASSERT(s->count >= 1);
+    ASSERT(s->total_ms >= TEST_STALL_MS);
+
+    stall_watchdog_reset();
+    ASSERT(stall_watchdog_stats().size() == 0);
+    return 1;
+}
+
+static int test_restart()
+{
+    test_loop_t loop;
+    test_loop_start(&loop);
+    test_loop_stop(&loop);
+
+    // Stopping twice is fine
+    stall_watchdog_stop();
+
+    test_loop_start(&loop);
+    test_loop_stop(&loop);
+    return 1;
+}
+
+// An idle loop is pinged less often, activity brings it back
+static int test_idle_backoff()
+{
+    stall_watchdog_reset();
+    test_loop_t loop;
+    test_loop_start(&loop);
+    for (int i = 0; i < 100 && stall_watchdog_ping_interval() < STALL_PING_IDLE_MS; i++) {
+        usleep(50 * 1000);
+    }
+    ASSERT(stall_watchdog_ping_interval() == STALL_PING_IDLE_MS);
+    ASSERT(STALL_PING_IDLE_MS <= TEST_THRESHOLD_MS);
+
+    // A stall with no input (a timer) is still caught and, timed in full
+    test_loop_post(&loop, []() {
+        TRACE_SPAN("test_idle_stall_span", TRACE_CAT_UI);
+        block_for(TEST_STALL_MS);
+    });
+    test_loop_stop(&loop);
+
+    std::vector<stall_stats_t> stats = stall_watchdog_stats();
+    const stall_stats_t *s = find_stats(stats, "test_idle_stall_span");
+    ASSERT(s != NULL);
+    ASSERT(s->count == 1);
+    ASSERT(s->max_ms >= TEST_STALL_MS);
+    return 1;
+}
+
+SUB_TEST(stall_watchdog_cpp_test,
+{&test_stall_in_span, "Test stall watchdog names the span"},
+{&test_stall_uninstrumented, "Test stall watchdog without a span"},
+{&test_restart, "Test stall watchdog restart"},
+{&test_idle_backoff, "Test stall watchdog backs off while idle"}
+        )
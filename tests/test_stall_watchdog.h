@@ -0,0 +1,4 @@
+#pragma once
+#include "../testing_h/testing.h"
+
+int stall_watchdog_cpp_test();
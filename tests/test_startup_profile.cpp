@@ -0,0 +1,49 @@
+#include "./test_startup_profile.h"
+#include "../src/startup_profile.h"
+#include <string.h>
+#include <unistd.h>
+
+static int test_phases()
+{
+    startup_profile_start();
+    usleep(2000);
+    startup_phase("test_a");
+    startup_phase("test_b");
+    usleep(1000);
+    startup_phase("test_c");
+
+    startup_phase_t phases[STARTUP_PROFILE_MAX_PHASES];
+    ASSERT(startup_profile_phases(phases, STARTUP_PROFILE_MAX_PHASES) == 3);
+    ASSERT(strcmp(phases[0].name, "test_a") == 0);
+    ASSERT(strcmp(phases[1].name, "test_b") == 0);
+    ASSERT(strcmp(phases[2].name, "test_c") == 0);
+    ASSERT(phases[0].ns >= 2000000);
+    ASSERT(phases[2].ns >= 1000000);
+
+    // The phases cover the whole start up
+    ASSERT(startup_profile_total_ns() == phases[0].ns + phases[1].ns + phases[2].ns);
+    ASSERT(startup_profile_phases(phases, 1) == 1);
+    startup_profile_log();
+    return 1;
+}
+
+static int test_too_many_phases()
+{
+    startup_profile_start();
+    for (int i = 0; i < STARTUP_PROFILE_MAX_PHASES + 5; i++) {
+        startup_phase("test_phase");
+    }
+
+    startup_phase_t phases[STARTUP_PROFILE_MAX_PHASES + 5];
+    ASSERT(startup_profile_phases(phases, STARTUP_PROFILE_MAX_PHASES + 5) == STARTUP_PROFILE_MAX_PHASES);
+
+    startup_profile_start();
+    ASSERT(startup_profile_phases(phases, STARTUP_PROFILE_MAX_PHASES) == 0);
+    ASSERT(startup_profile_total_ns() == 0);
+    return 1;
+}
+
+SUB_TEST(startup_profile_cpp_test,
+{&test_phases, "Test startup profile phases"},
+{&test_too_many_phases, "Test startup profile phase limit"}
+        )
@@ -0,0 +1,4 @@
+#pragma once
+#include "../testing_h/testing.h"
+
+int startup_profile_cpp_test();
@@ -0,0 +1,145 @@
+#include "./test_trace.h"
+#include "../src/trace.h"
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+
+#define TEST_TRACE_FILE "test_trace.json"
+
+static bool read_trace(nlohmann::json &ret)
+{
+    FILE *f = fopen(TEST_TRACE_FILE, "r");
+    if (f == NULL) {
+        return false;
+    }
+
+    ret = nlohmann::json::parse(f);
+    fclose(f);
+    remove(TEST_TRACE_FILE);
+    return true;
+}
+
+static std::vector<nlohmann::json> find_events(nlohmann::json &trace, std::string name)
+{
+    std::vector<nlohmann::json> ret;
+    for (nlohmann::json &e : trace.at("traceEvents")) {
+        if (e.at("name") == name) {
+            ret.push_back(e);
+        }
+    }
+    return ret;
+}
+
+static int test_disabled()
+{
+    ASSERT(!trace_enabled);
+    {
+        TRACE_SPAN("test_disabled", TRACE_CAT_MODEL);
+    }
+
+    // Nothing to write when tracing was never started
+    ASSERT(!trace_write());
+    ASSERT(access(TEST_TRACE_FILE, F_OK) != 0);
+    return 1;
+}
+
+static int test_nested()
+{
+    ASSERT(trace_init(TEST_TRACE_FILE));
+    trace_set_thread_name("test main");
+    {
+        TRACE_SPAN("test_outer", TRACE_CAT_UI);
+        usleep(2000);
+        {
+            TRACE_SPAN("test_inner", TRACE_CAT_IO);
+            usleep(1000);
+        }
+    }
+    ASSERT(trace_write());
+    ASSERT(!trace_enabled);
+    ASSERT(!trace_write());
+
+    nlohmann::json trace;
+    ASSERT(read_trace(trace));
+
+    std::vector<nlohmann::json> outer = find_events(trace, "test_outer");
+    std::vector<nlohmann::json> inner = find_events(trace, "test_inner");
+    ASSERT(outer.size() == 1);
+    ASSERT(inner.size() == 1);
+    ASSERT(outer[0].at("ph") == "X");
+    ASSERT(outer[0].at("cat") == TRACE_CAT_UI);
+    ASSERT(inner[0].at("cat") == TRACE_CAT_IO);
+    ASSERT(outer[0].at("tid") == inner[0].at("tid"));
+
+    // The inner span is within the outer one
+    double outer_ts = outer[0].at("ts"), outer_dur = outer[0].at("dur");
+    double inner_ts = inner[0].at("ts"), inner_dur = inner[0].at("dur");
+    ASSERT(inner_dur >= 1000);
+    ASSERT(outer_dur >= 3000);
+    ASSERT(inner_ts >= outer_ts);
+    ASSERT(inner_ts + inner_dur <= outer_ts + outer_dur);
+
+    std::vector<nlohmann::json> names = find_events(trace, "thread_name");
+    bool found = false;
+    for (nlohmann::json &n : names) {
+        if (n.at("tid") == outer[0].at("tid")) {
+            ASSERT(n.at("ph") == "M");
+            ASSERT(n.at("args").at("name") == "test main");
+            found = true;
+        }
+    }
+    ASSERT(found);
+    return 1;
+}
+
+#define THREADS 4
+#define SPANS 1000
+
+static int test_threads()
+{
+    ASSERT(trace_init(TEST_TRACE_FILE));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREADS; i++) {
+        threads.push_back(std::thread([]() {
+            trace_set_thread_name("test worker");
+            for (int j = 0; j < SPANS; j++) {
+                TRACE_SPAN("test_worker_span", TRACE_CAT_MODEL);
+            }
+        }));
+    }
+
+    for (std::thread &t : threads) {
+        t.join();
+    }
+    ASSERT(trace_write());
+
+    nlohmann::json trace;
+    ASSERT(read_trace(trace));
+
+    // Spans from threads that have exited are kept, with one tid per thread
+    std::vector<nlohmann::json> spans = find_events(trace, "test_worker_span");
+    ASSERT(spans.size() == THREADS * SPANS);
+
+    std::vector<int> tids;
+    for (nlohmann::json &e : spans) {
+        int tid = e.at("tid");
+        if (std::find(tids.begin(), tids.end(), tid) == tids.end()) {
+            tids.push_back(tid);
+        }
+    }
+    ASSERT(tids.size() == THREADS);
+
+    // Spans from the last trace are cleared
+    ASSERT(find_events(trace, "test_outer").size() == 0);
+    return 1;
+}
+
+SUB_TEST(trace_cpp_test,
+{&test_disabled, "Test trace disabled"},
+{&test_nested, "Test trace nested spans"},
+{&test_threads, "Test trace across threads"}
+        )
@@ -0,0 +1,137 @@
+#include "./test_update_scheduler.h"
+#include "../src/update_scheduler.h"
+#include <chrono>
+#include <thread>
+
+static int test_burst()
+{
+    update_scheduler_t s;
+    int arms = 0, a = 0, b = 0;
+    update_scheduler_init(&s, [&arms](int ms) {
+        arms++;
+    });
+    size_t va = update_scheduler_add(&s, [&a]() {
+        a++;
+    });
+    size_t vb = update_scheduler_add(&s, [&b]() {
+        b++;
+    });
+
+    for (int i = 0; i < 1000; i++) {
+        update_scheduler_mark(&s, va);
+        update_scheduler_mark(&s, vb);
+    }
+    ASSERT(arms == 1);
+    ASSERT(a == 0);
+    ASSERT(update_scheduler_pending(&s));
+
+    update_scheduler_flush(&s);
+    ASSERT(a == 1);
+    ASSERT(b == 1);
+    ASSERT(s.marks == 2000);
+    ASSERT(s.flushes == 1);
+    ASSERT(s.view_flushes == 2);
+    ASSERT(!update_scheduler_pending(&s));
+
+    // Nothing to do
+    update_scheduler_flush(&s);
+    ASSERT(a == 1);
+    ASSERT(s.flushes == 1);
+    return 1;
+}
+
+static int test_mark_order()
+{
+    update_scheduler_t s;
+    std::vector<int> order;
+    update_scheduler_init(&s, [](int ms) {});
+    size_t v0 = update_scheduler_add(&s, [&order]() {
+        order.push_back(0);
+    });
+    size_t v1 = update_scheduler_add(&s, [&order]() {
+        order.push_back(1);
+    });
+
+    update_scheduler_mark(&s, v1);
+    update_scheduler_mark(&s, v0);
+    update_scheduler_mark(&s, v1);
+    update_scheduler_flush(&s);
+    ASSERT(order.size() == 2);
+    ASSERT(order[0] == 1);
+    ASSERT(order[1] == 0);
+    return 1;
+}
+
+static int test_mark_during_flush()
+{
+    update_scheduler_t s;
+    int arms = 0, a = 0;
+    size_t va;
+    update_scheduler_init(&s, [&arms](int ms) {
+        arms++;
+    });
+    va = update_scheduler_add(&s, [&s, &a, &va]() {
+        a++;
+        if (a == 1) {
+            update_scheduler_mark(&s, va);
+        }
+    });
+
+    update_scheduler_mark(&s, va);
+    update_scheduler_flush(&s);
+    ASSERT(a == 1);
+    ASSERT(arms == 2);
+    ASSERT(update_scheduler_pending(&s));
+
+    update_scheduler_flush(&s);
+    ASSERT(a == 2);
+    ASSERT(!update_scheduler_pending(&s));
+    return 1;
+}
+
+static int test_frame_wait()
+{
+    update_scheduler_t s;
+    int wait = -1;
+    update_scheduler_init(&s, [&wait](int ms) {
+        wait = ms;
+    });
+    size_t v = update_scheduler_add(&s, []() {});
+
+    // The first mark is flushed straight away
+    update_scheduler_mark(&s, v);
+    ASSERT(wait == 0);
+    update_scheduler_flush(&s);
+
+    // Then not until the frame is over
+    update_scheduler_mark(&s, v);
+    ASSERT(wait > 0);
+    ASSERT(wait <= UPDATE_FRAME_MS);
+    update_scheduler_flush(&s);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(UPDATE_FRAME_MS + 5));
+    update_scheduler_mark(&s, v);
+    ASSERT(wait == 0);
+    return 1;
+}
+
+static int test_bad_view()
+{
+    update_scheduler_t s;
+    int arms = 0;
+    update_scheduler_init(&s, [&arms](int ms) {
+        arms++;
+    });
+    update_scheduler_mark(&s, 3);
+    ASSERT(arms == 0);
+    ASSERT(!update_scheduler_pending(&s));
+    return 1;
+}
+
+SUB_TEST(update_scheduler_cpp_test,
+{&test_burst, "Test update scheduler flushes a burst once"},
+{&test_mark_order, "Test update scheduler flushes in mark order"},
+{&test_mark_during_flush, "Test update scheduler marks during a flush"},
+{&test_frame_wait, "Test update scheduler waits for the frame"},
+{&test_bad_view, "Test update scheduler with a bad view"}
+        )
@@ -0,0 +1,4 @@
+#pragma once
+#include "../testing_h/testing.h"
+
+int update_scheduler_cpp_test();
@@ -75,6 +75,176 @@ static int test_matching_long()
     return 1;
 }
 
+static int test_map_file_null()
+{
+    file_view_t view;
+    ASSERT(!map_file(NULL, &view));
+    ASSERT(view.data == NULL);
+    ASSERT(!map_file_path("utils_test_does_not_exist", &view));
+    ASSERT(view.data == NULL);
+
+    // Unmapping an empty view is a no-op
+    unmap_file(&view);
+    return 1;
+}
+
+#define MAP_FILE_TEST_SIZE (DEFAULT_BLOCK_SIZE * 10)
+
+static int test_map_file_regular()
+{
+    FILE *f = tmpfile();
+    ASSERT(f != NULL);
+
+    char m[MAP_FILE_TEST_SIZE];
+    for (size_t i = 0; i < sizeof(m); i++) {
+        m[i] = i & 0xFF;
+    }
+    ASSERT(fwrite(m, 1, sizeof(m), f) == sizeof(m));
+    rewind(f);
+
+    // Consume part of the stream first, the view starts where the stream is
+    ASSERT(fgetc(f) == m[0]);
+    ASSERT(fgetc(f) == m[1]);
+
+    file_view_t view;
+    ASSERT(map_file(f, &view));
+#ifdef UNIX
+    ASSERT(view.mapped);
+#endif
+    ASSERT(view.size == sizeof(m) - 2);
+    ASSERT(memcmp(view.data, m + 2, view.size) == 0);
+    ASSERT(fgetc(f) == EOF);
+
+    unmap_file(&view);
+    ASSERT(view.data == NULL);
+    fclose(f);
+    return 1;
+}
+
+static int test_map_file_empty()
+{
+    FILE *f = tmpfile();
+    ASSERT(f != NULL);
+
+    file_view_t view;
+    ASSERT(map_file(f, &view));
+    ASSERT(!view.mapped);
+    ASSERT(view.size == 0);
+    ASSERT(view.data != NULL);
+
+    unmap_file(&view);
+    fclose(f);
+    return 1;
+}
+
+// Pipes cannot be mapped so they are read instead
+static int test_map_file_pipe()
+{
+    int fid[2];
+    ASSERT(pipe(fid) == 0);
+
+    FILE *r = fdopen(fid[0], "rb"), *w = fdopen(fid[1], "wb");
+    char m[DEFAULT_BLOCK_SIZE * 10];
+    for (size_t i = 0; i < sizeof(m); i++) {
+        m[i] = i & 0xFF;
+        fputc(m[i], w);
+    }
+    ASSERT(fclose(w) == 0);
+
+    file_view_t view;
+    ASSERT(map_file(r, &view));
+    ASSERT(!view.mapped);
+    ASSERT(view.size == sizeof(m));
+    ASSERT(memcmp(view.data, m, sizeof(m)) == 0);
+
+    unmap_file(&view);
+    ASSERT(fclose(r) == 0);
+    return 1;
+}
+
+// Files that may be truncated meanwhile are read, never mapped
+static int test_read_file_regular()
+{
+    FILE *f = tmpfile();
+    ASSERT(f != NULL);
+
+    char m[MAP_FILE_TEST_SIZE];
+    for (size_t i = 0; i < sizeof(m); i++) {
+        m[i] = i & 0xFF;
+    }
+    ASSERT(fwrite(m, 1, sizeof(m), f) == sizeof(m));
+    rewind(f);
+
+    file_view_t view;
+    ASSERT(read_file(f, &view));
+    ASSERT(!view.mapped);
+    ASSERT(view.size == sizeof(m));
+    ASSERT(memcmp(view.data, m, view.size) == 0);
+    unmap_file(&view);
+    fclose(f);
+
+    ASSERT(!read_file_path("utils_test_does_not_exist", &view));
+    ASSERT(view.data == NULL);
+    return 1;
+}
+
+// Streams with no file descriptor are read in blocks
+static int test_read_all_memstream()
+{
+    char m[DEFAULT_BLOCK_SIZE * 3];
+    for (size_t i = 0; i < sizeof(m); i++) {
+        m[i] = 'a' + i % 26;
+    }
+
+    FILE *f = fmemopen(m, sizeof(m), "r");
+    ASSERT(f != NULL);
+    char *ret = read_all_f(f);
+    fclose(f);
+    ASSERT(ret != NULL);
+    ASSERT(strlen(ret) == sizeof(m));
+    ASSERT(memcmp(ret, m, sizeof(m)) == 0);
+    free(ret);
+    return 1;
+}
+
+#define ATOMIC_TEST_FILE "utils_test_atomic.txt"
+
+static int test_atomic_file()
+{
+    FILE *f = fopen(ATOMIC_TEST_FILE, "w");
+    ASSERT(f != NULL);
+    fprintf(f, "old");
+    fclose(f);
+
+    // Aborting leaves the old file
+    atomic_file_t af;
+    ASSERT(atomic_file_open(&af, ATOMIC_TEST_FILE));
+    fprintf(af.f, "new");
+    atomic_file_abort(&af);
+
+    f = fopen(ATOMIC_TEST_FILE, "r");
+    ASSERT(f != NULL);
+    char *data = read_all_f(f);
+    fclose(f);
+    ASSERT(strcmp(data, "old") == 0);
+    free(data);
+
+    ASSERT(atomic_file_open(&af, ATOMIC_TEST_FILE));
+    fprintf(af.f, "new");
+    ASSERT(atomic_file_commit(&af));
+
+    f = fopen(ATOMIC_TEST_FILE, "r");
+    ASSERT(f != NULL);
+    data = read_all_f(f);
+    fclose(f);
+    ASSERT(strcmp(data, "new") == 0);
+    free(data);
+
+    ASSERT(fopen(ATOMIC_TEST_FILE ATOMIC_FILE_SUFFIX, "r") == NULL);
+    remove(ATOMIC_TEST_FILE);
+    return 1;
+}
+
 #define LOWER_STRING "asdf"
 #define UPPER_STRING "ASDF"
 static int test_to_lower_case()
@@ -98,6 +268,13 @@ SUB_TEST(utils_cpp_test,
 {&test_eof_1, "Test EOF 1"},
 {&test_matching, "Test matching"},
 {&test_matching_long, "Test matching long"},
+{&test_map_file_null, "Test map file fail"},
+{&test_map_file_regular, "Test map regular file"},
+{&test_map_file_empty, "Test map empty file"},
+{&test_map_file_pipe, "Test map pipe"},
+{&test_read_file_regular, "Test read regular file"},
+{&test_read_all_memstream, "Test read all memory stream"},
+{&test_atomic_file, "Test atomic file"},
 {&test_to_lower_case, "Test to lower case"},
 {&test_to_upper_case, "Test to upper case"}
         )
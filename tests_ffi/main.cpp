@@ -8,6 +8,7 @@
 #include "./sq_link_test.h"
 #include "./test_tournament_ffi.h"
 #include "./test_round_ffi.h"
+#include "../src/ffi_ledger.h"
 #include <squire_core/squire_core.h>
 
 int test_func()
@@ -16,6 +17,18 @@ int test_func()
     return 1;
 }
 
+// Runs last so that every squire_core allocation in the tests above is checked
+int test_ffi_ledger()
+{
+#ifdef FFI_LEDGER
+    ffi_ledger_log();
+    ASSERT(ffi_ledger_stats().allocs > 0);
+    ASSERT(ffi_ledger_stats().bad_frees == 0);
+    ASSERT(ffi_ledger_report_leaks() == 0);
+#endif
+    return 1;
+}
+
 void handler(int sig)
 {
     void *array[10];
@@ -39,7 +52,8 @@ int main(int argc, char *argv[])
         {&test_func, "Testing_h self test"},
         {&sq_link_test, "SQ Link Test (debug test)"},
         {&test_tournament_ffi, "Tournament FFI Tests"},
-        {&test_round_ffi, "Round FFI Tests"}
+        {&test_round_ffi, "Round FFI Tests"},
+        {&test_ffi_ledger, "FFI Ledger Test"}
     };
 
     squire_core::init_squire_ffi(); // This is important!
@@ -117,6 +117,22 @@ static int test_round_getters()
     }
     ASSERT(rounds[0].confirmed_players().size() == rounds[0].players().size());
 
+    // Refreshing in place sees the confirmations
+    ASSERT(res.players().size() == rounds[0].players().size());
+    for (Player p : res.players()) {
+        ASSERT(!res.isConfirmed(p));
+    }
+
+    res.refresh(rounds[0]);
+    ASSERT(res.players().size() == rounds[0].players().size());
+    ASSERT(res.draws() == DRAWS);
+    i = 0;
+    for (Player p : res.players()) {
+        ASSERT(res.isConfirmed(p));
+        ASSERT(res.resultFor(p) == WINS(i));
+        i++;
+    }
+
     // Close the tournament
     ASSERT(t->close());
     delete t;